@@ -87,6 +87,19 @@ class GameObj : public NXGameObj
 		void UpdateTileCollision( void );
 		
 		size_t GetObjectIndex( void ) const { return mObjectIndex; }
+		int GetTelemetryType( void ) const { return int(mType); }
+
+		//Snapshot records keep the type as well
+		void SaveRecord(NXGameObjRecord& record, NXObjSnapshot& snapshot) const
+		{
+			NXGameObj::SaveRecord(record, snapshot);
+			record.type = int(mType);
+		}
+		void LoadRecord(const NXGameObjRecord& record, const NXObjSnapshot& snapshot)
+		{
+			NXGameObj::LoadRecord(record, snapshot);
+			mType = ObjType(record.type);
+		}
 
 		ObjType mType;
 	private:
@@ -20,12 +20,21 @@
 #define OBJMANAGER_H_
 
 #include <list>
-
+#include <vector>
+#include "NXTileMap.h"
+#include "NXRenderSnapshot.h"
+#include "NXProfiler.h"
+#include "NXPoolTelemetry.h"
+#include "NXObjSnapshot.h"
+#include <cstdio>
+#include <typeinfo>
+
+//Registers itself for telemetry, under the name given or the name of T
 template <class T>
-class ObjManager
+class ObjManager : public NXPoolTelemetry
 {
 	public:
-		ObjManager(size_t listSize = 512);
+		ObjManager(size_t listSize = 512, const char *name = 0);
 		~ObjManager( void );
 
 		
@@ -35,24 +44,59 @@ class ObjManager
 		void Update( void );
 
 		void RenderSameObjects( void ); 
+		void RenderSameObjects(NXRenderDevice& device);
 		//If all objects in this manager has the same sprite, use this one as it's faster
 		void Render( void ); 
+		void Render(NXRenderDevice& device);
 		//If all objects in this manager can have different sprites, use this one
+		//The device versions can record into an NXRenderCommandList instead of drawing
 
 		void RenderDebugInfo( void );
+
+		//Copies every visible object into the frame's snapshot instead of drawing it
+		void Snapshot(NXRenderSnapshot& snapshot);
+
 		void Free(void);
 
+		//Tile collision flags of every alive object in one batch, indexed like
+		//GetManagerList, dead objects get 0
+		void CheckTileCollision(const NXTileMap& map, std::vector<int>& flags);
+
 		std::vector<T>& GetManagerList(void) {return mObjList; }
 		size_t GetObjManagerSize(void) const {return mObjList.size(); }
+
+		size_t GetCapacity( void ) const { return mObjList.size(); }
+		size_t GetObjectSize( void ) const { return sizeof(T); }
+		size_t GetFootprint( void ) const;
+		size_t CountAlive(unsigned *typeCounts) const;
+
+		//Constructs exactly listSize objects, replacing the current ones. Does nothing if any
+		//object is still alive, pointers into the pool would dangle.
+		void Resize(size_t listSize);
+
+		//See NXObjSnapshot, objects are copied through T::SaveRecord and T::LoadRecord
+		void CaptureObjects(NXObjSnapshot& snapshot) const;
+		void RestoreObjects(const NXObjSnapshot& snapshot, const NXGameObjRecord *records, size_t count);
+		NXGameObj* GetPoolObject(size_t slot) { return slot < mObjList.size() ? &mObjList[slot] : 0; }
+		bool FindPoolObject(const NXGameObj *obj, size_t *slot) const;
 	private:
 		std::vector<T> mObjList;
 		size_t mListSize;
 		size_t mCurrentIndex;
 		size_t mObjectsInUse;
+
+		//Scratch arrays for CheckTileCollision, kept to avoid allocating every frame
+		std::vector<float> mTilePosX;
+		std::vector<float> mTilePosY;
+		std::vector<float> mTileScaleX;
+		std::vector<float> mTileScaleY;
+		std::vector<int> mTileFlags;
+		std::vector<size_t> mTileIndex;
 };
 
 template <class T>
-ObjManager<T>::ObjManager(size_t listSize) : 
+ObjManager<T>::ObjManager(size_t listSize, const char *name) : 
+	NXPoolTelemetry(name ? name : typeid(T).name()),
 	mListSize(listSize), mCurrentIndex(0), mObjectsInUse(0)
 {
 	for (size_t i = 0; i < listSize; ++i)
@@ -72,6 +116,13 @@ template <class T>
 T*  ObjManager<T>::CreateGameObj(	const std::wstring& meshID,
 									const std::wstring& spriteID)
 {
+	//An empty pool has no slot to look at
+	if (mObjList.empty())
+	{
+		OnFailedSpawn();
+		return 0;
+	}
+
 	size_t prevIndex = mCurrentIndex;
 	while (mObjList[mCurrentIndex].IsAlive())
 	{
@@ -83,7 +134,9 @@ T*  ObjManager<T>::CreateGameObj(	const std::wstring& meshID,
 		}
 		if (prevIndex == mCurrentIndex)
 		{
-			NX_MESG(L"ObjManager: Out of memory\n");
+			OnFailedSpawn();
+			Message("ObjManager %s: Out of memory, all %u objects alive, %u spawns failed so far\n",
+					GetName(), unsigned(mObjList.size()), GetTotalFailed());
 			return 0;
 		}
 		//Out of memory if loop went through twice
@@ -100,12 +153,132 @@ T*  ObjManager<T>::CreateGameObj(	const std::wstring& meshID,
 	obj->SetCurrentAnimation(L"", 0);
 	obj->SetAlive();
 	++mObjectsInUse;
+	OnSpawn();
 	return obj;
 }
 
+template <class T>
+size_t ObjManager<T>::GetFootprint( void ) const
+{
+	return mObjList.capacity() * sizeof(T) +
+		   (mTilePosX.capacity() + mTilePosY.capacity() + mTileScaleX.capacity() + mTileScaleY.capacity()) * sizeof(float) +
+		   mTileFlags.capacity() * sizeof(int) + mTileIndex.capacity() * sizeof(size_t);
+}
+
+template <class T>
+size_t ObjManager<T>::CountAlive(unsigned *typeCounts) const
+{
+	size_t alive = 0;
+	for (size_t i = 0; i < mObjList.size(); ++i)
+	{
+		if (mObjList[i].IsAlive())
+		{
+			const int type = mObjList[i].GetTelemetryType();
+			++typeCounts[type < 0 ? 0 : type < NXTELEMETRY_TYPES ? type : NXTELEMETRY_TYPES - 1];
+			++alive;
+		}
+	}
+	return alive;
+}
+
+template <class T>
+void ObjManager<T>::Resize(size_t listSize)
+{
+	for (size_t i = 0; i < mObjList.size(); ++i)
+	{
+		if (mObjList[i].IsAlive())
+		{
+			Message("ObjManager %s: Unable to resize while objects are alive\n", GetName());
+			return;
+		}
+	}
+
+	// Built separately so the capacity is exactly listSize
+	std::vector<T> objects;
+	objects.reserve(listSize);
+	for (size_t i = 0; i < listSize; ++i)
+	{
+		objects.push_back(T(i));
+	}
+	mObjList.swap(objects);
+
+	mListSize = listSize;
+	mCurrentIndex = 0;
+	mObjectsInUse = 0;
+}
+
+template <class T>
+void ObjManager<T>::CaptureObjects(NXObjSnapshot& snapshot) const
+{
+	NX_PROFILE_ZONE_DETAIL("ObjManager::CaptureObjects", typeid(T).name());
+	snapshot.BeginPool(GetName(), mObjList.size());
+	for (size_t i = 0; i < mObjList.size(); ++i)
+	{
+		if (mObjList[i].IsAlive())
+		{
+			NXGameObjRecord& record = snapshot.AddRecord();
+			mObjList[i].SaveRecord(record, snapshot);
+			record.slot = unsigned(i);
+		}
+	}
+}
+
+//Expects Free to have been called, and the size of the captured pool
+template <class T>
+void ObjManager<T>::RestoreObjects(const NXObjSnapshot& snapshot, const NXGameObjRecord *records, size_t count)
+{
+	NX_PROFILE_ZONE_DETAIL("ObjManager::RestoreObjects", typeid(T).name());
+	mCurrentIndex = 0;
+	mObjectsInUse = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		//A snapshot loaded from file can hold anything
+		if (records[i].slot >= mObjList.size())
+		{
+			Message("ObjManager %s: Skipped a record for slot %u, the pool holds %u objects\n",
+					GetName(), unsigned(records[i].slot), unsigned(mObjList.size()));
+			continue;
+		}
+
+		T& obj = mObjList[records[i].slot];
+		obj.Init();
+		obj.LoadRecord(records[i], snapshot);
+		obj.SetAlive();
+
+		// Same bookkeeping as CreateGameObj
+		mCurrentIndex = records[i].slot;
+		if (mObjectsInUse < mCurrentIndex + 1)
+			mObjectsInUse = mCurrentIndex + 1;
+	}
+}
+
+template <class T>
+bool ObjManager<T>::FindPoolObject(const NXGameObj *obj, size_t *slot) const
+{
+	if (mObjList.empty())
+	{
+		return false;
+	}
+	const char *first = reinterpret_cast<const char*>(static_cast<const NXGameObj*>(&mObjList[0]));
+	const char *address = reinterpret_cast<const char*>(obj);
+	if (address < first || address >= first + mObjList.size() * sizeof(T) || (address - first) % sizeof(T))
+	{
+		return false;
+	}
+	*slot = size_t(address - first) / sizeof(T);
+	return true;
+}
+
 template <class T>
 void ObjManager<T>::Render( void )
 {
+	Render(NXBeginGraphicBatch());
+}
+
+template <class T>
+void ObjManager<T>::Render(NXRenderDevice& device)
+{
+	NX_PROFILE_ZONE_DETAIL("ObjManager::Render", typeid(T).name());
 	size_t index = 0;
 	std::wstring previousSprite = L"";
 	std::wstring currentSprite = L"";
@@ -132,24 +305,77 @@ void ObjManager<T>::Render( void )
 
 			if (currentSprite != previousSprite)
 			{
-				gEngine.GetGraphicEngine()->SetTexture(gEngine.GetMeshManager()->GetTexture( currentSprite ) );
+				device.SetTexture(gEngine.GetMeshManager()->GetTexture( currentSprite ) );
 				previousSprite = currentSprite;
 			}
 			if (currentMesh != previousMesh)
 			{
-				gEngine.GetGraphicEngine()->SetVertices(gEngine.GetMeshManager()->GetMesh ( currentMesh )->GetBuffer() );
+				device.SetVertices(gEngine.GetMeshManager()->GetMesh ( currentMesh )->GetBuffer() );
 				previousMesh = currentMesh;
-				mObjList[i].SetRenderMode();
+				mObjList[i].SetRenderMode(device);
 			}
-			mObjList[i].Render();
+			mObjList[i].Render(device);
 			++DrawCall;
 		}
 	}
 }
 
+template <class T>
+void ObjManager<T>::Snapshot(NXRenderSnapshot& snapshot)
+{
+	NX_PROFILE_ZONE_DETAIL("ObjManager::Snapshot", typeid(T).name());
+	size_t index = 0;
+	std::wstring previousSprite = L"";
+	std::wstring previousMesh = L"";
+	NXTexture *texture = 0;
+	LPDIRECT3DVERTEXBUFFER9 vertices = 0;
+
+	for (size_t i = 0; i < mObjList.size(); ++i)
+	{
+		++index;
+		if (index > mObjectsInUse)
+		{
+			break;
+		}
+
+		if (!mObjList[i].IsAlive() || !mObjList[i].IsVisible())
+		{
+			continue;
+		}
+
+		// Lookups by name only when they change, as in Render
+		const std::wstring& currentSprite = mObjList[i].GetSpriteID();
+		const std::wstring& currentMesh = mObjList[i].GetMeshID();
+		if (texture == 0 || currentSprite != previousSprite)
+		{
+			texture = gEngine.GetMeshManager()->GetTexture( currentSprite );
+			previousSprite = currentSprite;
+		}
+		if (vertices == 0 || currentMesh != previousMesh)
+		{
+			vertices = gEngine.GetMeshManager()->GetMesh( currentMesh )->GetBuffer();
+			previousMesh = currentMesh;
+		}
+
+		NXRenderInstance& instance = snapshot.AddInstance();
+		mObjList[i].FillRenderInstance(instance);
+		instance.texture = texture;
+		instance.vertices = vertices;
+		// Counted here, the render thread must not touch the frame counters
+		++DrawCall;
+	}
+}
+
 template <class T>
 void ObjManager<T>::RenderSameObjects( void )
 {
+	RenderSameObjects(NXBeginGraphicBatch());
+}
+
+template <class T>
+void ObjManager<T>::RenderSameObjects(NXRenderDevice& device)
+{
+	NX_PROFILE_ZONE_DETAIL("ObjManager::RenderSameObjects", typeid(T).name());
 	bool firstObj = true;
 	size_t index = 0;
 
@@ -170,12 +396,12 @@ void ObjManager<T>::RenderSameObjects( void )
 		{
 			if (firstObj)
 			{
-				gEngine.GetGraphicEngine()->SetTexture(gEngine.GetMeshManager()->GetTexture( mObjList[i].GetSpriteID() ) );
-				gEngine.GetGraphicEngine()->SetVertices(gEngine.GetMeshManager()->GetMesh ( mObjList[i].GetMeshID() )->GetBuffer() );
-				mObjList[i].SetRenderMode();
+				device.SetTexture(gEngine.GetMeshManager()->GetTexture( mObjList[i].GetSpriteID() ) );
+				device.SetVertices(gEngine.GetMeshManager()->GetMesh ( mObjList[i].GetMeshID() )->GetBuffer() );
+				mObjList[i].SetRenderMode(device);
 				firstObj = false;
 			}
-			mObjList[i].Render();
+			mObjList[i].Render(device);
 			++DrawCall;
 		}		
 	}
@@ -184,6 +410,7 @@ void ObjManager<T>::RenderSameObjects( void )
 template <class T>
 void ObjManager<T>::RenderDebugInfo( void )
 {
+	NXRenderDevice& device = NXBeginGraphicBatch();
 	bool firstObj = true;
 	size_t index = 0;
 
@@ -202,8 +429,8 @@ void ObjManager<T>::RenderDebugInfo( void )
 
 		if (firstObj)
 		{
-			gEngine.GetGraphicEngine()->DisableTexture();
-			gEngine.GetGraphicEngine()->SetBox();
+			device.DisableTexture();
+			device.SetBox();
 			firstObj = false;
 		}
 
@@ -215,6 +442,11 @@ void ObjManager<T>::RenderDebugInfo( void )
 template <class T>
 void ObjManager<T>::Update( void )
 {
+	NX_PROFILE_ZONE_DETAIL("ObjManager::Update", typeid(T).name());
+	// Animation advances inside each object's Update, so it is timed as part of its type
+	NX_PROFILE_RUN(typeRun, "Objects of");
+	const unsigned countMark = BeginCount();
+	unsigned live = 0;
 	size_t index = 0;
 
 	for (size_t i = 0; i < mObjList.size(); ++i)
@@ -230,8 +462,64 @@ void ObjManager<T>::Update( void )
 			continue;
 		}
 				
+		NX_PROFILE_RUN_NEXT(typeRun, NXProfileTypeName(mObjList[i].GetTelemetryType()));
 		mObjList[i].Update();
-		++UpdateCall;		
+		++UpdateCall;
+		if (mObjList[i].IsAlive())
+		{
+			++live;
+		}
+	}
+	EndCount(live, countMark);
+}
+
+template <class T>
+void ObjManager<T>::CheckTileCollision(const NXTileMap& map, std::vector<int>& flags)
+{
+	NX_PROFILE_ZONE_DETAIL("ObjManager::CheckTileCollision", typeid(T).name());
+	flags.assign(mObjList.size(), 0);
+	mTilePosX.clear();
+	mTilePosY.clear();
+	mTileScaleX.clear();
+	mTileScaleY.clear();
+	mTileIndex.clear();
+
+	size_t index = 0;
+
+	for (size_t i = 0; i < mObjList.size(); ++i)
+	{
+		++index;
+		if (index > mObjectsInUse)
+		{
+			break;
+		}
+
+		if (!mObjList[i].IsAlive())
+		{
+			continue;
+		}
+
+		const Vec3 pos = mObjList[i].GetPosition();
+		const Vec3 scale = mObjList[i].GetScale();
+		mTilePosX.push_back(pos.x);
+		mTilePosY.push_back(pos.y);
+		mTileScaleX.push_back(scale.x);
+		mTileScaleY.push_back(scale.y);
+		mTileIndex.push_back(i);
+	}
+
+	if (mTileIndex.empty())
+	{
+		return;
+	}
+
+	mTileFlags.resize(mTileIndex.size());
+	map.CheckInstanceBinaryMapCollision(&mTilePosX[0], &mTilePosY[0], &mTileScaleX[0], &mTileScaleY[0],
+										&mTileFlags[0], mTileIndex.size());
+
+	for (size_t i = 0; i < mTileIndex.size(); ++i)
+	{
+		flags[mTileIndex[i]] = mTileFlags[i];
 	}
 }
 
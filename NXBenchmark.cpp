@@ -0,0 +1,169 @@
+/**************************************************************************************************
+* \file	    NXBenchmark.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Timing repeated runs of code and writing the results for comparing builds\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXBenchmark.h"
+#include "NXAssert.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+/**************************************************************************************************
+ * \fn	double NXPercentile(std::vector<double>& values, double percentage)
+ *
+ * \brief	Gets a percentile by nearest rank.
+ *
+ * \param [in,out]	values	The values, sorted on return.
+ * \param	percentage		From 0 to 100.
+ *
+ * \return	The percentile, 0 if there are no values.
+**************************************************************************************************/
+
+double NXPercentile(std::vector<double>& values, double percentage)
+{
+	if (values.empty())
+	{
+		return 0.0;
+	}
+
+	std::sort(values.begin(), values.end());
+	const double rank = percentage / 100.0 * (values.size() - 1);
+	const size_t index = size_t(rank + 0.5);
+	return values[std::min(index, values.size() - 1)];
+}
+
+/**************************************************************************************************
+ * \fn	bool NXWriteBenchmarkMap(const char *FileName, int width, int height)
+ *
+ * \brief	Writes a generated tile map.
+ *
+ * \param	FileName	Name of the file, replaced if it exists.
+ * \param	width		Cells across.
+ * \param	height		Cells down.
+ *
+ * \return	false if the file could not be written.
+**************************************************************************************************/
+
+bool NXWriteBenchmarkMap(const char *FileName, int width, int height)
+{
+	FILE *file = fopen(FileName, "w");
+	if (file == 0)
+	{
+		NX_MESG("NXWriteBenchmarkMap: Unable to write the map\n");
+		return false;
+	}
+
+	fprintf(file, "<NXState>\n<Dimension Width=\"%d\" Height=\"%d\"/>\n<Map>\n", width, height);
+	std::string row(size_t(width) + 1, '\n');
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const bool isBorder = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+			row[x] = isBorder || rand() % 5 == 0 ? '1' : '0';
+		}
+		fwrite(row.c_str(), 1, row.size(), file);
+	}
+	fprintf(file, "</Map>\n</NXState>\n");
+	fclose(file);
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	NXBenchmarkReport::NXBenchmarkReport( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXBenchmarkReport::NXBenchmarkReport( void ) :
+	mFile(0)
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXBenchmarkReport::~NXBenchmarkReport( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXBenchmarkReport::~NXBenchmarkReport( void )
+{
+	Close();
+}
+
+/**************************************************************************************************
+ * \fn	bool NXBenchmarkReport::Open(const char *FileName)
+ *
+ * \brief	Creates the report file and writes the column names.
+ *
+ * \param	FileName	Name of the file, replaced if it exists.
+ *
+ * \return	false if the file could not be created.
+**************************************************************************************************/
+
+bool NXBenchmarkReport::Open(const char *FileName)
+{
+	Close();
+	mFile = fopen(FileName, "w");
+	if (mFile == 0)
+	{
+		return false;
+	}
+	fprintf(mFile, "benchmark,size,operations,samples,min_ns,median_ns,max_ns\n");
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	void NXBenchmarkReport::Close( void )
+ *
+ * \brief	Closes the report file.
+**************************************************************************************************/
+
+void NXBenchmarkReport::Close( void )
+{
+	if (mFile)
+	{
+		fclose(mFile);
+		mFile = 0;
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXBenchmarkReport::Add(const char *name, size_t size, size_t operations,
+ * 			std::vector<double>& seconds)
+ *
+ * \brief	Writes the results of one benchmark.
+ *
+ * \param	name			The benchmark.
+ * \param	size			What it was run on, e.g. the number of objects.
+ * \param	operations		Operations done by each sample.
+ * \param [in,out]	seconds	Time taken by each sample, sorted on return.
+**************************************************************************************************/
+
+void NXBenchmarkReport::Add(const char *name, size_t size, size_t operations, std::vector<double>& seconds)
+{
+	if (mFile == 0 || seconds.empty() || operations == 0)
+	{
+		return;
+	}
+
+	const double scale = 1e9 / operations;
+	const double median = NXPercentile(seconds, 50.0);
+	fprintf(mFile, "%s,%u,%u,%u,%.2f,%.2f,%.2f\n", name, unsigned(size), unsigned(operations),
+			unsigned(seconds.size()), seconds.front() * scale, median * scale, seconds.back() * scale);
+	fflush(mFile);
+}
@@ -0,0 +1,66 @@
+/**************************************************************************************************
+* \file	    NXBenchmark.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Timing repeated runs of code and writing the results for comparing builds\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXBENCHMARK_H_
+#define NXBENCHMARK_H_
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+class NXStopwatch
+{
+	public:
+		NXStopwatch( void ) { Start(); }
+
+		void Start( void ) { mStart = std::chrono::steady_clock::now(); }
+		double GetSeconds( void ) const
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point mStart;
+};
+
+//Value below which a percentage of the values fall, e.g. 50 for the median. Sorts the values.
+double NXPercentile(std::vector<double>& values, double percentage);
+
+//Writes a tile map in the format of NXTileMap::ImportMapDataFromFile,
+//solid around the border and about one cell in five solid inside. Uses rand.
+bool NXWriteBenchmarkMap(const char *FileName, int width, int height);
+
+//One line per benchmark in a comma separated file, so two builds can be diffed or loaded
+//into a spreadsheet. Times are per operation, in nanoseconds.
+class NXBenchmarkReport
+{
+	public:
+		NXBenchmarkReport( void );
+		~NXBenchmarkReport( void );
+
+		bool Open(const char *FileName);
+		void Close( void );
+
+		//Seconds holds one entry per sample, each sample doing the given number of operations
+		void Add(const char *name, size_t size, size_t operations, std::vector<double>& seconds);
+
+	private:
+		FILE *mFile;
+};
+
+#endif
@@ -0,0 +1,354 @@
+/**************************************************************************************************
+* \file	    NXBitGrid.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	One bit per cell grid used for tile collision\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXBitGrid.h"
+#include <cstring>
+
+static const NXBitWord ALL_BITS = ~NXBitWord(0);
+static const NXBitWord BLOCK_COLUMN = 0x0101010101010101ULL;
+
+/**************************************************************************************************
+ * \fn	NXBitGrid::NXBitGrid( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXBitGrid::NXBitGrid( void ) :
+	mWords(0),
+	mWordCount(0),
+	mWidth(0),
+	mHeight(0),
+	mStride(0),
+	mLayout(NXBITGRID_ROW_MAJOR),
+	isOwner(false)
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXBitGrid::~NXBitGrid( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXBitGrid::~NXBitGrid( void )
+{
+	Free();
+}
+
+/**************************************************************************************************
+ * \fn	size_t NXBitGrid::GetWordCount(int Width, int Height, NXBITGRID_LAYOUT Layout)
+ *
+ * \brief	Number of words needed for a grid of the given size. Rows (or block rows) are padded
+ * 			to whole words.
+**************************************************************************************************/
+
+size_t NXBitGrid::GetWordCount(int Width, int Height, NXBITGRID_LAYOUT Layout)
+{
+	if (Width <= 0 || Height <= 0)
+	{
+		return 0;
+	}
+
+	if (Layout == NXBITGRID_ROW_MAJOR)
+	{
+		return size_t((Width + 63) >> 6) * size_t(Height);
+	}
+	return size_t((Width + 7) >> 3) * size_t((Height + 7) >> 3);
+}
+
+/**************************************************************************************************
+ * \fn	void NXBitGrid::Init(int Width, int Height, NXBITGRID_LAYOUT Layout)
+ *
+ * \brief	Allocates an empty grid.
+**************************************************************************************************/
+
+void NXBitGrid::Init(int Width, int Height, NXBITGRID_LAYOUT Layout)
+{
+	Free();
+
+	mWidth = Width;
+	mHeight = Height;
+	mLayout = Layout;
+	mStride = (Layout == NXBITGRID_ROW_MAJOR) ? ((Width + 63) >> 6) : ((Width + 7) >> 3);
+	mWordCount = GetWordCount(Width, Height, Layout);
+	if (mWordCount)
+	{
+		mWords = new NXBitWord[mWordCount];
+		isOwner = true;
+	}
+	Clear();
+}
+
+/**************************************************************************************************
+ * \fn	void NXBitGrid::Attach(NXBitWord *Words, int Width, int Height, NXBITGRID_LAYOUT Layout)
+ *
+ * \brief	Uses existing memory (e.g. a mapped file) as the grid. The memory is not freed.
+**************************************************************************************************/
+
+void NXBitGrid::Attach(NXBitWord *Words, int Width, int Height, NXBITGRID_LAYOUT Layout)
+{
+	Free();
+
+	mWords = Words;
+	mWidth = Width;
+	mHeight = Height;
+	mLayout = Layout;
+	mStride = (Layout == NXBITGRID_ROW_MAJOR) ? ((Width + 63) >> 6) : ((Width + 7) >> 3);
+	mWordCount = GetWordCount(Width, Height, Layout);
+	isOwner = false;
+}
+
+/**************************************************************************************************
+ * \fn	void NXBitGrid::Free( void )
+ *
+ * \brief	Releases the grid.
+**************************************************************************************************/
+
+void NXBitGrid::Free( void )
+{
+	if (isOwner && mWords)
+	{
+		delete [] mWords;
+	}
+	mWords = 0;
+	mWordCount = 0;
+	mWidth = mHeight = mStride = 0;
+	isOwner = false;
+}
+
+/**************************************************************************************************
+ * \fn	void NXBitGrid::Clear( void )
+ *
+ * \brief	Sets every cell to empty.
+**************************************************************************************************/
+
+void NXBitGrid::Clear( void )
+{
+	if (mWords)
+	{
+		memset(mWords, 0, mWordCount * sizeof(NXBitWord));
+	}
+}
+
+/**************************************************************************************************
+ * \fn	int NXBitGrid::FindFirstInRow(int Y, int X0, int X1) const
+ *
+ * \brief	Finds the first solid cell in row Y between X0 and X1.
+ *
+ * \return	The column of the cell, -1 if the span is empty.
+**************************************************************************************************/
+
+int NXBitGrid::FindFirstInRow(int Y, int X0, int X1) const
+{
+	if (Y < 0 || Y >= mHeight)
+	{
+		return -1;
+	}
+	if (X0 < 0) X0 = 0;
+	if (X1 >= mWidth) X1 = mWidth - 1;
+	if (X0 > X1)
+	{
+		return -1;
+	}
+
+	if (mLayout == NXBITGRID_ROW_MAJOR)
+	{
+		const NXBitWord *row = mWords + size_t(Y) * mStride;
+		const int w0 = X0 >> 6, w1 = X1 >> 6;
+		for (int w = w0; w <= w1; ++w)
+		{
+			NXBitWord word = row[w];
+			if (w == w0) word &= ALL_BITS << (X0 & 63);
+			if (w == w1) word &= ALL_BITS >> (63 - (X1 & 63));
+			if (word)
+			{
+				return (w << 6) + NXBitScanForward(word);
+			}
+		}
+		return -1;
+	}
+
+	const NXBitWord *blocks = mWords + size_t(Y >> 3) * mStride;
+	const int shift = (Y & 7) << 3;
+	const int b0 = X0 >> 3, b1 = X1 >> 3;
+	for (int b = b0; b <= b1; ++b)
+	{
+		NXBitWord row = (blocks[b] >> shift) & 0xFF;
+		if (b == b0) row &= 0xFFu << (X0 & 7);
+		if (b == b1) row &= 0xFFu >> (7 - (X1 & 7));
+		if (row)
+		{
+			return (b << 3) + NXBitScanForward(row);
+		}
+	}
+	return -1;
+}
+
+/**************************************************************************************************
+ * \fn	int NXBitGrid::FindLastInRow(int Y, int X0, int X1) const
+ *
+ * \brief	Finds the last solid cell in row Y between X0 and X1.
+ *
+ * \return	The column of the cell, -1 if the span is empty.
+**************************************************************************************************/
+
+int NXBitGrid::FindLastInRow(int Y, int X0, int X1) const
+{
+	if (Y < 0 || Y >= mHeight)
+	{
+		return -1;
+	}
+	if (X0 < 0) X0 = 0;
+	if (X1 >= mWidth) X1 = mWidth - 1;
+	if (X0 > X1)
+	{
+		return -1;
+	}
+
+	if (mLayout == NXBITGRID_ROW_MAJOR)
+	{
+		const NXBitWord *row = mWords + size_t(Y) * mStride;
+		const int w0 = X0 >> 6, w1 = X1 >> 6;
+		for (int w = w1; w >= w0; --w)
+		{
+			NXBitWord word = row[w];
+			if (w == w0) word &= ALL_BITS << (X0 & 63);
+			if (w == w1) word &= ALL_BITS >> (63 - (X1 & 63));
+			if (word)
+			{
+				return (w << 6) + NXBitScanReverse(word);
+			}
+		}
+		return -1;
+	}
+
+	const NXBitWord *blocks = mWords + size_t(Y >> 3) * mStride;
+	const int shift = (Y & 7) << 3;
+	const int b0 = X0 >> 3, b1 = X1 >> 3;
+	for (int b = b1; b >= b0; --b)
+	{
+		NXBitWord row = (blocks[b] >> shift) & 0xFF;
+		if (b == b0) row &= 0xFFu << (X0 & 7);
+		if (b == b1) row &= 0xFFu >> (7 - (X1 & 7));
+		if (row)
+		{
+			return (b << 3) + NXBitScanReverse(row);
+		}
+	}
+	return -1;
+}
+
+/**************************************************************************************************
+ * \fn	int NXBitGrid::FindFirstInColumn(int X, int Y0, int Y1) const
+ *
+ * \brief	Finds the lowest solid cell in column X between Y0 and Y1.
+ *
+ * \return	The row of the cell, -1 if the span is empty.
+**************************************************************************************************/
+
+int NXBitGrid::FindFirstInColumn(int X, int Y0, int Y1) const
+{
+	if (X < 0 || X >= mWidth)
+	{
+		return -1;
+	}
+	if (Y0 < 0) Y0 = 0;
+	if (Y1 >= mHeight) Y1 = mHeight - 1;
+	if (Y0 > Y1)
+	{
+		return -1;
+	}
+
+	if (mLayout == NXBITGRID_ROW_MAJOR)
+	{
+		const NXBitWord *column = mWords + (X >> 6);
+		const NXBitWord bit = NXBitWord(1) << (X & 63);
+		for (int y = Y0; y <= Y1; ++y)
+		{
+			if (column[size_t(y) * mStride] & bit)
+			{
+				return y;
+			}
+		}
+		return -1;
+	}
+
+	const NXBitWord column = BLOCK_COLUMN << (X & 7);
+	const int b0 = Y0 >> 3, b1 = Y1 >> 3;
+	for (int b = b0; b <= b1; ++b)
+	{
+		NXBitWord bits = mWords[size_t(b) * mStride + (X >> 3)] & column;
+		if (b == b0) bits &= ALL_BITS << ((Y0 & 7) << 3);
+		if (b == b1) bits &= ALL_BITS >> ((7 - (Y1 & 7)) << 3);
+		if (bits)
+		{
+			return (b << 3) + (NXBitScanForward(bits) >> 3);
+		}
+	}
+	return -1;
+}
+
+/**************************************************************************************************
+ * \fn	int NXBitGrid::FindLastInColumn(int X, int Y0, int Y1) const
+ *
+ * \brief	Finds the highest solid cell in column X between Y0 and Y1.
+ *
+ * \return	The row of the cell, -1 if the span is empty.
+**************************************************************************************************/
+
+int NXBitGrid::FindLastInColumn(int X, int Y0, int Y1) const
+{
+	if (X < 0 || X >= mWidth)
+	{
+		return -1;
+	}
+	if (Y0 < 0) Y0 = 0;
+	if (Y1 >= mHeight) Y1 = mHeight - 1;
+	if (Y0 > Y1)
+	{
+		return -1;
+	}
+
+	if (mLayout == NXBITGRID_ROW_MAJOR)
+	{
+		const NXBitWord *column = mWords + (X >> 6);
+		const NXBitWord bit = NXBitWord(1) << (X & 63);
+		for (int y = Y1; y >= Y0; --y)
+		{
+			if (column[size_t(y) * mStride] & bit)
+			{
+				return y;
+			}
+		}
+		return -1;
+	}
+
+	const NXBitWord column = BLOCK_COLUMN << (X & 7);
+	const int b0 = Y0 >> 3, b1 = Y1 >> 3;
+	for (int b = b1; b >= b0; --b)
+	{
+		NXBitWord bits = mWords[size_t(b) * mStride + (X >> 3)] & column;
+		if (b == b0) bits &= ALL_BITS << ((Y0 & 7) << 3);
+		if (b == b1) bits &= ALL_BITS >> ((7 - (Y1 & 7)) << 3);
+		if (bits)
+		{
+			return (b << 3) + (NXBitScanReverse(bits) >> 3);
+		}
+	}
+	return -1;
+}
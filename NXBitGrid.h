@@ -0,0 +1,155 @@
+/**************************************************************************************************
+* \file	    NXBitGrid.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	One bit per cell grid used for tile collision\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXBITGRID_H_
+#define NXBITGRID_H_
+
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+typedef unsigned long long NXBitWord;
+
+enum NXBITGRID_LAYOUT
+{
+	NXBITGRID_ROW_MAJOR = 0,	//64 cells of a row per word
+	NXBITGRID_BLOCK_8X8			//One 8x8 block per word, byte n is row n of the block
+};
+
+//Index of the lowest / highest set bit, Word must not be 0
+inline int NXBitScanForward(NXBitWord Word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, Word);
+	return int(index);
+#else
+	return __builtin_ctzll(Word);
+#endif
+}
+
+inline int NXBitScanReverse(NXBitWord Word)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, Word);
+	return int(index);
+#else
+	return 63 - __builtin_clzll(Word);
+#endif
+}
+
+class NXBitGrid
+{
+	public:
+		NXBitGrid( void );
+		~NXBitGrid( void );
+
+		void Init(int Width, int Height, NXBITGRID_LAYOUT Layout = NXBITGRID_ROW_MAJOR);
+		void Attach(NXBitWord *Words, int Width, int Height, NXBITGRID_LAYOUT Layout);
+		void Free( void );
+		void Clear( void );
+
+		static size_t GetWordCount(int Width, int Height, NXBITGRID_LAYOUT Layout);
+
+		//Unchecked access, X and Y must be inside the grid
+		bool Get(int X, int Y) const;
+		void Set(int X, int Y, bool Solid);
+
+		//Out of bounds cells are empty
+		int  GetCellValue(int X, int Y) const;
+
+		//Spans are inclusive and clipped to the grid. Rows are tested a word
+		//at a time, columns a word at a time in the 8x8 block layout.
+		bool IsRowSpanEmpty(int Y, int X0, int X1) const { return FindFirstInRow(Y, X0, X1) < 0; }
+		bool IsColumnSpanEmpty(int X, int Y0, int Y1) const { return FindFirstInColumn(X, Y0, Y1) < 0; }
+		int  FindFirstInRow(int Y, int X0, int X1) const;
+		int  FindLastInRow(int Y, int X0, int X1) const;
+		int  FindFirstInColumn(int X, int Y0, int Y1) const;
+		int  FindLastInColumn(int X, int Y0, int Y1) const;
+
+		int  GetWidth( void ) const { return mWidth; }
+		int  GetHeight( void ) const { return mHeight; }
+		NXBITGRID_LAYOUT GetLayout( void ) const { return mLayout; }
+		const NXBitWord * GetWords( void ) const { return mWords; }
+		size_t GetWordCount( void ) const { return mWordCount; }
+		size_t GetWordIndex(int X, int Y) const;
+		int  GetBitIndex(int X, int Y) const;
+		int  GetStride( void ) const { return mStride; }
+
+	private:
+		NXBitGrid(const NXBitGrid&);
+		NXBitGrid& operator=(const NXBitGrid&);
+
+		NXBitWord *mWords;
+		size_t mWordCount;
+		int mWidth;
+		int mHeight;
+		int mStride;	//Words per row, or blocks per block row
+		NXBITGRID_LAYOUT mLayout;
+		bool isOwner;
+};
+
+inline size_t NXBitGrid::GetWordIndex(int X, int Y) const
+{
+	if (mLayout == NXBITGRID_ROW_MAJOR)
+	{
+		return size_t(Y) * mStride + (X >> 6);
+	}
+	return size_t(Y >> 3) * mStride + (X >> 3);
+}
+
+inline int NXBitGrid::GetBitIndex(int X, int Y) const
+{
+	if (mLayout == NXBITGRID_ROW_MAJOR)
+	{
+		return X & 63;
+	}
+	return ((Y & 7) << 3) | (X & 7);
+}
+
+inline bool NXBitGrid::Get(int X, int Y) const
+{
+	return ((mWords[GetWordIndex(X, Y)] >> GetBitIndex(X, Y)) & 1) != 0;
+}
+
+inline void NXBitGrid::Set(int X, int Y, bool Solid)
+{
+	NXBitWord bit = NXBitWord(1) << GetBitIndex(X, Y);
+	if (Solid)
+	{
+		mWords[GetWordIndex(X, Y)] |= bit;
+	}
+	else
+	{
+		mWords[GetWordIndex(X, Y)] &= ~bit;
+	}
+}
+
+inline int NXBitGrid::GetCellValue(int X, int Y) const
+{
+	if (unsigned(X) < unsigned(mWidth) && unsigned(Y) < unsigned(mHeight))
+	{
+		return Get(X, Y) ? 1 : 0;
+	}
+	return 0;
+}
+
+#endif
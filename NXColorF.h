@@ -0,0 +1,57 @@
+/**************************************************************************************************
+* \file	    NXColorF.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Color with float channels, for blending and interpolating colors\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXCOLORF_H_
+#define NXCOLORF_H_
+
+#include "NXGraphicEngine.h"
+
+//Channels are in 0 to 255 like NXCOLOR, but may go outside that range in between
+struct NXColorF
+{
+	float a, r, g, b;
+
+	NXColorF( void ) : a(0.0f), r(0.0f), g(0.0f), b(0.0f) {}
+	NXColorF(float A, float R, float G, float B) : a(A), r(R), g(G), b(B) {}
+	explicit NXColorF(NXCOLOR color) :
+		a(float((color >> 24) & 0xff)),
+		r(float((color >> 16) & 0xff)),
+		g(float((color >> 8) & 0xff)),
+		b(float(color & 0xff))
+	{
+	}
+
+	//Rounded and clamped to 0 to 255
+	NXCOLOR ToColor( void ) const
+	{
+		return NXCOLOR_ARGB(ToChannel(a), ToChannel(r), ToChannel(g), ToChannel(b));
+	}
+
+	NXColorF operator+(const NXColorF& rhs) const { return NXColorF(a + rhs.a, r + rhs.r, g + rhs.g, b + rhs.b); }
+	NXColorF operator-(const NXColorF& rhs) const { return NXColorF(a - rhs.a, r - rhs.r, g - rhs.g, b - rhs.b); }
+	NXColorF operator*(float s) const { return NXColorF(a * s, r * s, g * s, b * s); }
+	NXColorF operator/(float s) const { return NXColorF(a / s, r / s, g / s, b / s); }
+	NXColorF& operator+=(const NXColorF& rhs) { a += rhs.a; r += rhs.r; g += rhs.g; b += rhs.b; return *this; }
+
+	static int ToChannel(float c)
+	{
+		return c <= 0.0f ? 0 : c >= 255.0f ? 255 : int(c + 0.5f);
+	}
+};
+
+#endif
@@ -0,0 +1,247 @@
+/**************************************************************************************************
+* \file	    NXEasing.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Easing curves and wrap behaviours used as interpolant policies\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXEASING_H_
+#define NXEASING_H_
+
+#include <cmath>
+
+const float NXEASE_PI = 3.14159265f;
+
+//Wrap behaviours. The phase is time / duration and never negative, so truncating is flooring.
+//Advance keeps the phase bounded, Weight turns it into the 0 to 1 fraction from start to end.
+
+struct NXWrapLoop
+{
+	static float Advance(float phase) { return phase - float(int(phase)); }
+	static float Weight(float phase) { return phase; }
+	static bool IsFinished(float) { return false; }
+};
+
+struct NXWrapOnce
+{
+	static float Advance(float phase) { return phase < 1.0f ? phase : 1.0f; }
+	static float Weight(float phase) { return phase; }
+	static bool IsFinished(float phase) { return phase >= 1.0f; }
+};
+
+//Phase wraps to [0, 2), the way back is 2 - phase
+struct NXWrapCircular
+{
+	static float Advance(float phase) { return phase - 2.0f * float(int(phase * 0.5f)); }
+	static float Weight(float phase) { return 1.0f - fabsf(phase - 1.0f); }
+	static bool IsFinished(float) { return false; }
+};
+
+//Easing curves, mapping 0 to 0 and 1 to 1
+
+struct NXEaseLinear
+{
+	static float Apply(float t) { return t; }
+};
+
+struct NXEaseInQuad
+{
+	static float Apply(float t) { return t * t; }
+};
+
+struct NXEaseOutQuad
+{
+	static float Apply(float t) { return t * (2.0f - t); }
+};
+
+struct NXEaseInOutQuad
+{
+	static float Apply(float t)
+	{
+		const float u = 1.0f - t;
+		return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * u * u;
+	}
+};
+
+struct NXEaseInCubic
+{
+	static float Apply(float t) { return t * t * t; }
+};
+
+struct NXEaseOutCubic
+{
+	static float Apply(float t)
+	{
+		const float u = 1.0f - t;
+		return 1.0f - u * u * u;
+	}
+};
+
+struct NXEaseInOutCubic
+{
+	static float Apply(float t)
+	{
+		const float u = 1.0f - t;
+		return t < 0.5f ? 4.0f * t * t * t : 1.0f - 4.0f * u * u * u;
+	}
+};
+
+//Overshoots the end slightly before settling
+struct NXEaseOutBack
+{
+	static float Apply(float t)
+	{
+		const float c1 = 1.70158f, c3 = c1 + 1.0f, u = t - 1.0f;
+		return 1.0f + c3 * u * u * u + c1 * u * u;
+	}
+};
+
+//The curves below call trig or exp functions or branch, use them through NXEaseTable
+
+struct NXEaseInSineExact
+{
+	static float Apply(float t) { return 1.0f - cosf(t * NXEASE_PI * 0.5f); }
+};
+
+struct NXEaseOutSineExact
+{
+	static float Apply(float t) { return sinf(t * NXEASE_PI * 0.5f); }
+};
+
+struct NXEaseInOutSineExact
+{
+	static float Apply(float t) { return 0.5f - 0.5f * cosf(t * NXEASE_PI); }
+};
+
+struct NXEaseOutElasticExact
+{
+	static float Apply(float t)
+	{
+		if (t <= 0.0f || t >= 1.0f)
+		{
+			return t <= 0.0f ? 0.0f : 1.0f;
+		}
+		return powf(2.0f, -10.0f * t) * sinf((t * 10.0f - 0.75f) * (2.0f * NXEASE_PI / 3.0f)) + 1.0f;
+	}
+};
+
+struct NXEaseOutBounceExact
+{
+	static float Apply(float t)
+	{
+		const float n = 7.5625f, d = 2.75f;
+		if (t < 1.0f / d)
+		{
+			return n * t * t;
+		}
+		if (t < 2.0f / d)
+		{
+			t -= 1.5f / d;
+			return n * t * t + 0.75f;
+		}
+		if (t < 2.5f / d)
+		{
+			t -= 2.25f / d;
+			return n * t * t + 0.9375f;
+		}
+		t -= 2.625f / d;
+		return n * t * t + 0.984375f;
+	}
+};
+
+//Samples a curve once and evaluates it by linear interpolation between the samples
+const int NXEASE_TABLE_SIZE = 256;
+
+template <class Curve>
+struct NXEaseTable
+{
+	static float Apply(float t)
+	{
+		const float *table = GetTable();
+		const float x = t * NXEASE_TABLE_SIZE;
+		const int i = x <= 0.0f ? 0 : x < NXEASE_TABLE_SIZE ? int(x) : NXEASE_TABLE_SIZE - 1;
+		const float f = x - float(i);
+		return table[i] + (table[i + 1] - table[i]) * f;
+	}
+
+	private:
+		struct Table
+		{
+			float values[NXEASE_TABLE_SIZE + 1];
+
+			Table( void )
+			{
+				for (int i = 0; i <= NXEASE_TABLE_SIZE; ++i)
+				{
+					values[i] = Curve::Apply(float(i) / NXEASE_TABLE_SIZE);
+				}
+			}
+		};
+
+		static const float* GetTable( void )
+		{
+			static const Table table;
+			return table.values;
+		}
+};
+
+typedef NXEaseTable<NXEaseInSineExact>		NXEaseInSine;
+typedef NXEaseTable<NXEaseOutSineExact>		NXEaseOutSine;
+typedef NXEaseTable<NXEaseInOutSineExact>	NXEaseInOutSine;
+typedef NXEaseTable<NXEaseOutElasticExact>	NXEaseOutElastic;
+typedef NXEaseTable<NXEaseOutBounceExact>	NXEaseOutBounce;
+
+//For easings chosen at run time, e.g. per keyframe
+enum NXEASE
+{
+	NXEASE_LINEAR = 0,
+	NXEASE_HOLD,		//Stays at the start until the end is reached
+	NXEASE_IN_QUAD,
+	NXEASE_OUT_QUAD,
+	NXEASE_IN_OUT_QUAD,
+	NXEASE_IN_CUBIC,
+	NXEASE_OUT_CUBIC,
+	NXEASE_IN_OUT_CUBIC,
+	NXEASE_OUT_BACK,
+	NXEASE_IN_SINE,
+	NXEASE_OUT_SINE,
+	NXEASE_IN_OUT_SINE,
+	NXEASE_OUT_ELASTIC,
+	NXEASE_OUT_BOUNCE,
+
+	NXEASE_TOTAL
+};
+
+inline float NXApplyEase(NXEASE ease, float t)
+{
+	switch (ease)
+	{
+		case NXEASE_HOLD:			return t < 1.0f ? 0.0f : 1.0f;
+		case NXEASE_IN_QUAD:		return NXEaseInQuad::Apply(t);
+		case NXEASE_OUT_QUAD:		return NXEaseOutQuad::Apply(t);
+		case NXEASE_IN_OUT_QUAD:	return NXEaseInOutQuad::Apply(t);
+		case NXEASE_IN_CUBIC:		return NXEaseInCubic::Apply(t);
+		case NXEASE_OUT_CUBIC:		return NXEaseOutCubic::Apply(t);
+		case NXEASE_IN_OUT_CUBIC:	return NXEaseInOutCubic::Apply(t);
+		case NXEASE_OUT_BACK:		return NXEaseOutBack::Apply(t);
+		case NXEASE_IN_SINE:		return NXEaseInSine::Apply(t);
+		case NXEASE_OUT_SINE:		return NXEaseOutSine::Apply(t);
+		case NXEASE_IN_OUT_SINE:	return NXEaseInOutSine::Apply(t);
+		case NXEASE_OUT_ELASTIC:	return NXEaseOutElastic::Apply(t);
+		case NXEASE_OUT_BOUNCE:		return NXEaseOutBounce::Apply(t);
+		default:					return t;
+	}
+}
+
+#endif
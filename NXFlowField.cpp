@@ -0,0 +1,673 @@
+/**************************************************************************************************
+* \file	    NXFlowField.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Flow field over the tile map shared by every agent chasing the same targets\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXFlowField.h"
+#include "NXTileMap.h"
+#include <algorithm>
+#include <cmath>
+
+//Neighbours counter clockwise from +x, the opposite of direction k is (k + 4) & 7
+static const int	FLOW_DX[8]	= { 1, 1, 0, -1, -1, -1,  0,  1 };
+static const int	FLOW_DY[8]	= { 0, 1, 1,  1,  0, -1, -1, -1 };
+static const float	FLOW_UNIT	= 0.70710678f;
+static const unsigned char FLOW_NONE = 8;
+static const unsigned char CLUSTER_NONE = 4;
+
+static unsigned StepCost(int Dir)
+{
+	return (Dir & 1) ? 3 : 2;
+}
+
+/**************************************************************************************************
+ * \fn	NXFlowField::NXFlowField( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXFlowField::NXFlowField( void ) :
+	mMap(0),
+	mWidth(0),
+	mHeight(0),
+	mLimit(0),
+	mGeneration(0),
+	mCellsVisited(0),
+	mEditCursor(0),
+	mClustersX(0),
+	mClustersY(0)
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXFlowField::~NXFlowField( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXFlowField::~NXFlowField( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::Init(const NXTileMap& map, int MaxDistance)
+ *
+ * \brief	Sizes the field for a loaded map. No target is set yet.
+ *
+ * \param	map		   	The tile map.
+ * \param	MaxDistance	Cells beyond which the cell field is not expanded, 0 for no limit.
+**************************************************************************************************/
+
+void NXFlowField::Init(const NXTileMap& map, int MaxDistance)
+{
+	Free();
+
+	mMap = &map;
+	mWidth = map.GetWidth();
+	mHeight = map.GetHeight();
+	mLimit = MaxDistance > 0 ? unsigned(MaxDistance) * 2 : 0;
+
+	const size_t cells = size_t(mWidth) * mHeight;
+	mDistance.assign(cells, NXFLOWFIELD_UNREACHABLE);
+	mDirection.assign(cells, FLOW_NONE);
+	mStamp.assign(cells, 0);
+	mGeneration = 1;
+	mEditCursor = map.GetDirtyCursor();
+
+	if (mLimit)
+	{
+		mClustersX = (mWidth + NXFLOWFIELD_CLUSTER_SIZE - 1) / NXFLOWFIELD_CLUSTER_SIZE;
+		mClustersY = (mHeight + NXFLOWFIELD_CLUSTER_SIZE - 1) / NXFLOWFIELD_CLUSTER_SIZE;
+		mClusters.resize(size_t(mClustersX) * mClustersY);
+		mClusterFlow.resize(cells * 4);
+		BuildClusters(0, 0, mClustersX - 1, mClustersY - 1);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::Free( void )
+ *
+ * \brief	Releases the field.
+**************************************************************************************************/
+
+void NXFlowField::Free( void )
+{
+	std::vector<unsigned>().swap(mDistance);
+	std::vector<unsigned char>().swap(mDirection);
+	std::vector<unsigned>().swap(mStamp);
+	std::vector<Cluster>().swap(mClusters);
+	std::vector<unsigned char>().swap(mClusterFlow);
+	mTargets.clear();
+	mMap = 0;
+	mWidth = mHeight = 0;
+	mClustersX = mClustersY = 0;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXFlowField::IsOpen(int X, int Y) const
+ *
+ * \brief	Query if a cell can be walked through. Cells outside the map cannot.
+**************************************************************************************************/
+
+bool NXFlowField::IsOpen(int X, int Y) const
+{
+	return unsigned(X) < unsigned(mWidth) && unsigned(Y) < unsigned(mHeight) &&
+		   mMap->GetCellValue(X, Y) == 0;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXFlowField::CanStep(int X, int Y, int Dir) const
+ *
+ * \brief	Query if an agent can move from a cell to one of its neighbours. Diagonal steps may not
+ * 			cut the corner of a solid cell.
+**************************************************************************************************/
+
+bool NXFlowField::CanStep(int X, int Y, int Dir) const
+{
+	const int dx = FLOW_DX[Dir], dy = FLOW_DY[Dir];
+	if (!IsOpen(X + dx, Y + dy))
+	{
+		return false;
+	}
+	return (Dir & 1) == 0 || (IsOpen(X + dx, Y) && IsOpen(X, Y + dy));
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::Reach(int Index, unsigned Dist, unsigned char Dir)
+ *
+ * \brief	Gives a cell a shorter distance and queues it.
+**************************************************************************************************/
+
+void NXFlowField::Reach(int Index, unsigned Dist, unsigned char Dir)
+{
+	mStamp[Index] = mGeneration;
+	mDistance[Index] = Dist;
+	mDirection[Index] = Dir;
+	mOpen.push(Node(Dist, Index));
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::Propagate( void )
+ *
+ * \brief	Dijkstra from the queued cells. Every cell remembers the neighbour it was reached
+ * 			from, which is the way it flows.
+**************************************************************************************************/
+
+void NXFlowField::Propagate( void )
+{
+	while (!mOpen.empty())
+	{
+		const Node node = mOpen.top();
+		mOpen.pop();
+		if (node.first != Distance(node.second))
+		{
+			continue;
+		}
+		++mCellsVisited;
+
+		const int x = node.second % mWidth, y = node.second / mWidth;
+		for (int k = 0; k < 8; ++k)
+		{
+			const unsigned dist = node.first + StepCost(k);
+			if ((mLimit && dist > mLimit) || !CanStep(x, y, k))
+			{
+				continue;
+			}
+
+			const int next = (x + FLOW_DX[k]) + (y + FLOW_DY[k]) * mWidth;
+			if (Distance(next) > dist)
+			{
+				Reach(next, dist, (unsigned char)((k + 4) & 7));
+			}
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	bool NXFlowField::SetTarget(const Vec3& Target)
+ *
+ * \brief	Makes the field lead to a single position.
+ *
+ * \return	true if the field was rebuilt.
+**************************************************************************************************/
+
+bool NXFlowField::SetTarget(const Vec3& Target)
+{
+	return SetTargets(&Target, 1);
+}
+
+/**************************************************************************************************
+ * \fn	bool NXFlowField::SetTargets(const Vec3 *Targets, size_t Count)
+ *
+ * \brief	Makes the field lead to the nearest of several positions. Nothing is done while every
+ * 			target stays in the same cell, so calling it every frame is cheap.
+ *
+ * \param	Targets	The target positions.
+ * \param	Count  	Number of targets.
+ *
+ * \return	true if the field was rebuilt.
+**************************************************************************************************/
+
+bool NXFlowField::SetTargets(const Vec3 *Targets, size_t Count)
+{
+	if (mMap == 0)
+	{
+		return false;
+	}
+	ApplyEdits();
+
+	std::vector<int> cells;
+	cells.reserve(Count);
+	for (size_t i = 0; i < Count; ++i)
+	{
+		const int x = int(floorf(Targets[i].x)), y = int(floorf(Targets[i].y));
+		if (IsOpen(x, y))
+		{
+			cells.push_back(x + y * mWidth);
+		}
+	}
+	std::sort(cells.begin(), cells.end());
+	cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+	if (cells == mTargets)
+	{
+		return false;
+	}
+	mTargets.swap(cells);
+	Rebuild();
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::Rebuild( void )
+ *
+ * \brief	Builds the whole field from the current targets.
+**************************************************************************************************/
+
+void NXFlowField::Rebuild( void )
+{
+	// A new generation clears every distance without touching them
+	if (++mGeneration == 0)
+	{
+		std::fill(mStamp.begin(), mStamp.end(), 0);
+		mGeneration = 1;
+	}
+	mCellsVisited = 0;
+
+	for (size_t i = 0; i < mTargets.size(); ++i)
+	{
+		if (IsOpen(mTargets[i] % mWidth, mTargets[i] / mWidth))
+		{
+			Reach(mTargets[i], 0, FLOW_NONE);
+		}
+	}
+	Propagate();
+
+	if (!mClusters.empty())
+	{
+		BuildClusterField();
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::ApplyEdits( void )
+ *
+ * \brief	Repairs the field for each rectangle the map logged since the last call. If the map
+ * 			dropped part of its log the whole field is rebuilt.
+**************************************************************************************************/
+
+void NXFlowField::ApplyEdits( void )
+{
+	if (mMap == 0)
+	{
+		return;
+	}
+
+	mEdits.clear();
+	if (!mMap->GetDirtyRectsSince(&mEditCursor, mEdits))
+	{
+		if (!mClusters.empty())
+		{
+			BuildClusters(0, 0, mClustersX - 1, mClustersY - 1);
+		}
+		Rebuild();
+		return;
+	}
+
+	for (size_t i = 0; i < mEdits.size(); ++i)
+	{
+		OnCellsChanged(mEdits[i].x0, mEdits[i].y0, mEdits[i].x1, mEdits[i].y1);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::OnCellsChanged(int X0, int Y0, int X1, int Y1)
+ *
+ * \brief	Repairs the field after tiles were edited. The cells in the rectangle and its border,
+ * 			and every cell whose flow passed through them, are cleared and then reached again from
+ * 			the valid cells around them, so only the part of the field that depended on the edit
+ * 			is recomputed.
+ *
+ * \param	X0	The left cell.
+ * \param	Y0	The bottom cell.
+ * \param	X1	The right cell.
+ * \param	Y1	The top cell.
+**************************************************************************************************/
+
+void NXFlowField::OnCellsChanged(int X0, int Y0, int X1, int Y1)
+{
+	if (mMap == 0)
+	{
+		return;
+	}
+
+	// The border is included since a diagonal step depends on the cells beside it
+	X0 = std::max(X0 - 1, 0);
+	Y0 = std::max(Y0 - 1, 0);
+	X1 = std::min(X1 + 1, mWidth - 1);
+	Y1 = std::min(Y1 + 1, mHeight - 1);
+	if (X0 > X1 || Y0 > Y1)
+	{
+		return;
+	}
+
+	if (!mClusters.empty())
+	{
+		// The clusters around the edit may cross a border into it
+		BuildClusters(X0 / NXFLOWFIELD_CLUSTER_SIZE - 1, Y0 / NXFLOWFIELD_CLUSTER_SIZE - 1,
+					  X1 / NXFLOWFIELD_CLUSTER_SIZE + 1, Y1 / NXFLOWFIELD_CLUSTER_SIZE + 1);
+	}
+
+	if (mTargets.empty())
+	{
+		return;
+	}
+	mCellsVisited = 0;
+
+	mRepair.clear();
+	for (int y = Y0; y <= Y1; ++y)
+	{
+		for (int x = X0; x <= X1; ++x)
+		{
+			const int index = x + y * mWidth;
+			mStamp[index] = mGeneration;
+			mDistance[index] = NXFLOWFIELD_UNREACHABLE;
+			mRepair.push_back(index);
+		}
+	}
+
+	// Clear the cells downstream, those that flow into a cleared cell
+	for (size_t i = 0; i < mRepair.size(); ++i)
+	{
+		const int x = mRepair[i] % mWidth, y = mRepair[i] / mWidth;
+		for (int k = 0; k < 8; ++k)
+		{
+			const int nx = x + FLOW_DX[k], ny = y + FLOW_DY[k];
+			if (unsigned(nx) >= unsigned(mWidth) || unsigned(ny) >= unsigned(mHeight))
+			{
+				continue;
+			}
+			const int next = nx + ny * mWidth;
+			if (Distance(next) != NXFLOWFIELD_UNREACHABLE && mDirection[next] == ((k + 4) & 7))
+			{
+				mDistance[next] = NXFLOWFIELD_UNREACHABLE;
+				mRepair.push_back(next);
+			}
+		}
+	}
+
+	// Reach the cleared cells again from the targets and from the cells still valid
+	for (size_t i = 0; i < mTargets.size(); ++i)
+	{
+		const int target = mTargets[i];
+		if (Distance(target) != 0 && IsOpen(target % mWidth, target / mWidth))
+		{
+			Reach(target, 0, FLOW_NONE);
+		}
+	}
+
+	for (size_t i = 0; i < mRepair.size(); ++i)
+	{
+		const int index = mRepair[i];
+		const int x = index % mWidth, y = index / mWidth;
+		if (!IsOpen(x, y))
+		{
+			mDirection[index] = FLOW_NONE;
+			continue;
+		}
+
+		unsigned best = Distance(index);
+		int bestDir = -1;
+		for (int k = 0; k < 8; ++k)
+		{
+			if (!CanStep(x, y, k))
+			{
+				continue;
+			}
+			const unsigned from = Distance((x + FLOW_DX[k]) + (y + FLOW_DY[k]) * mWidth);
+			if (from == NXFLOWFIELD_UNREACHABLE)
+			{
+				continue;
+			}
+			const unsigned dist = from + StepCost(k);
+			if (dist < best && (mLimit == 0 || dist <= mLimit))
+			{
+				best = dist;
+				bestDir = k;
+			}
+		}
+		if (bestDir >= 0)
+		{
+			Reach(index, best, (unsigned char)bestDir);
+		}
+	}
+	Propagate();
+
+	if (!mClusters.empty())
+	{
+		BuildClusterField();
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::BuildClusters(int CX0, int CY0, int CX1, int CY1)
+ *
+ * \brief	For a range of clusters (inclusive, clipped), finds which borders an agent can cross
+ * 			and builds, for each border, a flow inside the cluster leading across it. These only
+ * 			depend on the tiles, so moving targets never rebuild them.
+**************************************************************************************************/
+
+void NXFlowField::BuildClusters(int CX0, int CY0, int CX1, int CY1)
+{
+	const int S = NXFLOWFIELD_CLUSTER_SIZE;
+	CX0 = std::max(CX0, 0);
+	CY0 = std::max(CY0, 0);
+	CX1 = std::min(CX1, mClustersX - 1);
+	CY1 = std::min(CY1, mClustersY - 1);
+
+	unsigned local[NXFLOWFIELD_CLUSTER_SIZE * NXFLOWFIELD_CLUSTER_SIZE];
+
+	for (int cy = CY0; cy <= CY1; ++cy)
+	{
+		for (int cx = CX0; cx <= CX1; ++cx)
+		{
+			const int x0 = cx * S, y0 = cy * S;
+			const int x1 = std::min(x0 + S, mWidth), y1 = std::min(y0 + S, mHeight);
+			Cluster& cluster = mClusters[cx + cy * mClustersX];
+
+			for (int side = 0; side < 4; ++side)
+			{
+				const int k = side * 2;
+				std::fill(local, local + S * S, NXFLOWFIELD_UNREACHABLE);
+				for (int y = y0; y < y1; ++y)
+				{
+					for (int x = x0; x < x1; ++x)
+					{
+						mClusterFlow[size_t(x + y * mWidth) * 4 + side] = FLOW_NONE;
+					}
+				}
+
+				// The cells that can step straight across this border
+				const bool vertical = (side & 1) == 0;
+				const int fixed = side == 0 ? x1 - 1 : side == 1 ? y1 - 1 : side == 2 ? x0 : y0;
+				const int from = vertical ? y0 : x0, to = vertical ? y1 : x1;
+				for (int i = from; i < to; ++i)
+				{
+					const int x = vertical ? fixed : i, y = vertical ? i : fixed;
+					if (IsOpen(x, y) && CanStep(x, y, k))
+					{
+						local[(x - x0) + (y - y0) * S] = 0;
+						mClusterFlow[size_t(x + y * mWidth) * 4 + side] = (unsigned char)k;
+						mOpen.push(Node(0, x + y * mWidth));
+					}
+				}
+
+				if (side == 0) cluster.linkRight = !mOpen.empty();
+				if (side == 1) cluster.linkUp = !mOpen.empty();
+
+				while (!mOpen.empty())
+				{
+					const Node node = mOpen.top();
+					mOpen.pop();
+					const int x = node.second % mWidth, y = node.second / mWidth;
+					if (node.first != local[(x - x0) + (y - y0) * S])
+					{
+						continue;
+					}
+
+					for (int d = 0; d < 8; ++d)
+					{
+						const int nx = x + FLOW_DX[d], ny = y + FLOW_DY[d];
+						if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1 || !CanStep(x, y, d))
+						{
+							continue;
+						}
+						const unsigned dist = node.first + StepCost(d);
+						unsigned& best = local[(nx - x0) + (ny - y0) * S];
+						if (dist < best)
+						{
+							best = dist;
+							mClusterFlow[size_t(nx + ny * mWidth) * 4 + side] = (unsigned char)((d + 4) & 7);
+							mOpen.push(Node(dist, nx + ny * mWidth));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXFlowField::BuildClusterField( void )
+ *
+ * \brief	Breadth first search over the clusters from the clusters holding a target.
+**************************************************************************************************/
+
+void NXFlowField::BuildClusterField( void )
+{
+	for (size_t i = 0; i < mClusters.size(); ++i)
+	{
+		mClusters[i].distance = NXFLOWFIELD_UNREACHABLE;
+		mClusters[i].next = CLUSTER_NONE;
+	}
+
+	mClusterQueue.clear();
+	for (size_t i = 0; i < mTargets.size(); ++i)
+	{
+		const int cx = (mTargets[i] % mWidth) / NXFLOWFIELD_CLUSTER_SIZE;
+		const int cy = (mTargets[i] / mWidth) / NXFLOWFIELD_CLUSTER_SIZE;
+		Cluster& cluster = mClusters[cx + cy * mClustersX];
+		if (cluster.distance != 0)
+		{
+			cluster.distance = 0;
+			mClusterQueue.push_back(cx + cy * mClustersX);
+		}
+	}
+
+	for (size_t i = 0; i < mClusterQueue.size(); ++i)
+	{
+		const int index = mClusterQueue[i];
+		const int cx = index % mClustersX, cy = index / mClustersX;
+		const unsigned dist = mClusters[index].distance + 1;
+
+		// Neighbour, the link between them, and the way back from the neighbour
+		const int neighbours[4][2] =
+		{
+			{ cx + 1, cy }, { cx, cy + 1 }, { cx - 1, cy }, { cx, cy - 1 }
+		};
+		const bool links[4] =
+		{
+			mClusters[index].linkRight,
+			mClusters[index].linkUp,
+			cx > 0 && mClusters[index - 1].linkRight,
+			cy > 0 && mClusters[index - mClustersX].linkUp
+		};
+
+		for (int k = 0; k < 4; ++k)
+		{
+			if (!links[k])
+			{
+				continue;
+			}
+			Cluster& next = mClusters[neighbours[k][0] + neighbours[k][1] * mClustersX];
+			if (next.distance == NXFLOWFIELD_UNREACHABLE)
+			{
+				next.distance = dist;
+				next.next = (unsigned char)((k + 2) & 3);
+				mClusterQueue.push_back(neighbours[k][0] + neighbours[k][1] * mClustersX);
+			}
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	bool NXFlowField::GetDirection(const float& PosX, const float& PosY, float *DirX,
+ * 			float *DirY) const
+ *
+ * \brief	Samples the field. Inside the cell field this is one lookup, beyond it the agent
+ * 			follows its cluster's flow across the border leading towards the targets.
+ *
+ * \param	PosX	   	The agent x.
+ * \param	PosY	   	The agent y.
+ * \param [out]	DirX	The unit direction x, 0 when there is none.
+ * \param [out]	DirY	The unit direction y, 0 when there is none.
+ *
+ * \return	false if the agent is at a target or cannot reach one.
+**************************************************************************************************/
+
+bool NXFlowField::GetDirection(const float& PosX, const float& PosY, float *DirX, float *DirY) const
+{
+	*DirX = *DirY = 0.0f;
+
+	const int x = int(floorf(PosX)), y = int(floorf(PosY));
+	if (mMap == 0 || unsigned(x) >= unsigned(mWidth) || unsigned(y) >= unsigned(mHeight))
+	{
+		return false;
+	}
+
+	const int index = x + y * mWidth;
+	if (Distance(index) != NXFLOWFIELD_UNREACHABLE)
+	{
+		const int k = mDirection[index];
+		if (k == FLOW_NONE)
+		{
+			return false;
+		}
+		const float scale = (k & 1) ? FLOW_UNIT : 1.0f;
+		*DirX = FLOW_DX[k] * scale;
+		*DirY = FLOW_DY[k] * scale;
+		return true;
+	}
+
+	if (mClusters.empty())
+	{
+		return false;
+	}
+
+	const Cluster& cluster = mClusters[(x / NXFLOWFIELD_CLUSTER_SIZE) +
+									   (y / NXFLOWFIELD_CLUSTER_SIZE) * mClustersX];
+	if (cluster.next == CLUSTER_NONE)
+	{
+		return false;
+	}
+
+	const int k = mClusterFlow[size_t(index) * 4 + cluster.next];
+	if (k == FLOW_NONE)
+	{
+		return false;
+	}
+	const float scale = (k & 1) ? FLOW_UNIT : 1.0f;
+	*DirX = FLOW_DX[k] * scale;
+	*DirY = FLOW_DY[k] * scale;
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	unsigned NXFlowField::GetDistance(int X, int Y) const
+ *
+ * \brief	Gets the path cost from a cell to the nearest target.
+ *
+ * \return	The cost, NXFLOWFIELD_UNREACHABLE if none or outside the cell field.
+**************************************************************************************************/
+
+unsigned NXFlowField::GetDistance(int X, int Y) const
+{
+	if (unsigned(X) >= unsigned(mWidth) || unsigned(Y) >= unsigned(mHeight))
+	{
+		return NXFLOWFIELD_UNREACHABLE;
+	}
+	return Distance(X + Y * mWidth);
+}
@@ -0,0 +1,109 @@
+/**************************************************************************************************
+* \file	    NXFlowField.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Flow field over the tile map shared by every agent chasing the same targets\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXFLOWFIELD_H_
+#define NXFLOWFIELD_H_
+
+#include "NXMaths.h"
+#include "NXTileMap.h"
+#include <functional>
+#include <queue>
+#include <vector>
+
+const unsigned	NXFLOWFIELD_UNREACHABLE  = 0xFFFFFFFF;
+const int		NXFLOWFIELD_CLUSTER_SIZE = 16;	//Cells per side of a cluster of the coarse layer
+
+class NXFlowField
+{
+	public:
+		NXFlowField( void );
+		~NXFlowField( void );
+
+		//MaxDistance bounds the cell field (in cells, 0 for the whole map). Agents beyond it
+		//are steered by the cluster layer, which keeps rebuilds cheap on very large maps.
+		void Init(const NXTileMap& map, int MaxDistance = 0);
+		void Free( void );
+
+		//Rebuilds only when a target moved to another cell, returns true if it did
+		bool SetTarget(const Vec3& Target);
+		bool SetTargets(const Vec3 *Targets, size_t Count);
+
+		//Repairs the field after the tiles of a rectangle of cells (inclusive) were changed
+		void OnCellsChanged(int X0, int Y0, int X1, int Y1);
+
+		//Repairs the field for every edit made to the map since the last call, SetTargets
+		//calls it first so a field retargeted every frame never goes stale
+		void ApplyEdits( void );
+
+		//Unit direction to move in from a position, false if unreachable or at a target
+		bool GetDirection(const float& PosX, const float& PosY, float *DirX, float *DirY) const;
+
+		//Path cost to the nearest target, 2 per straight step and 3 per diagonal step
+		unsigned GetDistance(int X, int Y) const;
+
+		unsigned GetCellsVisited( void ) const { return mCellsVisited; }
+
+	private:
+		typedef std::pair<unsigned, int> Node;
+
+		struct Cluster
+		{
+			unsigned distance;	//Cluster hops to a target cluster
+			unsigned char next;	//Border to leave by, 0 +x, 1 +y, 2 -x, 3 -y, 4 none
+			bool linkRight;		//An agent can cross the right border
+			bool linkUp;		//An agent can cross the top border
+		};
+
+		NXFlowField(const NXFlowField&);
+		NXFlowField& operator=(const NXFlowField&);
+
+		bool IsOpen(int X, int Y) const;
+		bool CanStep(int X, int Y, int Dir) const;
+		unsigned Distance(int Index) const
+		{
+			return mStamp[Index] == mGeneration ? mDistance[Index] : NXFLOWFIELD_UNREACHABLE;
+		}
+		void Reach(int Index, unsigned Dist, unsigned char Dir);
+		void Propagate( void );
+		void Rebuild( void );
+		void BuildClusters(int CX0, int CY0, int CX1, int CY1);
+		void BuildClusterField( void );
+
+		const NXTileMap *mMap;
+		int mWidth;
+		int mHeight;
+		unsigned mLimit;
+		std::vector<unsigned> mDistance;
+		std::vector<unsigned char> mDirection;	//Neighbour to move to, 8 for none
+		std::vector<unsigned> mStamp;			//mDistance is valid where this equals mGeneration
+		unsigned mGeneration;
+		std::vector<int> mTargets;
+		std::priority_queue<Node, std::vector<Node>, std::greater<Node> > mOpen;
+		std::vector<int> mRepair;
+		unsigned mCellsVisited;
+		size_t mEditCursor;
+		std::vector<NXTileDirtyRect> mEdits;
+
+		int mClustersX;
+		int mClustersY;
+		std::vector<Cluster> mClusters;
+		std::vector<unsigned char> mClusterFlow;	//Per cell, the way to each border of its cluster
+		std::vector<int> mClusterQueue;
+};
+
+#endif
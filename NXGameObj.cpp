@@ -691,7 +691,7 @@ void NXGameObj::SetSpriteID(const std::wstring& ID)
 	mSpriteID = ID;
 	isAnimationChanged = true;
 	isAnimationMatrixChanged = true;
-	SetAnimationTransformation();
+	UpdateAnimationTransformation();
 }
 
 void NXGameObj::SetEnableAdditiveBlend(bool enable)
@@ -705,39 +705,75 @@ Vec3 NXGameObj::GetOrthoPosition( void ) const
 }
 
 /**************************************************************************************************
- * \fn	void NXGameObj::Render()
+ * \fn	void NXGameObj::SetRenderMode( void )
  *
- * \brief	Renders this object.
+ * \brief	Sets the blending and z writing of this object on the graphic engine.
 **************************************************************************************************/
 
 void NXGameObj::SetRenderMode( void )
+{
+	SetRenderMode(NXGetGraphicDevice());
+}
+
+/**************************************************************************************************
+ * \fn	void NXGameObj::SetRenderMode(NXRenderDevice& device)
+ *
+ * \brief	Sets the blending and z writing of this object.
+ *
+ * \param [in,out]	device	The device, or a command list recording it.
+**************************************************************************************************/
+
+void NXGameObj::SetRenderMode(NXRenderDevice& device)
 {
 	if (!isColorModulating)
 	{
-		gEngine.GetGraphicEngine()->SetColorBlending(NXCOLOR_ARGB(255,255,255,255));
+		device.SetColorBlending(NXCOLOR_ARGB(255,255,255,255));
 	}
 	if (isAdditiveBlend)
 	{
-		gEngine.GetGraphicEngine()->SetAdditiveBlending();
+		device.SetAdditiveBlending();
 	}
 	else
 	{
-		gEngine.GetGraphicEngine()->SetNormalBlending();
+		device.SetNormalBlending();
 	}
 	if (!isZWriting)
 	{
-		gEngine.GetGraphicEngine()->DisableZChecking();
+		device.DisableZChecking();
 	}
 }
+
+/**************************************************************************************************
+ * \fn	void NXGameObj::Render()
+ *
+ * \brief	Renders this object on the graphic engine.
+**************************************************************************************************/
+
 void NXGameObj::Render()
+{
+	Render(NXGetGraphicDevice());
+}
+
+/**************************************************************************************************
+ * \fn	void NXGameObj::Render(NXRenderDevice& device)
+ *
+ * \brief	Renders this object.
+ *
+ * \param [in,out]	device	The device, or a command list recording it.
+**************************************************************************************************/
+
+void NXGameObj::Render(NXRenderDevice& device)
 {
 	if (isColorModulating)
 	{
-		gEngine.GetGraphicEngine()->SetColorBlending(colorModulate);
+		device.SetColorBlending(colorModulate);
+	}
+	if (UpdateAnimationTransformation())
+	{
+		device.SetTextureTransform( mTextureTransform );
 	}
-	SetAnimationTransformation();
-	gEngine.GetGraphicEngine()->SetObjectTransform(CreateTransformMatrix());
-	gEngine.GetGraphicEngine()->DrawTriangleList(2);
+	device.SetObjectTransform(CreateTransformMatrix());
+	device.DrawTriangleList(2);
 }
 
 /**************************************************************************************************
@@ -778,23 +814,25 @@ void NXGameObj::UpdateAnimation()
 }
 
 /**************************************************************************************************
- * \fn	void NXGameObj::SetAnimationTransformation( void )
+ * \fn	bool NXGameObj::UpdateAnimationTransformation( void )
  *
- * \brief	Sets animation transformation.
+ * \brief	Recomputes the texture transform of the current animation cell if it changed. Does
+ * 			not touch the device, so it can run on the simulation side.
+ *
+ * \return	false if the texture transform could not be computed (no sprite or animation).
 **************************************************************************************************/
 
-void NXGameObj::SetAnimationTransformation( void )
+bool NXGameObj::UpdateAnimationTransformation( void )
 {
 	if (!IsAnimationMatrixChanged())
 	{
-		gEngine.GetGraphicEngine()->SetTextureTransform( mTextureTransform );
-		return;
+		return true;
 	}
 
 	isAnimationMatrixChanged = false;
 	if (mSpriteID == L"")
 	{
-		return;
+		return false;
 	}
 
 	NXAnimationCell cell;
@@ -802,7 +840,7 @@ void NXGameObj::SetAnimationTransformation( void )
 	NX_ASSERT(animation);
 	if (animation == 0)
 	{
-		return;
+		return false;
 	}
 
 	if (mCurrentAnimation != L"")
@@ -814,21 +852,47 @@ void NXGameObj::SetAnimationTransformation( void )
 	{
 		cell = animation->GetDefaultAnimationCell();
 	}
-		D3DXMatrixScaling( &mTextureTransform, 
-			1.0f/animation->GetColumns(),
-			1.0f/animation->GetRows(), 
-			1.0f );
+	D3DXMatrixScaling( &mTextureTransform, 
+		1.0f/animation->GetColumns(),
+		1.0f/animation->GetRows(), 
+		1.0f );
 
-		mTextureTransform._31 = cell.startX;
-		mTextureTransform._32 = cell.startY;
+	mTextureTransform._31 = cell.startX;
+	mTextureTransform._32 = cell.startY;
+	return true;
+}
 
-		gEngine.GetGraphicEngine()->SetTextureTransform( mTextureTransform );
-	/*}
-	else
+/**************************************************************************************************
+ * \fn	void NXGameObj::FillRenderInstance(NXRenderInstance& instance)
+ *
+ * \brief	Copies what the renderer needs into a snapshot instance: transform, animation cell,
+ * 			color and blend flags. The texture and vertices are left to the caller, which can
+ * 			look them up once for a run of objects sharing them.
+ *
+ * \param [out]	instance	The instance.
+**************************************************************************************************/
+
+void NXGameObj::FillRenderInstance(NXRenderInstance& instance)
+{
+	instance.transform = CreateTransformMatrix();
+	instance.color = isColorModulating ? colorModulate : NXCOLOR_ARGB(255,255,255,255);
+	instance.flags = 0;
+	if (isAdditiveBlend)
+	{
+		instance.flags |= NXRENDER_ADDITIVE;
+	}
+	if (!isZWriting)
+	{
+		instance.flags |= NXRENDER_NO_Z_WRITE;
+	}
+	if (UpdateAnimationTransformation())
 	{
-		D3DXMatrixIdentity(&mTextureTransform);
-		gEngine.GetGraphicEngine()->SetTextureTransform( mTextureTransform );
-	}*/
+		instance.flags |= NXRENDER_UV_TRANSFORM;
+		instance.uvScaleX = mTextureTransform._11;
+		instance.uvScaleY = mTextureTransform._22;
+		instance.uvOffsetX = mTextureTransform._31;
+		instance.uvOffsetY = mTextureTransform._32;
+	}
 }
 
 /**************************************************************************************************
@@ -860,8 +924,9 @@ bool NXGameObj::IsVisible( void ) const
 
 void NXGameObj::RenderDebugInfo()
 {
-	gEngine.GetGraphicEngine()->SetObjectTransform(CreateCollisionMatrix());
-	gEngine.GetGraphicEngine()->DrawLineStrip(4);
+	NXRenderDevice& device = NXGetGraphicDevice();
+	device.SetObjectTransform(CreateCollisionMatrix());
+	device.DrawLineStrip(4);
 }
 
 /**************************************************************************************************
@@ -973,4 +1038,124 @@ void NXGameObj::SetFollow(NXGameObj& obj, float offsetX, float offsetY, float of
 {
 	mFollowedObj = &obj;
 	mFollowOffset = Vec3(offsetX, offsetY, offsetZ);
+}
+
+/**************************************************************************************************
+ * \fn	void NXGameObj::SaveRecord(NXGameObjRecord& record, NXObjSnapshot& snapshot) const
+ *
+ * \brief	Copies the object into a snapshot record. The slot is left to the pool.
+ *
+ * \param [out]	record		The record.
+ * \param [in,out]	snapshot	The snapshot, for its string table and handles.
+**************************************************************************************************/
+
+void NXGameObj::SaveRecord(NXGameObjRecord& record, NXObjSnapshot& snapshot) const
+{
+	record.flags = 0;
+	if (isColorModulating)	record.flags |= NXRECORD_COLOR_MODULATING;
+	if (isZWriting)			record.flags |= NXRECORD_Z_WRITING;
+	if (isAdditiveBlend)	record.flags |= NXRECORD_ADDITIVE_BLEND;
+	if (isAnimationLooping)	record.flags |= NXRECORD_ANIMATION_LOOPING;
+	if (isAnimationPaused)	record.flags |= NXRECORD_ANIMATION_PAUSED;
+	if (isHorizontalFlip)	record.flags |= NXRECORD_HORIZONTAL_FLIP;
+	if (isVerticalFlip)		record.flags |= NXRECORD_VERTICAL_FLIP;
+	if (isVisible)			record.flags |= NXRECORD_VISIBLE;
+	if (isDrawingDebugInfo)	record.flags |= NXRECORD_DEBUG_INFO;
+
+	record.userFlags = unsigned(flag);
+	record.type = 0;
+	record.pos = mPos;
+	record.offset = mOffset;
+	record.scale = mScale;
+	record.vel = mVel;
+	record.endForce = mEndForce;
+	record.pitch = mPitch;
+	record.yaw = mYaw;
+	record.roll = mRoll;
+	record.aabbMinPercent = mAABB.r_min_percent;
+	record.aabbMaxPercent = mAABB.r_max_percent;
+	record.layer = mLayer;
+	record.parallaxScale = mParallaxScale;
+	record.color = colorModulate;
+
+	record.meshID = snapshot.AddString(mMeshID);
+	record.spriteID = snapshot.AddString(mSpriteID);
+	record.animation = snapshot.AddString(mCurrentAnimation);
+	record.cellNo = mCurrentCellNo;
+	record.maxCellNo = mMaxCellNo;
+	record.animationTime = mCurrentAnimationTime;
+	record.maxAnimationTime = mMaxAnimationTime;
+
+	record.lifetimeStarting = mLifetimeM;
+	record.lifetime = mLifetime;
+	record.physicsTime = physics_dt;
+
+	record.followPool = -1;
+	record.followSlot = 0;
+	record.followOffset = mFollowOffset;
+	if (mFollowedObj)
+	{
+		snapshot.FindHandle(mFollowedObj, &record.followPool, &record.followSlot);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXGameObj::LoadRecord(const NXGameObjRecord& record, const NXObjSnapshot& snapshot)
+ *
+ * \brief	Sets the object from a snapshot record, after Init. The cached transforms are worked
+ * 			out again when next drawn.
+ *
+ * \param	record  	The record.
+ * \param	snapshot	The snapshot, for its string table and handles.
+**************************************************************************************************/
+
+void NXGameObj::LoadRecord(const NXGameObjRecord& record, const NXObjSnapshot& snapshot)
+{
+	isColorModulating = (record.flags & NXRECORD_COLOR_MODULATING) != 0;
+	isZWriting = (record.flags & NXRECORD_Z_WRITING) != 0;
+	isAdditiveBlend = (record.flags & NXRECORD_ADDITIVE_BLEND) != 0;
+	isAnimationLooping = (record.flags & NXRECORD_ANIMATION_LOOPING) != 0;
+	isAnimationPaused = (record.flags & NXRECORD_ANIMATION_PAUSED) != 0;
+	isHorizontalFlip = (record.flags & NXRECORD_HORIZONTAL_FLIP) != 0;
+	isVerticalFlip = (record.flags & NXRECORD_VERTICAL_FLIP) != 0;
+	isVisible = (record.flags & NXRECORD_VISIBLE) != 0;
+	isDrawingDebugInfo = (record.flags & NXRECORD_DEBUG_INFO) != 0;
+
+	flag = record.userFlags;
+	mPos = record.pos;
+	mOffset = record.offset;
+	mScale = record.scale;
+	mVel = record.vel;
+	mEndForce = record.endForce;
+	mPitch = record.pitch;
+	mYaw = record.yaw;
+	mRoll = record.roll;
+	mLayer = record.layer;
+	mParallaxScale = record.parallaxScale;
+	colorModulate = record.color;
+	SetAABBPercentage(record.aabbMinPercent.x, record.aabbMaxPercent.x,
+					  record.aabbMinPercent.y, record.aabbMaxPercent.y,
+					  record.aabbMinPercent.z, record.aabbMaxPercent.z);
+
+	// Most objects share their ids, only copy when they differ
+	const std::wstring& meshID = snapshot.GetString(record.meshID);
+	const std::wstring& spriteID = snapshot.GetString(record.spriteID);
+	const std::wstring& animation = snapshot.GetString(record.animation);
+	if (mMeshID != meshID)				mMeshID = meshID;
+	if (mSpriteID != spriteID)			mSpriteID = spriteID;
+	if (mCurrentAnimation != animation)	mCurrentAnimation = animation;
+	mCurrentCellNo = record.cellNo;
+	mMaxCellNo = record.maxCellNo;
+	mCurrentAnimationTime = record.animationTime;
+	mMaxAnimationTime = record.maxAnimationTime;
+	isAnimationChanged = true;
+	isAnimationMatrixChanged = true;
+
+	mLifetimeM = record.lifetimeStarting;
+	mLifetime = record.lifetime;
+	physics_dt = record.physicsTime;
+	mForceList.clear();
+
+	mFollowedObj = record.followPool < 0 ? 0 : snapshot.ResolveHandle(record.followPool, record.followSlot);
+	mFollowOffset = record.followOffset;
 }
\ No newline at end of file
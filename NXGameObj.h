@@ -26,6 +26,8 @@
 #include "NXAnimation.h"
 #include "NXPhysics.h"
 #include "NXInterpolant.h"
+#include "NXRenderSnapshot.h"
+#include "NXObjSnapshot.h"
 #include <vector>
 
 typedef	std::vector<Vec3>	ForceList;
@@ -42,6 +44,8 @@ class NXGameObj
 		virtual void Destroy( void );
 		virtual void Update();    //float g_dt = 0){};
 		virtual void RenderDebugInfo( void );
+		//Groups objects in the pool telemetry, e.g. by ObjType
+		virtual int GetTelemetryType( void ) const { return 0; }
 
 		void SetAlive ( void );
 		void SetDestroy ( void );
@@ -64,6 +68,11 @@ class NXGameObj
 
 		void SetVelocity(const Vec3& velocity);
 
+		//Addresses for NXTweenSystem to write into, remove the tweens before destroying the object
+		Vec3* BindPosition( void ) { return &mPos; }
+		Vec3* BindScale( void ) { return &mScale; }
+		NXCOLOR* BindColorModulation( void ) { isColorModulating = true; return &colorModulate; }
+
 		void SetZRenderingLayer (int layer);
 
 		void SetParallaxScale (float scale);
@@ -96,7 +105,10 @@ class NXGameObj
 		void SetEnableAdditiveBlend( bool enable );
 
 		void SetRenderMode( void );
+		void SetRenderMode(NXRenderDevice& device);
 		void Render( void );
+		void Render(NXRenderDevice& device);
+		void FillRenderInstance(NXRenderInstance& instance);
 			
 		void SetVisible(bool setVisible);
 		void SetDrawDebugInfo(bool setDraw);
@@ -112,6 +124,11 @@ class NXGameObj
 
 		void SetFollow(NXGameObj& obj, float offsetX = 0, float offsetY = 0, float offsetZ = 0);
 
+		//------Snapshot------//
+		//Not virtual, pools call the ones of their own type. Pending forces are not kept.
+		void SaveRecord(NXGameObjRecord& record, NXObjSnapshot& snapshot) const;
+		void LoadRecord(const NXGameObjRecord& record, const NXObjSnapshot& snapshot);
+
 		//-----Gettors------//
 		bool IsAlive( void ) const { return isAlive; }
 
@@ -229,7 +246,7 @@ class NXGameObj
 		NXInterpolant<float> testInt3;*/
 	private:
 		void UpdateAnimation( void );
-		void SetAnimationTransformation( void );
+		bool UpdateAnimationTransformation( void );
 
 		//Physics stuff
 		float physics_dt;
@@ -0,0 +1,216 @@
+/**************************************************************************************************
+* \file	    NXGroundTable.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Per column solid spans of a tile map for ground queries\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXGroundTable.h"
+#include <cmath>
+
+/**************************************************************************************************
+ * \fn	NXGroundTable::NXGroundTable( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXGroundTable::NXGroundTable( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXGroundTable::~NXGroundTable( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXGroundTable::~NXGroundTable( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void NXGroundTable::Build(const NXBitGrid& Grid)
+ *
+ * \brief	Builds the spans of every column of the grid.
+ *
+ * \param	Grid	The collision grid.
+**************************************************************************************************/
+
+void NXGroundTable::Build(const NXBitGrid& Grid)
+{
+	mColumns.clear();
+	mColumns.resize(Grid.GetWidth());
+
+	for (int x = 0; x < Grid.GetWidth(); ++x)
+	{
+		BuildColumn(Grid, x);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXGroundTable::RebuildColumns(const NXBitGrid& Grid, int X0, int X1)
+ *
+ * \brief	Rebuilds the spans of columns X0 to X1 after the tiles in them were changed.
+ *
+ * \param	Grid	The collision grid.
+ * \param	X0		The first column.
+ * \param	X1		The last column.
+**************************************************************************************************/
+
+void NXGroundTable::RebuildColumns(const NXBitGrid& Grid, int X0, int X1)
+{
+	if (int(mColumns.size()) != Grid.GetWidth())
+	{
+		Build(Grid);
+		return;
+	}
+
+	if (X0 < 0) X0 = 0;
+	if (X1 >= Grid.GetWidth()) X1 = Grid.GetWidth() - 1;
+	for (int x = X0; x <= X1; ++x)
+	{
+		BuildColumn(Grid, x);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXGroundTable::Free( void )
+ *
+ * \brief	Releases the table.
+**************************************************************************************************/
+
+void NXGroundTable::Free( void )
+{
+	std::vector< std::vector<Span> >().swap(mColumns);
+}
+
+/**************************************************************************************************
+ * \fn	void NXGroundTable::BuildColumn(const NXBitGrid& Grid, int X)
+ *
+ * \brief	Collects the solid spans of one column, bottom to top.
+**************************************************************************************************/
+
+void NXGroundTable::BuildColumn(const NXBitGrid& Grid, int X)
+{
+	std::vector<Span>& column = mColumns[X];
+	column.clear();
+
+	const int height = Grid.GetHeight();
+	int y = Grid.FindFirstInColumn(X, 0, height - 1);
+	while (y >= 0)
+	{
+		Span span;
+		span.bottom = y;
+		while (y + 1 < height && Grid.Get(X, y + 1))
+		{
+			++y;
+		}
+		span.top = y;
+		column.push_back(span);
+
+		y = Grid.FindFirstInColumn(X, y + 2, height - 1);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	bool NXGroundTable::GetGroundBelow(int X, float Y, float *Height) const
+ *
+ * \brief	Finds the surface of the first solid span at or below Y in column X with a binary
+ * 			search. If Y is inside a span, the surface of that span is returned.
+ *
+ * \param	X				The column.
+ * \param	Y				The height to search down from.
+ * \param [out]	Height	The height of the surface.
+ *
+ * \return	false if there is no ground below.
+**************************************************************************************************/
+
+bool NXGroundTable::GetGroundBelow(int X, float Y, float *Height) const
+{
+	if (X < 0 || X >= int(mColumns.size()))
+	{
+		return false;
+	}
+
+	const std::vector<Span>& column = mColumns[X];
+	const int cell = int(floorf(Y));
+
+	// Last span starting at or below the cell
+	size_t lo = 0, hi = column.size();
+	while (lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if (column[mid].bottom <= cell)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	if (lo == 0)
+	{
+		return false;
+	}
+
+	*Height = float(column[lo - 1].top + 1);
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXGroundTable::GetCeilingAbove(int X, float Y, float *Height) const
+ *
+ * \brief	Finds the underside of the first solid span above Y in column X.
+ *
+ * \param	X				The column.
+ * \param	Y				The height to search up from.
+ * \param [out]	Height	The height of the underside.
+ *
+ * \return	false if there is nothing above.
+**************************************************************************************************/
+
+bool NXGroundTable::GetCeilingAbove(int X, float Y, float *Height) const
+{
+	if (X < 0 || X >= int(mColumns.size()))
+	{
+		return false;
+	}
+
+	const std::vector<Span>& column = mColumns[X];
+
+	// First span starting above Y
+	size_t lo = 0, hi = column.size();
+	while (lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if (float(column[mid].bottom) <= Y)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	if (lo == column.size())
+	{
+		return false;
+	}
+
+	*Height = float(column[lo].bottom);
+	return true;
+}
@@ -0,0 +1,54 @@
+/**************************************************************************************************
+* \file	    NXGroundTable.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Per column solid spans of a tile map for ground queries\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXGROUNDTABLE_H_
+#define NXGROUNDTABLE_H_
+
+#include "NXBitGrid.h"
+#include <vector>
+
+class NXGroundTable
+{
+	public:
+		//Solid cells bottom to top inclusive, the walkable surface is at top + 1
+		struct Span
+		{
+			int bottom;
+			int top;
+		};
+
+		NXGroundTable( void );
+		~NXGroundTable( void );
+
+		void Build(const NXBitGrid& Grid);
+		void RebuildColumns(const NXBitGrid& Grid, int X0, int X1);
+		void Free( void );
+
+		bool GetGroundBelow(int X, float Y, float *Height) const;
+		bool GetCeilingAbove(int X, float Y, float *Height) const;
+
+		const std::vector<Span>& GetColumn(int X) const { return mColumns[X]; }
+		int GetWidth( void ) const { return int(mColumns.size()); }
+
+	private:
+		void BuildColumn(const NXBitGrid& Grid, int X);
+
+		std::vector< std::vector<Span> > mColumns;
+};
+
+#endif
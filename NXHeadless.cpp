@@ -0,0 +1,57 @@
+/**************************************************************************************************
+* \file	    NXHeadless.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Running without a window or device (NX_HEADLESS): a fixed step clock and a device
+* 			counting what would have been drawn\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXHeadless.h"
+#include "NXInterpolant.h"
+
+#ifdef NX_HEADLESS
+NXHeadlessClock gHeadlessClock;
+#endif
+
+/**************************************************************************************************
+ * \fn	void NXHeadlessClock::Tick( void )
+ *
+ * \brief	Advances the clock by one step.
+**************************************************************************************************/
+
+void NXHeadlessClock::Tick( void )
+{
+	mTime += mStep;
+	++mFrame;
+	NXAdvanceInterpolantClock(mStep);
+}
+
+#ifdef NX_HEADLESS
+
+/**************************************************************************************************
+ * \fn	NXNullRenderDevice& NXGetHeadlessDevice( void )
+ *
+ * \brief	The device standing in for the graphic engine. Reset it between frames or runs to
+ * 			read per frame counts.
+ *
+ * \return	The device.
+**************************************************************************************************/
+
+NXNullRenderDevice& NXGetHeadlessDevice( void )
+{
+	static NXNullRenderDevice device;
+	return device;
+}
+
+#endif
@@ -0,0 +1,57 @@
+/**************************************************************************************************
+* \file	    NXHeadless.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Running without a window or device (NX_HEADLESS): a fixed step clock and a device
+* 			counting what would have been drawn\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXHEADLESS_H_
+#define NXHEADLESS_H_
+
+#include "NXRenderDevice.h"
+
+//Time that only moves when told to, so a run gives the same result every time and goes as fast
+//as the machine allows. The engine's NXGetDeltaTime returns GetDeltaTime in headless builds.
+class NXHeadlessClock
+{
+	public:
+		NXHeadlessClock( void ) : mStep(1.0f / 60.0f), mTime(0.0), mFrame(0) {}
+
+		void SetStep(float seconds) { mStep = seconds; }
+		void Reset( void ) { mTime = 0.0; mFrame = 0; }
+
+		//Moves one step forward, the interpolant clock as well
+		void Tick( void );
+
+		float GetDeltaTime( void ) const { return mStep; }
+		double GetTime( void ) const { return mTime; }
+		unsigned GetFrame( void ) const { return mFrame; }
+
+	private:
+		float mStep;
+		double mTime;
+		unsigned mFrame;
+};
+
+#ifdef NX_HEADLESS
+
+extern NXHeadlessClock gHeadlessClock;
+
+//Everything drawn through NXGetGraphicDevice ends up here
+NXNullRenderDevice& NXGetHeadlessDevice( void );
+
+#endif
+
+#endif
@@ -19,6 +19,9 @@
 #ifndef NXINTERPOLANT_H_
 #define NXINTERPOLANT_H_
 
+#include "NXEasing.h"
+#include <cmath>
+
 enum NXINTERPOLANT_BEHAVIOUR
 {
 	NXINTERPOLANT_LOOP,
@@ -26,7 +29,22 @@ enum NXINTERPOLANT_BEHAVIOUR
 	NXINTERPOLANT_CIRCULAR	
 };
 
-template <class T>
+//Clock of the time based interpolants, advanced once per frame by the game loop. Kept in
+//double so it does not lose precision over a long session.
+inline double& NXInterpolantClock( void )
+{
+	static double time = 0.0;
+	return time;
+}
+
+inline void NXAdvanceInterpolantClock(float dt)
+{
+	NXInterpolantClock() += dt;
+}
+
+//Only needs T + T, T - T and T * float, so Vec3 and NXColorF work as well as float.
+//The behaviour can be changed at run time, see NXEasedInterpolant for a fixed one.
+template <class T, class Ease = NXEaseLinear>
 class NXInterpolant
 {
 	public:
@@ -36,6 +54,14 @@ class NXInterpolant
 		void Update(float dt);
 
 		void Init(const T& start, const T& end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour);
+
+		//Time based: only the start time is stored and the value is computed when asked for,
+		//so Update does nothing and seeking to any time is exact
+		void InitTimed(const T& start, const T& end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour);
+		void Seek(float seconds);
+		T GetValueAt(float seconds) const;
+		float GetElapsed( void ) const;
+		bool IsTimed( void ) const { return isTimed; }
 		void SetEnd(const T& end);
 		void SetRange(const T& start, const T& end);
 		void SetSpeed(float Start_To_End_Seconds);
@@ -49,230 +75,261 @@ class NXInterpolant
 		float GetPercentage( void );
 		bool IsPaused( void );
 
+		const T& GetStart( void ) const { return mStart; }
+		const T& GetEnd( void ) const { return mEnd; }
+		float GetDuration( void ) const { return mRate; }
+		NXINTERPOLANT_BEHAVIOUR GetBehaviour( void ) const { return mBehaviour; }
+
 	private:
+		float GetPhase(float seconds) const;
+		float GetWeightAt(float seconds) const;
+
 		T mStart;
 		T mEnd;
 		T mDelta;
-		T mInterp;
-		T mValue;
 		NXINTERPOLANT_BEHAVIOUR mBehaviour;
-		float mDirection;
+		float mElapsed;
 		float mRate;
 		bool isPaused;
+		bool isTimed;
+		double mStartTime;
+		double mPauseTime;
 };
 
-template <class T>
-NXInterpolant<T>::NXInterpolant()
+template <class T, class Ease>
+NXInterpolant<T, Ease>::NXInterpolant() :
+	mBehaviour(NXINTERPOLANT_ONCE),
+	mElapsed(0.0f),
+	mRate(0.0f),
+	isPaused(false),
+	isTimed(false),
+	mStartTime(0.0),
+	mPauseTime(0.0)
 {
 }
 
-template <class T>
-NXInterpolant<T>::NXInterpolant(const T& start, const T& end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
+template <class T, class Ease>
+NXInterpolant<T, Ease>::NXInterpolant(const T& start, const T& end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
 {
 	Init(start, end, Start_To_End_Seconds, behaviour);
 }
 
-template <class T>
-void NXInterpolant<T>::Init(const T& start, const T& end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::Init(const T& start, const T& end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
 {
 	mStart = start; mEnd = end;
 	mDelta = mEnd - mStart;
 	mRate = Start_To_End_Seconds;
-	if (abs(mRate) > 0.0f)
-	{
-		mInterp = mDelta/mRate;
-	}
-	else
-	{
-		mInterp = mDelta;
-	}
 	mBehaviour = behaviour;
-	mValue = mStart;
-	mDirection = 1.0f;
+	mElapsed = 0.0f;
 	isPaused = false;
+	isTimed = false;
+	mStartTime = mPauseTime = NXInterpolantClock();
 }
 
-template <class T>
-void NXInterpolant<T>::SetEnd(const T& end)
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::InitTimed(const T& start, const T& end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
 {
-	T temp = mValue;
-	SetRange(mStart, end);
-	temp = mValue;
+	Init(start, end, Start_To_End_Seconds, behaviour);
+	isTimed = true;
 }
 
-template <class T>
-void NXInterpolant<T>::Update(float dt)
+template <class T, class Ease>
+float NXInterpolant<T, Ease>::GetElapsed( void ) const
 {
-	if (isPaused)
+	if (!isTimed)
 	{
-		return;
+		return mElapsed;
 	}
+	return float((isPaused ? mPauseTime : NXInterpolantClock()) - mStartTime);
+}
 
-	mValue += mInterp * mDirection * dt;
-	if (mBehaviour == NXINTERPOLANT_LOOP)
-	{
-		if (mEnd > mStart)
-		{
-			if (mValue > mEnd)
-			{
-				T remain = mValue - mEnd;
-				mValue = mStart + remain;
-			}
-		}
-		else //if (mStart > mEnd)
-		{
-			if (mValue > mStart)
-			{
-				T remain = mValue - mStart;
-				mValue = mEnd + remain;
-			}
-		}
-	}
-	if (mBehaviour == NXINTERPOLANT_CIRCULAR)
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::Seek(float seconds)
+{
+	seconds = seconds > 0.0f ? seconds : 0.0f;
+	if (isTimed)
 	{
-		if (mEnd > mStart)
-		{
-			if (mValue > mEnd)
-			{
-				T remain = mValue - mEnd;
-				mValue = mEnd - remain;
-				mDirection = mDirection * -1.0f;
-			}
-			if (mValue < mStart)
-			{
-				T remain = mStart - mValue;
-				mValue = mStart + remain;
-				mDirection = mDirection * -1.0f;
-			}
-		}
-		else //if (mEnd < mStart)
-		{
-			if (mValue > mStart)
-			{
-				T remain = mValue - mStart;
-				mValue = mStart - remain;
-				mDirection = mDirection * -1.0f;
-			}
-			if (mValue < mEnd)
-			{
-				T remain = mEnd - mValue;
-				mValue = mEnd + remain;
-				mDirection = mDirection * -1.0f;
-			}
-		}
+		mStartTime = (isPaused ? mPauseTime : NXInterpolantClock()) - seconds;
+		return;
 	}
-	if (mBehaviour == NXINTERPOLANT_ONCE)
+
+	// Kept to one period so it does not lose precision
+	mElapsed = mRate > 0.0f ? GetPhase(seconds) * mRate : seconds;
+	if (mBehaviour == NXINTERPOLANT_ONCE && mElapsed >= mRate)
 	{
-		if (mEnd > mStart)
-		{
-			if (mValue > mEnd)
-			{
-				mValue = mEnd;
-				isPaused = true;
-				//T remain = mValue - mEnd;
-				//mValue = mStart + remain;
-			}
-		}
-		else //if (mStart > mEnd)
-		{
-			if (mValue < mEnd)
-			{
-				mValue = mEnd;
-				isPaused = true;
-			}
-		}
+		isPaused = true;
 	}
 }
 
-template <class T>
-void NXInterpolant<T>::SetSpeed(float Start_To_End_Seconds)
+template <class T, class Ease>
+float NXInterpolant<T, Ease>::GetPhase(float seconds) const
 {
-	mRate = Start_To_End_Seconds
-	if (abs(mRate) > 0.0f)
+	const float p = seconds > 0.0f ? seconds / mRate : 0.0f;
+	switch (mBehaviour)
 	{
-		mInterp = mStart/mRate;
+		case NXINTERPOLANT_LOOP:	return NXWrapLoop::Advance(p);
+		case NXINTERPOLANT_ONCE:	return NXWrapOnce::Advance(p);
+		default:					return NXWrapCircular::Advance(p);
 	}
-	else
+}
+
+//Fraction of the way from start to end after some seconds:
+//loop p - floor(p), once p clamped to 1, circular p mod 2 folded back after 1
+template <class T, class Ease>
+float NXInterpolant<T, Ease>::GetWeightAt(float seconds) const
+{
+	if (!(mRate > 0.0f))
 	{
-		mInterp = mStart;
+		return 1.0f;
 	}
+
+	const float p = GetPhase(seconds);
+	return mBehaviour == NXINTERPOLANT_CIRCULAR ? NXWrapCircular::Weight(p) : p;
 }
 
-template <class T>
-void NXInterpolant<T>::SetRange(const T& start, const T& end)
+template <class T, class Ease>
+T NXInterpolant<T, Ease>::GetValueAt(float seconds) const
 {
-	mStart = start; mEnd = end;
-	mDelta = mEnd - mStart;
+	return mStart + mDelta * Ease::Apply(GetWeightAt(seconds));
+}
 
-	if (mRate > 0.0f)
-	{
-		mInterp = (mDelta)/mRate;
-	}
-	else
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::SetEnd(const T& end)
+{
+	SetRange(mStart, end);
+}
+
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::Update(float dt)
+{
+	if (isPaused || isTimed)
 	{
-		mInterp = mDelta;
+		return;
 	}
-	mValue = start;
-	mDirection = 1;
-	isPaused = false;
+
+	Seek(mElapsed + dt);
 }
 
-template <class T>
-void NXInterpolant<T>::SetCurrentPercentage(float percentage)
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::SetSpeed(float Start_To_End_Seconds)
 {
-	mValue = mStart + ( mDelta * percentage );
+	// Keep the same fraction of the way through
+	const float elapsed = GetElapsed();
+	const float previous = mRate;
+	mRate = Start_To_End_Seconds;
+	if (previous > 0.0f)
+	{
+		Seek(elapsed / previous * mRate);
+	}
 }
 
-template <class T>
-void NXInterpolant<T>::SetBehaviour( NXINTERPOLANT_BEHAVIOUR behaviour )
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::SetRange(const T& start, const T& end)
 {
-	mBehaviour = behaviour;
+	mStart = start; mEnd = end;
+	mDelta = mEnd - mStart;
+	Reset();
 }
 
-template <class T>
-void SetPause( bool pause )
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::SetCurrentPercentage(float percentage)
 {
-	isPaused = pause;
+	Seek(percentage * mRate);
 }
 
-template <class T>
-T NXInterpolant<T>::GetValue( void )
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::SetBehaviour( NXINTERPOLANT_BEHAVIOUR behaviour )
 {
-	return mValue;
+	mBehaviour = behaviour;
 }
 
-template <class T>
-float NXInterpolant<T>::GetPercentage( void )
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::SetPause( bool pause )
 {
-	if (abs(mDelta) > 0)
+	if (isTimed && pause != isPaused)
 	{
-		if (mEnd > mStart)
+		// The time spent paused does not count
+		const double now = NXInterpolantClock();
+		if (pause)
 		{
-			return (mValue - mStart) / mDelta;
+			mPauseTime = now;
 		}
 		else
 		{
-			return (mValue - mEnd) / mDelta;
+			mStartTime += now - mPauseTime;
 		}
 	}
-	else
-	{
-		return 1.0f;
-	}
+	isPaused = pause;
+}
+
+template <class T, class Ease>
+T NXInterpolant<T, Ease>::GetValue( void )
+{
+	return GetValueAt(GetElapsed());
+}
+
+template <class T, class Ease>
+float NXInterpolant<T, Ease>::GetPercentage( void )
+{
+	return GetWeightAt(GetElapsed());
 }
 
-template <class T>
-bool NXInterpolant<T>::IsPaused( void )
+template <class T, class Ease>
+bool NXInterpolant<T, Ease>::IsPaused( void )
 {
+	if (isTimed && mBehaviour == NXINTERPOLANT_ONCE)
+	{
+		return isPaused || GetElapsed() >= mRate;
+	}
 	return isPaused;
 }
 
-template <class T>
-void NXInterpolant<T>::Reset()
+template <class T, class Ease>
+void NXInterpolant<T, Ease>::Reset()
 {
-	mValue = mStart;
-	mDirection = 1;
+	mElapsed = 0.0f;
 	isPaused = false;
+	mStartTime = NXInterpolantClock();
 }
 
-#endif
\ No newline at end of file
+//Behaviour and easing fixed at compile time: Update and GetValue are straight arithmetic with
+//no branches on the behaviour. Start_To_End_Seconds must be positive.
+template <class T, class Wrap = NXWrapOnce, class Ease = NXEaseLinear>
+class NXEasedInterpolant
+{
+	public:
+		NXEasedInterpolant() : mPhase(0.0f), mSpeed(0.0f), mRate(0.0f) {}
+		NXEasedInterpolant(const T& start, const T& end, float Start_To_End_Seconds)
+		{
+			Init(start, end, Start_To_End_Seconds);
+		}
+
+		void Init(const T& start, const T& end, float Start_To_End_Seconds)
+		{
+			mStart = start;
+			mDelta = end - start;
+			mRate = 1.0f / Start_To_End_Seconds;
+			mSpeed = mRate;
+			mPhase = 0.0f;
+		}
+
+		void Update(float dt) { mPhase = Wrap::Advance(mPhase + mSpeed * dt); }
+		void Seek(float seconds) { mPhase = Wrap::Advance(seconds > 0.0f ? seconds * mRate : 0.0f); }
+		void SetCurrentPercentage(float percentage) { mPhase = Wrap::Advance(percentage); }
+		void SetPause( bool pause ) { mSpeed = pause ? 0.0f : mRate; }
+		void Reset() { mPhase = 0.0f; mSpeed = mRate; }
+
+		T GetValue( void ) const { return mStart + mDelta * Ease::Apply(Wrap::Weight(mPhase)); }
+		float GetPercentage( void ) const { return Wrap::Weight(mPhase); }
+		bool IsPaused( void ) const { return mSpeed == 0.0f || Wrap::IsFinished(mPhase); }
+
+	private:
+		T mStart;
+		T mDelta;
+		float mPhase;
+		float mSpeed;	//0 while paused
+		float mRate;	//1 / duration
+};
+
+#endif
@@ -0,0 +1,244 @@
+/**************************************************************************************************
+* \file	    NXKeyframeTrack.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Values keyed at several times, with an easing per segment\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXKEYFRAMETRACK_H_
+#define NXKEYFRAMETRACK_H_
+
+#include "NXInterpolant.h"
+#include <vector>
+#include <algorithm>
+
+//Shared, read only data of e.g. a camera move or a boss pattern. Each object playing it keeps
+//its own cursor (the segment it sampled last), so sampling forward in time is O(1) and only
+//jumps fall back to a binary search. T needs T + T, T - T and T * float.
+template <class T>
+class NXKeyframeTrack
+{
+	public:
+		NXKeyframeTrack( void ) {}
+
+		//Keys are kept sorted by time. The ease is for the segment from this key to the next.
+		void AddKey(float time, const T& value, NXEASE ease = NXEASE_LINEAR);
+		void Clear( void );
+
+		size_t GetKeyCount( void ) const { return mTimes.size(); }
+		float GetStartTime( void ) const { return mTimes.empty() ? 0.0f : mTimes.front(); }
+		float GetEndTime( void ) const { return mTimes.empty() ? 0.0f : mTimes.back(); }
+		float GetDuration( void ) const { return GetEndTime() - GetStartTime(); }
+
+		//Before the first key gives the first value, after the last the last value.
+		//The track must have at least one key.
+		T Evaluate(float time) const;
+		T Evaluate(float time, unsigned *cursor) const;
+
+		//Samples many times at once, e.g. every enemy running the same pattern
+		void EvaluateBatch(const float *times, unsigned *cursors, T *values, size_t count) const;
+
+	private:
+		unsigned FindSegment(float time, unsigned hint) const;
+		T EvaluateSegment(unsigned segment, float time) const;
+
+		std::vector<float> mTimes;
+		std::vector<T> mValues;
+		std::vector<T> mDeltas;				//Value of the next key - value of this key
+		std::vector<float> mInverseLengths;	//1 / segment length, 0 for a zero length segment
+		std::vector<unsigned char> mEases;
+};
+
+template <class T>
+void NXKeyframeTrack<T>::AddKey(float time, const T& value, NXEASE ease)
+{
+	const size_t index = std::upper_bound(mTimes.begin(), mTimes.end(), time) - mTimes.begin();
+	mTimes.insert(mTimes.begin() + index, time);
+	mValues.insert(mValues.begin() + index, value);
+	mEases.insert(mEases.begin() + index, (unsigned char)ease);
+
+	// A segment per key, the last one is never used
+	mDeltas.resize(mTimes.size(), value);
+	mInverseLengths.resize(mTimes.size(), 0.0f);
+	const size_t first = index > 0 ? index - 1 : 0;
+	for (size_t i = first; i + 1 < mTimes.size(); ++i)
+	{
+		const float length = mTimes[i + 1] - mTimes[i];
+		mDeltas[i] = mValues[i + 1] - mValues[i];
+		mInverseLengths[i] = length > 0.0f ? 1.0f / length : 0.0f;
+	}
+}
+
+template <class T>
+void NXKeyframeTrack<T>::Clear( void )
+{
+	mTimes.clear();
+	mValues.clear();
+	mDeltas.clear();
+	mInverseLengths.clear();
+	mEases.clear();
+}
+
+//Segment i covers [time i, time i + 1). Tries the hint and its neighbours before searching,
+//which covers every frame of playback forwards or backwards.
+template <class T>
+unsigned NXKeyframeTrack<T>::FindSegment(float time, unsigned hint) const
+{
+	const unsigned last = unsigned(mTimes.size()) - 1;
+	if (last == 0)
+	{
+		return 0;
+	}
+
+	if (hint < last && mTimes[hint] <= time)
+	{
+		if (time < mTimes[hint + 1] || hint + 1 == last)
+		{
+			return hint;
+		}
+		if (hint + 2 == last || (hint + 2 < last && time < mTimes[hint + 2]))
+		{
+			return hint + 1;
+		}
+	}
+	else if (hint < last && hint > 0 && mTimes[hint - 1] <= time)
+	{
+		return hint - 1;
+	}
+
+	const unsigned found = unsigned(std::upper_bound(mTimes.begin(), mTimes.end(), time) - mTimes.begin());
+	return found == 0 ? 0 : std::min(found - 1, last - 1);
+}
+
+template <class T>
+T NXKeyframeTrack<T>::EvaluateSegment(unsigned segment, float time) const
+{
+	float w = (time - mTimes[segment]) * mInverseLengths[segment];
+	if (!(mInverseLengths[segment] > 0.0f))
+	{
+		w = time < mTimes[segment] ? 0.0f : 1.0f;
+	}
+	w = w < 0.0f ? 0.0f : w > 1.0f ? 1.0f : w;
+
+	const NXEASE ease = NXEASE(mEases[segment]);
+	return mValues[segment] + mDeltas[segment] * (ease == NXEASE_LINEAR ? w : NXApplyEase(ease, w));
+}
+
+template <class T>
+T NXKeyframeTrack<T>::Evaluate(float time) const
+{
+	unsigned cursor = 0;
+	return Evaluate(time, &cursor);
+}
+
+template <class T>
+T NXKeyframeTrack<T>::Evaluate(float time, unsigned *cursor) const
+{
+	if (mTimes.size() == 1)
+	{
+		return mValues[0];
+	}
+	*cursor = FindSegment(time, *cursor);
+	return EvaluateSegment(*cursor, time);
+}
+
+template <class T>
+void NXKeyframeTrack<T>::EvaluateBatch(const float *times, unsigned *cursors, T *values, size_t count) const
+{
+	if (mTimes.size() == 1)
+	{
+		std::fill(values, values + count, mValues[0]);
+		return;
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		cursors[i] = FindSegment(times[i], cursors[i]);
+		values[i] = EvaluateSegment(cursors[i], times[i]);
+	}
+}
+
+//Plays a track over time with the same behaviours as NXInterpolant
+template <class T>
+class NXKeyframePlayer
+{
+	public:
+		NXKeyframePlayer( void ) : mTrack(0), mBehaviour(NXINTERPOLANT_ONCE), mTime(0.0f), mCursor(0), isPaused(false) {}
+
+		void Init(const NXKeyframeTrack<T> *track, NXINTERPOLANT_BEHAVIOUR behaviour)
+		{
+			mTrack = track;
+			mBehaviour = behaviour;
+			mCursor = 0;
+			isPaused = false;
+			Seek(0.0f);
+		}
+
+		void Update(float dt)
+		{
+			if (!isPaused)
+			{
+				Seek(mTime + dt);
+			}
+		}
+
+		void Seek(float seconds);
+		void SetPause( bool pause ) { isPaused = pause; }
+
+		const T& GetValue( void ) const { return mValue; }
+		float GetTime( void ) const { return mTime; }
+		bool IsFinished( void ) const
+		{
+			return mBehaviour == NXINTERPOLANT_ONCE && mTime >= mTrack->GetDuration();
+		}
+
+	private:
+		float GetTrackTime( void ) const;
+
+		const NXKeyframeTrack<T> *mTrack;
+		NXINTERPOLANT_BEHAVIOUR mBehaviour;
+		float mTime;			//Since the start, kept within one period
+		unsigned mCursor;
+		bool isPaused;
+		T mValue;
+};
+
+template <class T>
+void NXKeyframePlayer<T>::Seek(float seconds)
+{
+	const float duration = mTrack->GetDuration();
+	seconds = seconds > 0.0f ? seconds : 0.0f;
+	if (duration > 0.0f)
+	{
+		const float p = seconds / duration;
+		switch (mBehaviour)
+		{
+			case NXINTERPOLANT_LOOP:	seconds = NXWrapLoop::Advance(p) * duration; break;
+			case NXINTERPOLANT_ONCE:	seconds = NXWrapOnce::Advance(p) * duration; break;
+			default:					seconds = NXWrapCircular::Advance(p) * duration; break;
+		}
+	}
+	mTime = seconds;
+	mValue = mTrack->Evaluate(GetTrackTime(), &mCursor);
+}
+
+//Circular plays the second period backwards
+template <class T>
+float NXKeyframePlayer<T>::GetTrackTime( void ) const
+{
+	const float duration = mTrack->GetDuration();
+	const float t = mTime > duration ? 2.0f * duration - mTime : mTime;
+	return mTrack->GetStartTime() + t;
+}
+
+#endif
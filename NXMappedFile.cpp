@@ -0,0 +1,190 @@
+/**************************************************************************************************
+* \file	    NXMappedFile.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Copy on write memory mapped file, changes stay in memory\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXMappedFile.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+/**************************************************************************************************
+ * \fn	NXMappedFile::NXMappedFile( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXMappedFile::NXMappedFile( void ) :
+	mData(0),
+	mSize(0),
+#ifdef _WIN32
+	mFile(INVALID_HANDLE_VALUE),
+	mMapping(0)
+#else
+	mFile(-1)
+#endif
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXMappedFile::~NXMappedFile( void )
+ *
+ * \brief	Destructor, unmaps the file if it is still open.
+**************************************************************************************************/
+
+NXMappedFile::~NXMappedFile( void )
+{
+	Close();
+}
+
+/**************************************************************************************************
+ * \fn	bool NXMappedFile::Open(const char *FileName)
+ *
+ * \brief	Maps the whole file into memory. No data is read here, pages are brought in by the
+ * 			OS on first access.
+ *
+ * \param	FileName	Name of the file.
+ *
+ * \return	true if it succeeds, false if it fails.
+**************************************************************************************************/
+
+bool NXMappedFile::Open(const char *FileName)
+{
+	Close();
+
+#ifdef _WIN32
+	mFile = CreateFileA(FileName, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+						FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, 0);
+	if (mFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+	mSize = (size_t)size.QuadPart;
+
+	mMapping = CreateFileMappingA(mFile, 0, PAGE_WRITECOPY, 0, 0, 0);
+	if (mMapping == 0)
+	{
+		Close();
+		return false;
+	}
+
+	mData = MapViewOfFile(mMapping, FILE_MAP_COPY, 0, 0, 0);
+	if (mData == 0)
+	{
+		Close();
+		return false;
+	}
+#else
+	mFile = open(FileName, O_RDONLY);
+	if (mFile < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(mFile, &info) != 0 || info.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+	mSize = (size_t)info.st_size;
+
+	void *data = mmap(0, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, mFile, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+	mData = data;
+#endif
+
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	void NXMappedFile::Close( void )
+ *
+ * \brief	Unmaps the file and releases the handles.
+**************************************************************************************************/
+
+void NXMappedFile::Close( void )
+{
+#ifdef _WIN32
+	if (mData)
+	{
+		UnmapViewOfFile(mData);
+	}
+	if (mMapping)
+	{
+		CloseHandle(mMapping);
+	}
+	if (mFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mFile);
+	}
+	mMapping = 0;
+	mFile = INVALID_HANDLE_VALUE;
+#else
+	if (mData)
+	{
+		munmap(mData, mSize);
+	}
+	if (mFile >= 0)
+	{
+		close(mFile);
+	}
+	mFile = -1;
+#endif
+	mData = 0;
+	mSize = 0;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXMappedFile::GetModifiedTime(const char *FileName, time_t *Time)
+ *
+ * \brief	Gets the last modified time of a file.
+ *
+ * \param	FileName	Name of the file.
+ * \param [out]	Time	The modified time.
+ *
+ * \return	false if the file does not exist.
+**************************************************************************************************/
+
+bool NXMappedFile::GetModifiedTime(const char *FileName, time_t *Time)
+{
+	struct stat info;
+	if (stat(FileName, &info) != 0)
+	{
+		return false;
+	}
+
+	*Time = info.st_mtime;
+	return true;
+}
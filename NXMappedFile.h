@@ -0,0 +1,56 @@
+/**************************************************************************************************
+* \file	    NXMappedFile.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Copy on write memory mapped file, changes stay in memory\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXMAPPEDFILE_H_
+#define NXMAPPEDFILE_H_
+
+#include <cstddef>
+#include <ctime>
+
+class NXMappedFile
+{
+	public:
+		NXMappedFile( void );
+		~NXMappedFile( void );
+
+		bool Open(const char *FileName);
+		void Close( void );
+
+		//Pages are mapped copy on write, writing to them never touches the file
+		void * GetData( void ) const { return mData; }
+		size_t GetSize( void ) const { return mSize; }
+		bool IsOpen( void ) const { return mData != 0; }
+
+		static bool GetModifiedTime(const char *FileName, time_t *Time);
+
+	private:
+		//Not copyable, the mapping is owned
+		NXMappedFile(const NXMappedFile&);
+		NXMappedFile& operator=(const NXMappedFile&);
+
+		void *mData;
+		size_t mSize;
+#ifdef _WIN32
+		void *mFile;
+		void *mMapping;
+#else
+		int mFile;
+#endif
+};
+
+#endif
@@ -0,0 +1,579 @@
+/**************************************************************************************************
+* \file	    NXObjSnapshot.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	The state of every object pool and the tile map, saved and restored in bulk\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXObjSnapshot.h"
+#include "NXPoolTelemetry.h"
+#include "NXTileMap.h"
+#include "NXProfiler.h"
+#include "NXAssert.h"
+#include <cstdio>
+#include <cstring>
+
+static const size_t NXSNAPSHOT_STRING_SCAN = 16;	//Strings searched in order before using mStringIndex
+
+//Blob layout: header, pool table, records, string table, tile runs
+struct SnapshotHeader
+{
+	unsigned magic;
+	unsigned version;
+	unsigned recordSize;		//sizeof(NXGameObjRecord) and sizeof(wchar_t), so a blob from
+	unsigned charSize;			//another build is refused rather than misread
+	unsigned poolCount;
+	unsigned recordCount;
+	unsigned stringCount;
+	int tileWidth;
+	int tileHeight;
+	unsigned runCount;
+};
+
+struct SnapshotPool
+{
+	unsigned nameLength;		//Followed by the name
+	unsigned capacity;
+	unsigned first;
+	unsigned count;
+};
+
+static void Append(std::vector<char>& blob, const void *data, size_t size)
+{
+	if (size)
+	{
+		const char *bytes = static_cast<const char*>(data);
+		blob.insert(blob.end(), bytes, bytes + size);
+	}
+}
+
+//Reads in order from a blob, failing once past the end
+class BlobReader
+{
+	public:
+		BlobReader(const char *data, size_t size) : mData(data), mSize(size), mOffset(0) {}
+
+		bool Read(void *out, size_t size)
+		{
+			if (size > mSize - mOffset)
+			{
+				return false;
+			}
+			if (size)
+			{
+				memcpy(out, mData + mOffset, size);
+			}
+			mOffset += size;
+			return true;
+		}
+
+		bool IsAtEnd( void ) const { return mOffset == mSize; }
+
+	private:
+		const char *mData;
+		size_t mSize;
+		size_t mOffset;
+};
+
+/**************************************************************************************************
+ * \fn	NXObjSnapshot::NXObjSnapshot( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXObjSnapshot::NXObjSnapshot( void ) :
+	mTileWidth(0),
+	mTileHeight(0)
+{
+}
+
+/**************************************************************************************************
+ * \fn	void NXObjSnapshot::Clear( void )
+ *
+ * \brief	Empties the snapshot, keeping the memory for the next capture.
+**************************************************************************************************/
+
+void NXObjSnapshot::Clear( void )
+{
+	mPools.clear();
+	mRecords.clear();
+	mStrings.clear();
+	mStringIndex.clear();
+	mTileWidth = mTileHeight = 0;
+	mTileRuns.clear();
+}
+
+/**************************************************************************************************
+ * \fn	void NXObjSnapshot::Capture(const NXTileMap *map)
+ *
+ * \brief	Captures every pool and the cells of the map. The map keeps no copy of its cells
+ * 			from before they were edited, so all of them are kept, as runs of equal tiles.
+ *
+ * \param	map	The map, or null.
+**************************************************************************************************/
+
+void NXObjSnapshot::Capture(const NXTileMap *map)
+{
+	NX_PROFILE_ZONE("NXObjSnapshot::Capture");
+	Clear();
+
+	const std::vector<NXPoolTelemetry*>& pools = NXGetPools();
+	size_t capacity = 0;
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		capacity += pools[i]->GetLive();
+	}
+	mRecords.reserve(capacity);
+
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		pools[i]->CaptureObjects(*this);
+	}
+	mStringIndex.clear();
+
+	const int *cells = map && !map->IsStreaming() ? map->GetMapData() : 0;
+	if (cells == 0)
+	{
+		return;
+	}
+	mTileWidth = map->GetWidth();
+	mTileHeight = map->GetHeight();
+	const size_t total = size_t(mTileWidth) * size_t(mTileHeight);
+	for (size_t i = 0; i < total; )
+	{
+		TileRun run;
+		run.tile = cells[i];
+		run.count = 0;
+		for (; i < total && cells[i] == run.tile; ++i)
+		{
+			++run.count;
+		}
+		mTileRuns.push_back(run);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	bool NXObjSnapshot::Restore(NXTileMap *map)
+ *
+ * \brief	Puts every pool and the map back as captured.
+ *
+ * \param [in,out]	map	The map, or null to leave it as it is.
+ *
+ * \return	false if the pools registered now are not the ones captured or not the same size,
+ * 			or the map is not the same size. Pools are never resized here, objects outside
+ * 			hold pointers into them.
+**************************************************************************************************/
+
+bool NXObjSnapshot::Restore(NXTileMap *map)
+{
+	NX_PROFILE_ZONE("NXObjSnapshot::Restore");
+	const std::vector<NXPoolTelemetry*>& pools = NXGetPools();
+	if (pools.size() != mPools.size())
+	{
+		NX_MESG("NXObjSnapshot: The pools do not match the snapshot\n");
+		return false;
+	}
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		if (mPools[i].name != pools[i]->GetName())
+		{
+			NX_MESG("NXObjSnapshot: The pools do not match the snapshot\n");
+			return false;
+		}
+		if (mPools[i].capacity != pools[i]->GetCapacity())
+		{
+			NX_MESG("NXObjSnapshot: A pool was resized since the snapshot\n");
+			return false;
+		}
+	}
+
+	const bool hasTiles = map && !mTileRuns.empty();
+	if (hasTiles && (map->GetMapData() == 0 || map->IsStreaming() ||
+					 map->GetWidth() != mTileWidth || map->GetHeight() != mTileHeight))
+	{
+		NX_MESG("NXObjSnapshot: The map does not match the snapshot\n");
+		return false;
+	}
+
+	// Every pool is emptied first, so handles into any pool resolve while restoring
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		pools[i]->Free();
+	}
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		const PoolRange& range = mPools[i];
+		pools[i]->RestoreObjects(*this, range.count ? &mRecords[range.first] : 0, range.count);
+	}
+
+	if (hasTiles)
+	{
+		const int *cells = map->GetMapData();
+		map->BeginEdit();
+		size_t cell = 0;
+		for (size_t r = 0; r < mTileRuns.size(); ++r)
+		{
+			const TileRun& run = mTileRuns[r];
+			for (size_t end = cell + run.count; cell < end; ++cell)
+			{
+				if (cells[cell] != run.tile)
+				{
+					map->SetCellValue(int(cell % mTileWidth), int(cell / mTileWidth), run.tile);
+				}
+			}
+		}
+		map->EndEdit();
+	}
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	void NXObjSnapshot::BeginPool(const char *name, size_t capacity)
+ *
+ * \brief	Starts the records of the next pool.
+**************************************************************************************************/
+
+void NXObjSnapshot::BeginPool(const char *name, size_t capacity)
+{
+	PoolRange range;
+	range.name = name;
+	range.capacity = unsigned(capacity);
+	range.first = unsigned(mRecords.size());
+	range.count = 0;
+	mPools.push_back(range);
+}
+
+/**************************************************************************************************
+ * \fn	NXGameObjRecord& NXObjSnapshot::AddRecord( void )
+ *
+ * \brief	Adds a record to the current pool.
+**************************************************************************************************/
+
+NXGameObjRecord& NXObjSnapshot::AddRecord( void )
+{
+	NX_ASSERT(!mPools.empty());
+	++mPools.back().count;
+	mRecords.push_back(NXGameObjRecord());
+	return mRecords.back();
+}
+
+/**************************************************************************************************
+ * \fn	unsigned NXObjSnapshot::AddString(const std::wstring& text)
+ *
+ * \brief	Gets the index of a string in the table, adding it the first time.
+**************************************************************************************************/
+
+unsigned NXObjSnapshot::AddString(const std::wstring& text)
+{
+	// Levels use a handful of ids, a scan beats the map until there are many
+	if (mStrings.size() <= NXSNAPSHOT_STRING_SCAN)
+	{
+		for (size_t i = 0; i < mStrings.size(); ++i)
+		{
+			if (mStrings[i] == text)
+			{
+				return unsigned(i);
+			}
+		}
+		if (mStrings.size() < NXSNAPSHOT_STRING_SCAN)
+		{
+			mStrings.push_back(text);
+			return unsigned(mStrings.size() - 1);
+		}
+		// Moving to the map, index what was only scanned so far
+		for (size_t i = 0; i < mStrings.size(); ++i)
+		{
+			mStringIndex[mStrings[i]] = unsigned(i);
+		}
+	}
+	std::map<std::wstring, unsigned>::const_iterator found = mStringIndex.find(text);
+	if (found != mStringIndex.end())
+	{
+		return found->second;
+	}
+	const unsigned index = unsigned(mStrings.size());
+	mStrings.push_back(text);
+	mStringIndex[text] = index;
+	return index;
+}
+
+/**************************************************************************************************
+ * \fn	const std::wstring& NXObjSnapshot::GetString(unsigned index) const
+ *
+ * \brief	Gets a string of the table, empty if out of range.
+**************************************************************************************************/
+
+const std::wstring& NXObjSnapshot::GetString(unsigned index) const
+{
+	static const std::wstring empty;
+	return index < mStrings.size() ? mStrings[index] : empty;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXObjSnapshot::FindHandle(const NXGameObj *obj, int *pool, unsigned *slot) const
+ *
+ * \brief	Finds the pool and slot of an object.
+ *
+ * \return	false if no pool holds the object, the pool is then -1.
+**************************************************************************************************/
+
+bool NXObjSnapshot::FindHandle(const NXGameObj *obj, int *pool, unsigned *slot) const
+{
+	const std::vector<NXPoolTelemetry*>& pools = NXGetPools();
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		size_t found = 0;
+		if (pools[i]->FindPoolObject(obj, &found))
+		{
+			*pool = int(i);
+			*slot = unsigned(found);
+			return true;
+		}
+	}
+	*pool = -1;
+	*slot = 0;
+	return false;
+}
+
+/**************************************************************************************************
+ * \fn	NXGameObj* NXObjSnapshot::ResolveHandle(int pool, unsigned slot) const
+ *
+ * \brief	Gets the object at a pool and slot, null if there is none.
+**************************************************************************************************/
+
+NXGameObj* NXObjSnapshot::ResolveHandle(int pool, unsigned slot) const
+{
+	const std::vector<NXPoolTelemetry*>& pools = NXGetPools();
+	if (pool < 0 || size_t(pool) >= pools.size())
+	{
+		return 0;
+	}
+	return pools[pool]->GetPoolObject(slot);
+}
+
+/**************************************************************************************************
+ * \fn	void NXObjSnapshot::Write(std::vector<char>& blob) const
+ *
+ * \brief	Writes the snapshot as one blob, each table copied in one go.
+ *
+ * \param [out]	blob	The blob, replaced.
+**************************************************************************************************/
+
+void NXObjSnapshot::Write(std::vector<char>& blob) const
+{
+	NX_PROFILE_ZONE("NXObjSnapshot::Write");
+	SnapshotHeader header;
+	header.magic = NXSNAPSHOT_MAGIC;
+	header.version = NXSNAPSHOT_VERSION;
+	header.recordSize = sizeof(NXGameObjRecord);
+	header.charSize = sizeof(wchar_t);
+	header.poolCount = unsigned(mPools.size());
+	header.recordCount = unsigned(mRecords.size());
+	header.stringCount = unsigned(mStrings.size());
+	header.tileWidth = mTileWidth;
+	header.tileHeight = mTileHeight;
+	header.runCount = unsigned(mTileRuns.size());
+
+	size_t size = sizeof(header) + mRecords.size() * sizeof(NXGameObjRecord) + mTileRuns.size() * sizeof(TileRun);
+	for (size_t i = 0; i < mPools.size(); ++i)
+	{
+		size += sizeof(SnapshotPool) + mPools[i].name.size();
+	}
+	for (size_t i = 0; i < mStrings.size(); ++i)
+	{
+		size += sizeof(unsigned) + mStrings[i].size() * sizeof(wchar_t);
+	}
+	blob.clear();
+	blob.reserve(size);
+
+	Append(blob, &header, sizeof(header));
+	for (size_t i = 0; i < mPools.size(); ++i)
+	{
+		SnapshotPool pool;
+		pool.nameLength = unsigned(mPools[i].name.size());
+		pool.capacity = mPools[i].capacity;
+		pool.first = mPools[i].first;
+		pool.count = mPools[i].count;
+		Append(blob, &pool, sizeof(pool));
+		Append(blob, mPools[i].name.c_str(), mPools[i].name.size());
+	}
+	Append(blob, mRecords.empty() ? 0 : &mRecords[0], mRecords.size() * sizeof(NXGameObjRecord));
+	for (size_t i = 0; i < mStrings.size(); ++i)
+	{
+		const unsigned length = unsigned(mStrings[i].size());
+		Append(blob, &length, sizeof(length));
+		Append(blob, mStrings[i].c_str(), length * sizeof(wchar_t));
+	}
+	Append(blob, mTileRuns.empty() ? 0 : &mTileRuns[0], mTileRuns.size() * sizeof(TileRun));
+}
+
+/**************************************************************************************************
+ * \fn	bool NXObjSnapshot::Read(const char *data, size_t size)
+ *
+ * \brief	Reads a blob written by Write.
+ *
+ * \param	data	The blob.
+ * \param	size	Size of the blob in bytes.
+ *
+ * \return	false if the blob is from another version or build, or damaged. The snapshot is
+ * 			then empty.
+**************************************************************************************************/
+
+bool NXObjSnapshot::Read(const char *data, size_t size)
+{
+	NX_PROFILE_ZONE("NXObjSnapshot::Read");
+	Clear();
+	BlobReader reader(data, size);
+
+	SnapshotHeader header;
+	if (!reader.Read(&header, sizeof(header)) || header.magic != NXSNAPSHOT_MAGIC ||
+		header.version != NXSNAPSHOT_VERSION || header.recordSize != sizeof(NXGameObjRecord) ||
+		header.charSize != sizeof(wchar_t) || header.tileWidth < 0 || header.tileHeight < 0 ||
+		header.poolCount > size / sizeof(SnapshotPool) || header.recordCount > size / sizeof(NXGameObjRecord) ||
+		header.stringCount > size / sizeof(unsigned) || header.runCount > size / sizeof(TileRun))
+	{
+		NX_MESG("NXObjSnapshot: Snapshot is invalid or out of date!");
+		return false;
+	}
+
+	bool isValid = true;
+	mPools.resize(header.poolCount);
+	for (size_t i = 0; isValid && i < mPools.size(); ++i)
+	{
+		SnapshotPool pool;
+		isValid = reader.Read(&pool, sizeof(pool)) && pool.nameLength < size &&
+				  pool.first == (i ? mPools[i - 1].first + mPools[i - 1].count : 0) &&
+				  pool.count <= header.recordCount - pool.first;
+		if (isValid)
+		{
+			mPools[i].name.resize(pool.nameLength);
+			mPools[i].capacity = pool.capacity;
+			mPools[i].first = pool.first;
+			mPools[i].count = pool.count;
+			isValid = reader.Read(pool.nameLength ? &mPools[i].name[0] : 0, pool.nameLength);
+		}
+	}
+
+	if (isValid)
+	{
+		mRecords.resize(header.recordCount);
+		isValid = reader.Read(mRecords.empty() ? 0 : &mRecords[0], mRecords.size() * sizeof(NXGameObjRecord));
+	}
+	for (size_t i = 0; isValid && i < mPools.size(); ++i)
+	{
+		// Slots must be in order and within the pool
+		for (unsigned r = mPools[i].first; isValid && r < mPools[i].first + mPools[i].count; ++r)
+		{
+			isValid = mRecords[r].slot < mPools[i].capacity &&
+					  (r == mPools[i].first || mRecords[r - 1].slot < mRecords[r].slot);
+		}
+	}
+	isValid = isValid && (mPools.empty() || mPools.back().first + mPools.back().count == header.recordCount);
+
+	if (isValid)
+	{
+		mStrings.resize(header.stringCount);
+	}
+	for (size_t i = 0; isValid && i < mStrings.size(); ++i)
+	{
+		unsigned length = 0;
+		isValid = reader.Read(&length, sizeof(length)) && length <= size / sizeof(wchar_t);
+		if (isValid)
+		{
+			mStrings[i].resize(length);
+			isValid = reader.Read(length ? &mStrings[i][0] : 0, length * sizeof(wchar_t));
+		}
+	}
+
+	if (isValid)
+	{
+		mTileWidth = header.tileWidth;
+		mTileHeight = header.tileHeight;
+		mTileRuns.resize(header.runCount);
+		isValid = reader.Read(mTileRuns.empty() ? 0 : &mTileRuns[0], mTileRuns.size() * sizeof(TileRun)) &&
+				  reader.IsAtEnd();
+
+		size_t cells = 0;
+		for (size_t i = 0; isValid && i < mTileRuns.size(); ++i)
+		{
+			cells += mTileRuns[i].count;
+		}
+		isValid = isValid && (mTileRuns.empty() || cells == size_t(mTileWidth) * size_t(mTileHeight));
+	}
+
+	if (!isValid)
+	{
+		NX_MESG("NXObjSnapshot: Snapshot is invalid or out of date!");
+		Clear();
+	}
+	return isValid;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXObjSnapshot::Save(const char *FileName) const
+ *
+ * \brief	Writes the snapshot to a file.
+ *
+ * \param	FileName	Name of the file, replaced if it exists.
+ *
+ * \return	false if the file could not be written.
+**************************************************************************************************/
+
+bool NXObjSnapshot::Save(const char *FileName) const
+{
+	std::vector<char> blob;
+	Write(blob);
+
+	FILE *file = fopen(FileName, "wb");
+	if (file == 0)
+	{
+		NX_MESG("NXObjSnapshot: Unable to write the snapshot\n");
+		return false;
+	}
+	const bool isWritten = fwrite(&blob[0], 1, blob.size(), file) == blob.size();
+	fclose(file);
+	return isWritten;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXObjSnapshot::Load(const char *FileName)
+ *
+ * \brief	Reads a snapshot written by Save.
+ *
+ * \param	FileName	Name of the file.
+ *
+ * \return	false if the file is missing or not a valid snapshot.
+**************************************************************************************************/
+
+bool NXObjSnapshot::Load(const char *FileName)
+{
+	FILE *file = fopen(FileName, "rb");
+	if (file == 0)
+	{
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	std::vector<char> blob(size > 0 ? size_t(size) : 0);
+	const bool isRead = !blob.empty() && fread(&blob[0], 1, blob.size(), file) == blob.size();
+	fclose(file);
+	if (!isRead)
+	{
+		Clear();
+		return false;
+	}
+	return Read(&blob[0], blob.size());
+}
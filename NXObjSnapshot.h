@@ -0,0 +1,141 @@
+/**************************************************************************************************
+* \file	    NXObjSnapshot.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	The state of every object pool and the tile map, saved and restored in bulk\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXOBJSNAPSHOT_H_
+#define NXOBJSNAPSHOT_H_
+
+#include "NXMaths.h"
+#include "NXGraphicEngine.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class NXGameObj;
+class NXTileMap;
+
+const unsigned NXSNAPSHOT_MAGIC = 0x5353584E;	//"NXSS"
+const unsigned NXSNAPSHOT_VERSION = 1;			//Change whenever NXGameObjRecord or the layout changes
+
+enum NXRECORD_FLAG
+{
+	NXRECORD_COLOR_MODULATING	= 1 << 0,
+	NXRECORD_Z_WRITING			= 1 << 1,
+	NXRECORD_ADDITIVE_BLEND		= 1 << 2,
+	NXRECORD_ANIMATION_LOOPING	= 1 << 3,
+	NXRECORD_ANIMATION_PAUSED	= 1 << 4,
+	NXRECORD_HORIZONTAL_FLIP	= 1 << 5,
+	NXRECORD_VERTICAL_FLIP		= 1 << 6,
+	NXRECORD_VISIBLE			= 1 << 7,
+	NXRECORD_DEBUG_INFO			= 1 << 8
+};
+
+//One alive object, plain data so a pool's records are copied in one go.
+//Strings are indices into the snapshot's string table.
+struct NXGameObjRecord
+{
+	unsigned slot;				//Index in the pool
+	unsigned flags;				//NXRECORD_FLAG
+	unsigned userFlags;			//NXGameObj::flag
+	int type;					//Left to derived classes, GameObj keeps its ObjType here
+	Vec3 pos;
+	Vec3 offset;
+	Vec3 scale;
+	Vec3 vel;
+	Vec3 endForce;
+	float pitch, yaw, roll;
+	Vec3 aabbMinPercent;
+	Vec3 aabbMaxPercent;
+	int layer;
+	float parallaxScale;
+	NXCOLOR color;
+	unsigned meshID;
+	unsigned spriteID;
+	unsigned animation;
+	unsigned cellNo;
+	unsigned maxCellNo;
+	float animationTime;
+	float maxAnimationTime;
+	float lifetimeStarting;
+	float lifetime;
+	float physicsTime;
+	int followPool;				//-1 if not following another object
+	unsigned followSlot;
+	Vec3 followOffset;
+};
+
+//Every registered pool (see NXPoolTelemetry) and the cells of a tile map. Capture and Restore
+//work in memory, e.g. for a quick restart; Save and Load write the same thing as one versioned
+//blob. Pointers between objects are kept as a pool and a slot.
+class NXObjSnapshot
+{
+	public:
+		NXObjSnapshot( void );
+
+		void Clear( void );
+
+		//Replaces what is held. The map may be null, or streamed, to leave tiles out.
+		void Capture(const NXTileMap *map);
+		//Every pool is emptied and refilled in place, so pointers kept into a pool still see
+		//the object of the same slot. Objects restart their Init before getting their
+		//records, anything else a derived class holds keeps its Init values. Tiles that
+		//differ are edited back in one batch.
+		//false if the pools, their sizes or the map no longer match, nothing is changed then.
+		bool Restore(NXTileMap *map);
+
+		void Write(std::vector<char>& blob) const;
+		bool Read(const char *data, size_t size);
+		bool Save(const char *FileName) const;
+		bool Load(const char *FileName);
+
+		size_t GetObjectCount( void ) const { return mRecords.size(); }
+
+		//For the pools while capturing
+		void BeginPool(const char *name, size_t capacity);
+		NXGameObjRecord& AddRecord( void );
+		unsigned AddString(const std::wstring& text);
+		bool FindHandle(const NXGameObj *obj, int *pool, unsigned *slot) const;
+
+		//For the pools while restoring
+		const std::wstring& GetString(unsigned index) const;
+		NXGameObj* ResolveHandle(int pool, unsigned slot) const;
+
+	private:
+		struct PoolRange
+		{
+			std::string name;
+			unsigned capacity;
+			unsigned first;		//Into mRecords
+			unsigned count;
+		};
+
+		struct TileRun
+		{
+			int tile;
+			unsigned count;
+		};
+
+		std::vector<PoolRange> mPools;
+		std::vector<NXGameObjRecord> mRecords;
+		std::vector<std::wstring> mStrings;
+		std::map<std::wstring, unsigned> mStringIndex;	//Only while capturing
+		int mTileWidth;
+		int mTileHeight;
+		std::vector<TileRun> mTileRuns;
+};
+
+#endif
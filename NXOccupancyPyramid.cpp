@@ -0,0 +1,197 @@
+/**************************************************************************************************
+* \file	    NXOccupancyPyramid.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Empty/full/mixed summary of blocks of the collision grid\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXOccupancyPyramid.h"
+#include <algorithm>
+
+/**************************************************************************************************
+ * \fn	NXOccupancyPyramid::NXOccupancyPyramid( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXOccupancyPyramid::NXOccupancyPyramid( void )
+{
+	for (int i = 0; i < NXOCCUPANCY_LEVELS - 1; ++i)
+	{
+		mWidth[i] = mHeight[i] = 0;
+	}
+}
+
+/**************************************************************************************************
+ * \fn	NXOccupancyPyramid::~NXOccupancyPyramid( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXOccupancyPyramid::~NXOccupancyPyramid( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void NXOccupancyPyramid::Build(const NXBitGrid& Grid)
+ *
+ * \brief	Builds every level from the collision grid.
+ *
+ * \param	Grid	The collision grid.
+**************************************************************************************************/
+
+void NXOccupancyPyramid::Build(const NXBitGrid& Grid)
+{
+	Free();
+	if (Grid.GetWidth() <= 0 || Grid.GetHeight() <= 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < NXOCCUPANCY_LEVELS - 1; ++i)
+	{
+		const int S = NXOCCUPANCY_BLOCK_SIZE[i + 1];
+		mWidth[i] = (Grid.GetWidth() + S - 1) / S;
+		mHeight[i] = (Grid.GetHeight() + S - 1) / S;
+		mLevels[i].assign(size_t(mWidth[i]) * mHeight[i], NXOCCUPANCY_MIXED);
+	}
+
+	BuildBlocks(Grid, 0, 0, mWidth[0] - 1, mHeight[0] - 1);
+	BuildSuperBlocks(0, 0, mWidth[1] - 1, mHeight[1] - 1);
+}
+
+/**************************************************************************************************
+ * \fn	void NXOccupancyPyramid::Update(const NXBitGrid& Grid, int X0, int Y0, int X1, int Y1)
+ *
+ * \brief	Refreshes the blocks holding a rectangle of cells (inclusive) after they were edited.
+**************************************************************************************************/
+
+void NXOccupancyPyramid::Update(const NXBitGrid& Grid, int X0, int Y0, int X1, int Y1)
+{
+	if (!IsBuilt())
+	{
+		return;
+	}
+
+	X0 = std::max(X0, 0);
+	Y0 = std::max(Y0, 0);
+	X1 = std::min(X1, Grid.GetWidth() - 1);
+	Y1 = std::min(Y1, Grid.GetHeight() - 1);
+	if (X0 > X1 || Y0 > Y1)
+	{
+		return;
+	}
+
+	const int S1 = NXOCCUPANCY_BLOCK_SIZE[1], S2 = NXOCCUPANCY_BLOCK_SIZE[2];
+	BuildBlocks(Grid, X0 / S1, Y0 / S1, X1 / S1, Y1 / S1);
+	BuildSuperBlocks(X0 / S2, Y0 / S2, X1 / S2, Y1 / S2);
+}
+
+/**************************************************************************************************
+ * \fn	void NXOccupancyPyramid::Free( void )
+ *
+ * \brief	Releases every level.
+**************************************************************************************************/
+
+void NXOccupancyPyramid::Free( void )
+{
+	for (int i = 0; i < NXOCCUPANCY_LEVELS - 1; ++i)
+	{
+		std::vector<unsigned char>().swap(mLevels[i]);
+		mWidth[i] = mHeight[i] = 0;
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXOccupancyPyramid::BuildBlocks(const NXBitGrid& Grid, int BX0, int BY0, int BX1,
+ * 			int BY1)
+ *
+ * \brief	Classifies a range of level 1 blocks (inclusive) from the cells. Rows of a block are
+ * 			tested with the grid's span queries rather than cell by cell.
+**************************************************************************************************/
+
+void NXOccupancyPyramid::BuildBlocks(const NXBitGrid& Grid, int BX0, int BY0, int BX1, int BY1)
+{
+	const int S = NXOCCUPANCY_BLOCK_SIZE[1];
+
+	for (int by = BY0; by <= BY1; ++by)
+	{
+		for (int bx = BX0; bx <= BX1; ++bx)
+		{
+			const int x0 = bx * S, x1 = std::min(x0 + S, Grid.GetWidth()) - 1;
+			const int y0 = by * S, y1 = std::min(y0 + S, Grid.GetHeight()) - 1;
+			bool hasSolid = false, hasEmpty = false;
+
+			for (int y = y0; y <= y1 && !(hasSolid && hasEmpty); ++y)
+			{
+				const int first = Grid.FindFirstInRow(y, x0, x1);
+				if (first < 0)
+				{
+					hasEmpty = true;
+					continue;
+				}
+				hasSolid = true;
+
+				// A row is full if its solid cells run unbroken from x0 to x1
+				if (first != x0 || Grid.FindLastInRow(y, x0, x1) != x1)
+				{
+					hasEmpty = true;
+					continue;
+				}
+				for (int x = x0 + 1; x < x1 && !hasEmpty; ++x)
+				{
+					hasEmpty = !Grid.Get(x, y);
+				}
+			}
+
+			mLevels[0][bx + by * mWidth[0]] = (unsigned char)
+				(!hasSolid ? NXOCCUPANCY_EMPTY : !hasEmpty ? NXOCCUPANCY_FULL : NXOCCUPANCY_MIXED);
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXOccupancyPyramid::BuildSuperBlocks(int BX0, int BY0, int BX1, int BY1)
+ *
+ * \brief	Classifies a range of level 2 blocks (inclusive) from the level 1 blocks in them.
+**************************************************************************************************/
+
+void NXOccupancyPyramid::BuildSuperBlocks(int BX0, int BY0, int BX1, int BY1)
+{
+	const int R = NXOCCUPANCY_BLOCK_SIZE[2] / NXOCCUPANCY_BLOCK_SIZE[1];
+
+	for (int by = BY0; by <= BY1; ++by)
+	{
+		for (int bx = BX0; bx <= BX1; ++bx)
+		{
+			const int x1 = std::min((bx + 1) * R, mWidth[0]);
+			const int y1 = std::min((by + 1) * R, mHeight[0]);
+			const unsigned char first = mLevels[0][bx * R + by * R * mWidth[0]];
+			unsigned char state = first;
+
+			for (int y = by * R; y < y1 && state != NXOCCUPANCY_MIXED; ++y)
+			{
+				for (int x = bx * R; x < x1; ++x)
+				{
+					if (mLevels[0][x + y * mWidth[0]] != first)
+					{
+						state = NXOCCUPANCY_MIXED;
+						break;
+					}
+				}
+			}
+			mLevels[1][bx + by * mWidth[1]] = state;
+		}
+	}
+}
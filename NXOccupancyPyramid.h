@@ -0,0 +1,88 @@
+/**************************************************************************************************
+* \file	    NXOccupancyPyramid.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Empty/full/mixed summary of blocks of the collision grid\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXOCCUPANCYPYRAMID_H_
+#define NXOCCUPANCYPYRAMID_H_
+
+#include "NXBitGrid.h"
+#include <vector>
+
+enum NXOCCUPANCY
+{
+	NXOCCUPANCY_EMPTY = 0,
+	NXOCCUPANCY_FULL,
+	NXOCCUPANCY_MIXED
+};
+
+//Level 0 is the cells themselves, each level above groups 8x8 nodes of the one below
+const int NXOCCUPANCY_LEVELS = 3;
+const int NXOCCUPANCY_BLOCK_SIZE[NXOCCUPANCY_LEVELS] = { 1, 8, 64 };
+
+class NXOccupancyPyramid
+{
+	public:
+		NXOccupancyPyramid( void );
+		~NXOccupancyPyramid( void );
+
+		void Build(const NXBitGrid& Grid);
+		void Update(const NXBitGrid& Grid, int X0, int Y0, int X1, int Y1);
+		void Free( void );
+
+		bool IsBuilt( void ) const { return !mLevels[0].empty(); }
+
+		//State of the block of a level (1 or 2) holding a cell, cells outside the map are
+		//ignored. Mixed when the pyramid is not built.
+		NXOCCUPANCY GetState(int Level, int X, int Y) const;
+
+		//Largest level whose block holding the cell is empty, 0 if none
+		int GetEmptyLevel(int X, int Y) const;
+
+	private:
+		void BuildBlocks(const NXBitGrid& Grid, int BX0, int BY0, int BX1, int BY1);
+		void BuildSuperBlocks(int BX0, int BY0, int BX1, int BY1);
+
+		//Index 0 holds level 1
+		std::vector<unsigned char> mLevels[NXOCCUPANCY_LEVELS - 1];
+		int mWidth[NXOCCUPANCY_LEVELS - 1];
+		int mHeight[NXOCCUPANCY_LEVELS - 1];
+};
+
+inline NXOCCUPANCY NXOccupancyPyramid::GetState(int Level, int X, int Y) const
+{
+	const std::vector<unsigned char>& level = mLevels[Level - 1];
+	if (level.empty())
+	{
+		return NXOCCUPANCY_MIXED;
+	}
+	const int S = NXOCCUPANCY_BLOCK_SIZE[Level];
+	return NXOCCUPANCY(level[(X / S) + (Y / S) * mWidth[Level - 1]]);
+}
+
+inline int NXOccupancyPyramid::GetEmptyLevel(int X, int Y) const
+{
+	for (int level = NXOCCUPANCY_LEVELS - 1; level > 0; --level)
+	{
+		if (GetState(level, X, Y) == NXOCCUPANCY_EMPTY)
+		{
+			return level;
+		}
+	}
+	return 0;
+}
+
+#endif
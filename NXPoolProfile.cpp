@@ -0,0 +1,237 @@
+/**************************************************************************************************
+* \file	    NXPoolProfile.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Pool sizes per level, from the high water marks of earlier play sessions\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXPoolProfile.h"
+#include "NXPoolTelemetry.h"
+#include "NXAssert.h"
+#include "tinyxml.h"
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+
+typedef std::map<std::string, unsigned> PoolMarks;
+static std::map<std::string, PoolMarks> profile;
+
+/**************************************************************************************************
+ * \fn	static void WriteEscaped(FILE *file, const char *text)
+ *
+ * \brief	Writes text for an attribute value. Type names can hold < and >.
+**************************************************************************************************/
+
+static void WriteEscaped(FILE *file, const char *text)
+{
+	for (; *text; ++text)
+	{
+		switch (*text)
+		{
+			case '&':	fputs("&amp;", file); break;
+			case '<':	fputs("&lt;", file); break;
+			case '>':	fputs("&gt;", file); break;
+			case '"':	fputs("&quot;", file); break;
+			default:	fputc(*text, file); break;
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	bool NXLoadPoolProfile(const char *FileName)
+ *
+ * \brief	Replaces the profile with the one in a file.
+ *
+ * \param	FileName	Name of the file.
+ *
+ * \return	false if the file is missing or not a profile, the profile is then empty.
+**************************************************************************************************/
+
+bool NXLoadPoolProfile(const char *FileName)
+{
+	profile.clear();
+
+	TiXmlDocument doc;
+	if (!doc.LoadFile(FileName))
+	{
+		return false;
+	}
+	TiXmlElement *root = doc.FirstChildElement("PoolProfile");
+	if (root == 0)
+	{
+		NX_MESG("Pool profile is invalid!");
+		doc.Clear();
+		return false;
+	}
+
+	for (TiXmlElement *level = root->FirstChildElement("Level"); level; level = level->NextSiblingElement("Level"))
+	{
+		const char *levelName = level->Attribute("Name");
+		if (levelName == 0)
+		{
+			continue;
+		}
+		PoolMarks& marks = profile[levelName];
+		for (TiXmlElement *pool = level->FirstChildElement("Pool"); pool; pool = pool->NextSiblingElement("Pool"))
+		{
+			const char *poolName = pool->Attribute("Name");
+			int highWater = 0;
+			if (poolName && pool->QueryIntAttribute("HighWater", &highWater) == TIXML_SUCCESS && highWater >= 0)
+			{
+				marks[poolName] = unsigned(highWater);
+			}
+		}
+	}
+	doc.Clear();
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXSavePoolProfile(const char *FileName)
+ *
+ * \brief	Writes the profile.
+ *
+ * \param	FileName	Name of the file, replaced if it exists.
+ *
+ * \return	false if the file could not be written.
+**************************************************************************************************/
+
+bool NXSavePoolProfile(const char *FileName)
+{
+	FILE *file = fopen(FileName, "w");
+	if (file == 0)
+	{
+		NX_MESG("Unable to write the pool profile!");
+		return false;
+	}
+
+	fprintf(file, "<PoolProfile>\n");
+	for (std::map<std::string, PoolMarks>::const_iterator level = profile.begin(); level != profile.end(); ++level)
+	{
+		fprintf(file, "<Level Name=\"");
+		WriteEscaped(file, level->first.c_str());
+		fprintf(file, "\">\n");
+		for (PoolMarks::const_iterator pool = level->second.begin(); pool != level->second.end(); ++pool)
+		{
+			fprintf(file, "<Pool Name=\"");
+			WriteEscaped(file, pool->first.c_str());
+			fprintf(file, "\" HighWater=\"%u\"/>\n", pool->second);
+		}
+		fprintf(file, "</Level>\n");
+	}
+	fprintf(file, "</PoolProfile>\n");
+	fclose(file);
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	void NXClearPoolProfile( void )
+ *
+ * \brief	Forgets every level.
+**************************************************************************************************/
+
+void NXClearPoolProfile( void )
+{
+	profile.clear();
+}
+
+/**************************************************************************************************
+ * \fn	static size_t ProfiledSize(unsigned highWater, float headroom)
+ *
+ * \brief	The pool size for a high water mark.
+**************************************************************************************************/
+
+static size_t ProfiledSize(unsigned highWater, float headroom)
+{
+	const size_t size = size_t(std::ceil(highWater * (headroom > 1.0f ? headroom : 1.0f)));
+	return size > NXPOOL_MIN_SIZE ? size : NXPOOL_MIN_SIZE;
+}
+
+/**************************************************************************************************
+ * \fn	size_t NXGetPoolProfileSize(const char *level, const char *pool, size_t fallback)
+ *
+ * \brief	Gets the size to give a pool, e.g. to construct it with.
+ *
+ * \param	level   	The level.
+ * \param	pool		Name of the pool.
+ * \param	fallback	Size if the pool was never recorded in the level.
+**************************************************************************************************/
+
+size_t NXGetPoolProfileSize(const char *level, const char *pool, size_t fallback)
+{
+	std::map<std::string, PoolMarks>::const_iterator marks = profile.find(level);
+	if (marks == profile.end())
+	{
+		return fallback;
+	}
+	PoolMarks::const_iterator mark = marks->second.find(pool);
+	return mark == marks->second.end() ? fallback : ProfiledSize(mark->second, NXPOOL_HEADROOM);
+}
+
+/**************************************************************************************************
+ * \fn	void NXPresizePools(const char *level, float headroom)
+ *
+ * \brief	Resizes every pool recorded in the level to its high water plus headroom.
+ *
+ * \param	level   	The level being loaded.
+ * \param	headroom	Size over the high water, 1 for none.
+**************************************************************************************************/
+
+void NXPresizePools(const char *level, float headroom)
+{
+	const std::vector<NXPoolTelemetry*>& pools = NXGetPools();
+	std::map<std::string, PoolMarks>::const_iterator marks = profile.find(level);
+
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		if (marks != profile.end())
+		{
+			PoolMarks::const_iterator mark = marks->second.find(pools[i]->GetName());
+			if (mark != marks->second.end())
+			{
+				const size_t size = ProfiledSize(mark->second, headroom);
+				if (size != pools[i]->GetCapacity())
+				{
+					pools[i]->Resize(size);
+				}
+			}
+		}
+		pools[i]->ResetPeaks();
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXRecordPoolProfile(const char *level)
+ *
+ * \brief	Records the high water of every pool in the level, before its objects are freed.
+ * 			A pool that ran out of room needed at least its most failed spawns in one frame more.
+ *
+ * \param	level	The level being played.
+**************************************************************************************************/
+
+void NXRecordPoolProfile(const char *level)
+{
+	// The last frame may not have been sampled
+	NXSampleTelemetry();
+
+	PoolMarks& marks = profile[level];
+	const std::vector<NXPoolTelemetry*>& pools = NXGetPools();
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		const unsigned needed = pools[i]->GetHighWater() + pools[i]->GetPeakFailed();
+		unsigned& mark = marks[pools[i]->GetName()];
+		mark = mark > needed ? mark : needed;
+	}
+}
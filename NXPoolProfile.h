@@ -0,0 +1,47 @@
+/**************************************************************************************************
+* \file	    NXPoolProfile.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Pool sizes per level, from the high water marks of earlier play sessions\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXPOOLPROFILE_H_
+#define NXPOOLPROFILE_H_
+
+#include <cstddef>
+
+const char *const NXPOOL_PROFILE_FILE = "PoolProfile.xml";
+const float NXPOOL_HEADROOM = 1.25f;	//Presized pools hold this much more than the recorded high water
+const size_t NXPOOL_MIN_SIZE = 16;		//Smallest presized pool
+
+//Recorded by builds with NX_RECORD_POOLS defined, read by every build.
+//The profile is a list of levels, each with the high water mark of every pool by name:
+//<PoolProfile><Level Name=""><Pool Name="" HighWater=""/></Level></PoolProfile>
+//Pools sharing a name share an entry, so give pools of the same type a name.
+bool NXLoadPoolProfile(const char *FileName);
+bool NXSavePoolProfile(const char *FileName);
+void NXClearPoolProfile( void );
+
+//The recorded high water with headroom, fallback if the level or pool was never recorded
+size_t NXGetPoolProfileSize(const char *level, const char *pool, size_t fallback);
+
+//Resizes every recorded pool of the level, when the level loads and nothing is alive. Pools
+//without a record keep their size. Also restarts the high water marks for NXRecordPoolProfile.
+void NXPresizePools(const char *level, float headroom = NXPOOL_HEADROOM);
+
+//Keeps the larger of the recorded and the current high water of every pool, counting spawns
+//that failed for lack of room. Needs NXSampleTelemetry every frame of the level.
+void NXRecordPoolProfile(const char *level);
+
+#endif
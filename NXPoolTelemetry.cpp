@@ -0,0 +1,256 @@
+/**************************************************************************************************
+* \file	    NXPoolTelemetry.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Occupancy, spawn and memory figures of every object pool, sampled each frame\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXPoolTelemetry.h"
+#include "NXAssert.h"
+#include <algorithm>
+#include <cstdarg>
+
+//Pools are often globals, so the list has to exist before the first one is constructed
+static std::vector<NXPoolTelemetry*>& GetPools( void )
+{
+	static std::vector<NXPoolTelemetry*> pools;
+	return pools;
+}
+
+static unsigned telemetryFrame = 0;
+static unsigned typeCounts[NXTELEMETRY_TYPES];
+
+/**************************************************************************************************
+ * \fn	NXPoolTelemetry::NXPoolTelemetry(const char *name)
+ *
+ * \brief	Registers a pool.
+ *
+ * \param	name	Shown in the dumps, must outlive the pool.
+**************************************************************************************************/
+
+NXPoolTelemetry::NXPoolTelemetry(const char *name) :
+	mName(name),
+	mLive(0),
+	mHighWater(0),
+	mLiveBound(0),
+	mSpawned(0),
+	mFailed(0),
+	mTotalFailed(0),
+	mPeakFailed(0),
+	mHistoryCount(0)
+{
+	GetPools().push_back(this);
+}
+
+/**************************************************************************************************
+ * \fn	NXPoolTelemetry::~NXPoolTelemetry( void )
+ *
+ * \brief	Unregisters the pool.
+**************************************************************************************************/
+
+NXPoolTelemetry::~NXPoolTelemetry( void )
+{
+	std::vector<NXPoolTelemetry*>& pools = GetPools();
+	pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+}
+
+/**************************************************************************************************
+ * \fn	void NXPoolTelemetry::Sample(unsigned frame, unsigned *typeCounts)
+ *
+ * \brief	Counts the pool and adds a sample. Objects are destroyed without telling the pool,
+ * 			so destroys are worked out from the change in live count.
+ *
+ * \param	frame				The frame number.
+ * \param [in,out]	typeCounts	Live objects per type, added to.
+**************************************************************************************************/
+
+void NXPoolTelemetry::Sample(unsigned frame, unsigned *typeCounts)
+{
+	const unsigned live = unsigned(CountAlive(typeCounts));
+	const unsigned before = mLive + mSpawned;
+
+	NXPoolSample sample;
+	sample.frame = frame;
+	sample.live = live;
+	sample.spawned = mSpawned;
+	sample.destroyed = before > live ? before - live : 0;
+	sample.failed = mFailed;
+
+	if (mHistory.size() < NXTELEMETRY_HISTORY)
+	{
+		mHistory.push_back(sample);
+	}
+	else
+	{
+		mHistory[mHistoryCount % NXTELEMETRY_HISTORY] = sample;
+	}
+	++mHistoryCount;
+
+	mLive = live;
+	mLiveBound = live;
+	mHighWater = std::max(mHighWater, live);
+	mPeakFailed = std::max(mPeakFailed, mFailed);
+	mSpawned = 0;
+	mFailed = 0;
+}
+
+/**************************************************************************************************
+ * \fn	void NXPoolTelemetry::OnSpawn( void )
+ *
+ * \brief	Counts a spawn and raises the high water, so objects that spawn and die between two
+ * 			samples are not missed. Deaths are only seen when the pool is counted again, until
+ * 			then the high water can be over by the objects that died, never under.
+**************************************************************************************************/
+
+void NXPoolTelemetry::OnSpawn( void )
+{
+	++mSpawned;
+	++mLiveBound;
+	mHighWater = std::max(mHighWater, std::min(mLiveBound, unsigned(GetCapacity())));
+}
+
+/**************************************************************************************************
+ * \fn	void NXPoolTelemetry::GetHistory(std::vector<NXPoolSample>& samples) const
+ *
+ * \brief	Gets the samples kept, oldest first.
+**************************************************************************************************/
+
+void NXPoolTelemetry::GetHistory(std::vector<NXPoolSample>& samples) const
+{
+	samples.clear();
+	const size_t first = mHistoryCount > NXTELEMETRY_HISTORY ? mHistoryCount - NXTELEMETRY_HISTORY : 0;
+	for (size_t i = first; i < mHistoryCount; ++i)
+	{
+		samples.push_back(mHistory[i % NXTELEMETRY_HISTORY]);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXPoolTelemetry::Message(const char *format, ...) const
+ *
+ * \brief	Formats a message and hands it to NX_MESG, truncated to 256 characters.
+ *
+ * \param	format	printf style format, followed by its arguments.
+**************************************************************************************************/
+
+void NXPoolTelemetry::Message(const char *format, ...) const
+{
+	char message[256];
+	va_list args;
+	va_start(args, format);
+#ifdef _MSC_VER
+	_vsnprintf_s(message, sizeof(message), _TRUNCATE, format, args);
+#else
+	vsnprintf(message, sizeof(message), format, args);
+#endif
+	va_end(args);
+	NX_MESG(message);
+}
+
+/**************************************************************************************************
+ * \fn	const std::vector<NXPoolTelemetry*>& NXGetPools( void )
+ *
+ * \brief	Gets every registered pool.
+**************************************************************************************************/
+
+const std::vector<NXPoolTelemetry*>& NXGetPools( void )
+{
+	return GetPools();
+}
+
+/**************************************************************************************************
+ * \fn	void NXSampleTelemetry( void )
+ *
+ * \brief	Samples every pool and the live count of each object type.
+**************************************************************************************************/
+
+void NXSampleTelemetry( void )
+{
+	std::fill(typeCounts, typeCounts + NXTELEMETRY_TYPES, 0u);
+
+	std::vector<NXPoolTelemetry*>& pools = GetPools();
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		pools[i]->Sample(telemetryFrame, typeCounts);
+	}
+	++telemetryFrame;
+}
+
+/**************************************************************************************************
+ * \fn	void NXDumpTelemetry(FILE *file)
+ *
+ * \brief	Writes the current figures of every pool and type as comma separated lines.
+ *
+ * \param [in]	file	The file, e.g. stdout.
+**************************************************************************************************/
+
+void NXDumpTelemetry(FILE *file)
+{
+	fprintf(file, "pool,live,high_water,capacity,spawns_per_frame,destroys_per_frame,failed_spawns,object_bytes,footprint_bytes\n");
+
+	std::vector<NXPoolSample> samples;
+	std::vector<NXPoolTelemetry*>& pools = GetPools();
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		const NXPoolTelemetry& pool = *pools[i];
+		pool.GetHistory(samples);
+
+		double spawned = 0.0, destroyed = 0.0;
+		for (size_t s = 0; s < samples.size(); ++s)
+		{
+			spawned += samples[s].spawned;
+			destroyed += samples[s].destroyed;
+		}
+		const double count = samples.empty() ? 1.0 : double(samples.size());
+
+		fprintf(file, "%s,%u,%u,%u,%.2f,%.2f,%u,%u,%u\n", pool.GetName(), pool.GetLive(), pool.GetHighWater(),
+				unsigned(pool.GetCapacity()), spawned / count, destroyed / count, pool.GetTotalFailed(),
+				unsigned(pool.GetObjectSize()), unsigned(pool.GetFootprint()));
+	}
+
+	fprintf(file, "\ntype,live\n");
+	for (int t = 0; t < NXTELEMETRY_TYPES; ++t)
+	{
+		if (typeCounts[t])
+		{
+			fprintf(file, "%d,%u\n", t, typeCounts[t]);
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXDumpTelemetryHistory(FILE *file)
+ *
+ * \brief	Writes every sample kept as comma separated lines.
+ *
+ * \param [in]	file	The file, e.g. stdout.
+**************************************************************************************************/
+
+void NXDumpTelemetryHistory(FILE *file)
+{
+	fprintf(file, "pool,frame,live,spawned,destroyed,failed\n");
+
+	std::vector<NXPoolSample> samples;
+	std::vector<NXPoolTelemetry*>& pools = GetPools();
+	for (size_t i = 0; i < pools.size(); ++i)
+	{
+		pools[i]->GetHistory(samples);
+		for (size_t s = 0; s < samples.size(); ++s)
+		{
+			const NXPoolSample& sample = samples[s];
+			fprintf(file, "%s,%u,%u,%u,%u,%u\n", pools[i]->GetName(), sample.frame, sample.live,
+					sample.spawned, sample.destroyed, sample.failed);
+		}
+	}
+}
@@ -0,0 +1,121 @@
+/**************************************************************************************************
+* \file	    NXPoolTelemetry.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Occupancy, spawn and memory figures of every object pool, sampled each frame\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXPOOLTELEMETRY_H_
+#define NXPOOLTELEMETRY_H_
+
+#include <cstdio>
+#include <vector>
+
+class NXGameObj;
+class NXObjSnapshot;
+struct NXGameObjRecord;
+
+const int NXTELEMETRY_TYPES = 32;			//Object types counted separately, higher ones share the last
+const size_t NXTELEMETRY_HISTORY = 600;		//Samples kept per pool, ten seconds at 60 frames a second
+
+struct NXPoolSample
+{
+	unsigned frame;
+	unsigned live;
+	unsigned spawned;		//Since the sample before
+	unsigned destroyed;		//Since the sample before
+	unsigned failed;		//Spawns refused because the pool was full, since the sample before
+};
+
+//Every pool registers itself on construction, so NXSampleTelemetry and NXDumpTelemetry see all
+//of them without a list to maintain, as do the pool profile and NXObjSnapshot. Pools report
+//what they hold, this keeps the history.
+class NXPoolTelemetry
+{
+	public:
+		NXPoolTelemetry(const char *name);
+		virtual ~NXPoolTelemetry( void );
+
+		const char* GetName( void ) const { return mName; }
+		void SetName(const char *name) { mName = name; }
+
+		virtual size_t GetCapacity( void ) const = 0;
+		virtual size_t GetObjectSize( void ) const = 0;
+		virtual size_t GetFootprint( void ) const = 0;	//Bytes held, objects and scratch
+		//Alive objects, also added to typeCounts by object type
+		virtual size_t CountAlive(unsigned *typeCounts) const = 0;
+		//Only while nothing in the pool is alive, e.g. when a level loads
+		virtual void Resize(size_t capacity) = 0;
+
+		//For NXObjSnapshot, objects are found by slot
+		virtual void Free( void ) = 0;
+		virtual void CaptureObjects(NXObjSnapshot& snapshot) const = 0;
+		virtual void RestoreObjects(const NXObjSnapshot& snapshot, const NXGameObjRecord *records, size_t count) = 0;
+		virtual NXGameObj* GetPoolObject(size_t slot) = 0;
+		virtual bool FindPoolObject(const NXGameObj *obj, size_t *slot) const = 0;
+
+		void Sample(unsigned frame, unsigned *typeCounts);
+		void OnSpawn( void );
+		void OnFailedSpawn( void ) { ++mFailed; ++mTotalFailed; }
+
+		unsigned GetLive( void ) const { return mLive; }
+		unsigned GetHighWater( void ) const { return mHighWater; }
+		unsigned GetTotalFailed( void ) const { return mTotalFailed; }
+		unsigned GetPeakFailed( void ) const { return mPeakFailed; }	//Most failed spawns in one sample
+
+		//Restarts the high water and peak failed spawns, e.g. at the start of a level
+		void ResetPeaks( void ) { mHighWater = 0; mPeakFailed = 0; }
+
+		//Oldest first
+		void GetHistory(std::vector<NXPoolSample>& samples) const;
+
+	protected:
+		//printf style message to NX_MESG, so pool headers need no compiler specific formatting
+		void Message(const char *format, ...) const;
+
+		//For pools that walk their objects between samples, e.g. in their update. Spawns made
+		//while counting are added on top, see OnSpawn.
+		unsigned BeginCount( void ) const { return mSpawned; }
+		void EndCount(unsigned live, unsigned mark) { mLiveBound = live + (mSpawned - mark); }
+
+	private:
+		NXPoolTelemetry(const NXPoolTelemetry&);
+		NXPoolTelemetry& operator=(const NXPoolTelemetry&);
+
+		const char *mName;
+		unsigned mLive;
+		unsigned mHighWater;
+		unsigned mLiveBound;	//Live at the last count plus spawns since, never below the real count
+		unsigned mSpawned;
+		unsigned mFailed;
+		unsigned mTotalFailed;
+		unsigned mPeakFailed;
+		std::vector<NXPoolSample> mHistory;		//Ring of NXTELEMETRY_HISTORY
+		size_t mHistoryCount;
+};
+
+//Every pool constructed and not yet destroyed, in construction order
+const std::vector<NXPoolTelemetry*>& NXGetPools( void );
+
+//Samples every pool, once per frame
+void NXSampleTelemetry( void );
+
+//Per pool: live, high water, capacity, mean spawns and destroys per frame over the history,
+//failed spawns, bytes per object and footprint. Then the live count of each object type.
+void NXDumpTelemetry(FILE *file);
+
+//Every sample of every pool, oldest first
+void NXDumpTelemetryHistory(FILE *file);
+
+#endif
@@ -0,0 +1,298 @@
+/**************************************************************************************************
+* \file	    NXProfiler.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Timed zones recorded per thread, exported as a Chrome trace or a summary\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXProfiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+	#define NX_THREAD_LOCAL __declspec(thread)
+#else
+	#define NX_THREAD_LOCAL __thread
+#endif
+
+//Written only by its own thread. count is published after the event is written, so a reader
+//sees whole events; the oldest ones may be overwritten while it copies, which only costs a
+//zone of the trace.
+struct ProfileBuffer
+{
+	unsigned thread;
+	std::atomic<unsigned> count;
+	NXProfileEvent events[NXPROFILE_BUFFER_SIZE];
+};
+
+static const std::chrono::steady_clock::time_point profileStart = std::chrono::steady_clock::now();
+
+//Buffers are kept after their thread ends, so its zones still show in the trace
+static std::mutex buffersLock;
+static std::vector<ProfileBuffer*> buffers;
+static NX_THREAD_LOCAL ProfileBuffer *threadBuffer = 0;
+
+/**************************************************************************************************
+ * \fn	static ProfileBuffer* GetThreadBuffer( void )
+ *
+ * \brief	Gets the buffer of the calling thread, created on its first zone.
+**************************************************************************************************/
+
+static ProfileBuffer* GetThreadBuffer( void )
+{
+	if (threadBuffer == 0)
+	{
+		ProfileBuffer *buffer = new ProfileBuffer;
+		buffer->count = 0;
+
+		std::lock_guard<std::mutex> lock(buffersLock);
+		buffer->thread = unsigned(buffers.size());
+		buffers.push_back(buffer);
+		threadBuffer = buffer;
+	}
+	return threadBuffer;
+}
+
+/**************************************************************************************************
+ * \fn	static void CopyEvents(const ProfileBuffer& buffer, std::vector<NXProfileEvent>& events)
+ *
+ * \brief	Appends the events still held by a buffer, oldest first.
+**************************************************************************************************/
+
+static void CopyEvents(const ProfileBuffer& buffer, std::vector<NXProfileEvent>& events)
+{
+	const unsigned count = buffer.count.load(std::memory_order_acquire);
+	const unsigned first = count > NXPROFILE_BUFFER_SIZE ? count - NXPROFILE_BUFFER_SIZE : 0;
+	for (unsigned i = first; i < count; ++i)
+	{
+		events.push_back(buffer.events[i % NXPROFILE_BUFFER_SIZE]);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	long long NXProfileNow( void )
+ *
+ * \brief	Gets the time zones are measured in.
+ *
+ * \return	Nanoseconds since the program started.
+**************************************************************************************************/
+
+long long NXProfileNow( void )
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - profileStart).count();
+}
+
+/**************************************************************************************************
+ * \fn	void NXProfileRecord(const char *name, const char *detail, long long start,
+ * 			long long end)
+ *
+ * \brief	Adds a zone to the buffer of the calling thread.
+**************************************************************************************************/
+
+void NXProfileRecord(const char *name, const char *detail, long long start, long long end)
+{
+	ProfileBuffer *buffer = GetThreadBuffer();
+	const unsigned count = buffer->count.load(std::memory_order_relaxed);
+	NXProfileEvent& event = buffer->events[count % NXPROFILE_BUFFER_SIZE];
+	event.name = name;
+	event.detail = detail;
+	event.start = start;
+	event.end = end;
+	buffer->count.store(count + 1, std::memory_order_release);
+}
+
+/**************************************************************************************************
+ * \fn	void NXProfileClear( void )
+ *
+ * \brief	Empties every buffer. Zones being recorded at the same time may survive.
+**************************************************************************************************/
+
+void NXProfileClear( void )
+{
+	std::lock_guard<std::mutex> lock(buffersLock);
+	for (size_t i = 0; i < buffers.size(); ++i)
+	{
+		buffers[i]->count.store(0, std::memory_order_release);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	const char* NXProfileTypeName(int type)
+ *
+ * \brief	Names a type number for zone details. Types past the table share the last name.
+**************************************************************************************************/
+
+const char* NXProfileTypeName(int type)
+{
+	static const char *names[] =
+	{
+		"type 0", "type 1", "type 2", "type 3", "type 4", "type 5", "type 6", "type 7",
+		"type 8", "type 9", "type 10", "type 11", "type 12", "type 13", "type 14", "type 15",
+		"type 16", "type 17", "type 18", "type 19", "type 20", "type 21", "type 22", "type 23",
+		"type 24", "type 25", "type 26", "type 27", "type 28", "type 29", "type 30", "type 31+"
+	};
+	const int count = int(sizeof(names) / sizeof(names[0]));
+	return names[type < 0 ? 0 : (type < count ? type : count - 1)];
+}
+
+/**************************************************************************************************
+ * \fn	static void WriteString(FILE *file, const char *text)
+ *
+ * \brief	Writes a quoted JSON string.
+**************************************************************************************************/
+
+static void WriteString(FILE *file, const char *text)
+{
+	fputc('"', file);
+	for (; *text; ++text)
+	{
+		if (*text == '"' || *text == '\\')
+		{
+			fputc('\\', file);
+		}
+		fputc(*text >= ' ' ? *text : ' ', file);
+	}
+	fputc('"', file);
+}
+
+/**************************************************************************************************
+ * \fn	bool NXProfileExportTrace(const char *FileName)
+ *
+ * \brief	Writes the zones of every thread in the Chrome trace event format. Zones become
+ * 			complete events, markers instant events.
+ *
+ * \param	FileName	Name of the file, replaced if it exists.
+ *
+ * \return	false if the file could not be written.
+**************************************************************************************************/
+
+bool NXProfileExportTrace(const char *FileName)
+{
+	FILE *file = fopen(FileName, "w");
+	if (file == 0)
+	{
+		return false;
+	}
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	bool isFirst = true;
+	std::vector<NXProfileEvent> events;
+
+	std::lock_guard<std::mutex> lock(buffersLock);
+	for (size_t b = 0; b < buffers.size(); ++b)
+	{
+		events.clear();
+		CopyEvents(*buffers[b], events);
+
+		for (size_t i = 0; i < events.size(); ++i)
+		{
+			const NXProfileEvent& event = events[i];
+			fprintf(file, isFirst ? "{\"name\":" : ",\n{\"name\":");
+			WriteString(file, event.name);
+			if (event.end > event.start)
+			{
+				fprintf(file, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", event.start / 1000.0, (event.end - event.start) / 1000.0);
+			}
+			else
+			{
+				fprintf(file, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f", event.start / 1000.0);
+			}
+			fprintf(file, ",\"pid\":0,\"tid\":%u", buffers[b]->thread);
+			if (event.detail)
+			{
+				fprintf(file, ",\"args\":{\"detail\":");
+				WriteString(file, event.detail);
+				fputc('}', file);
+			}
+			fputc('}', file);
+			isFirst = false;
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
+}
+
+struct ZoneSummary
+{
+	unsigned count;
+	long long total;
+	long long max;
+};
+
+static bool ByTotal(const std::pair<std::string, ZoneSummary>& lhs, const std::pair<std::string, ZoneSummary>& rhs)
+{
+	return lhs.second.total > rhs.second.total;
+}
+
+/**************************************************************************************************
+ * \fn	void NXProfileWriteSummary(FILE *file)
+ *
+ * \brief	Writes one comma separated line per zone and detail, over the zones the buffers
+ * 			still hold, so it rolls with the most recent frames. Markers are left out.
+ *
+ * \param [in]	file	The file, e.g. stdout.
+**************************************************************************************************/
+
+void NXProfileWriteSummary(FILE *file)
+{
+	std::vector<NXProfileEvent> events;
+	{
+		std::lock_guard<std::mutex> lock(buffersLock);
+		for (size_t b = 0; b < buffers.size(); ++b)
+		{
+			CopyEvents(*buffers[b], events);
+		}
+	}
+
+	std::map<std::string, ZoneSummary> zones;
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		const NXProfileEvent& event = events[i];
+		if (event.end <= event.start)
+		{
+			continue;
+		}
+
+		std::string key(event.name);
+		if (event.detail)
+		{
+			key += " ";
+			key += event.detail;
+		}
+		ZoneSummary& zone = zones[key];
+		const long long time = event.end - event.start;
+		++zone.count;
+		zone.total += time;
+		zone.max = std::max(zone.max, time);
+	}
+
+	std::vector< std::pair<std::string, ZoneSummary> > sorted(zones.begin(), zones.end());
+	std::sort(sorted.begin(), sorted.end(), ByTotal);
+
+	fprintf(file, "zone,count,total_ms,mean_us,max_us\n");
+	for (size_t i = 0; i < sorted.size(); ++i)
+	{
+		const ZoneSummary& zone = sorted[i].second;
+		fprintf(file, "%s,%u,%.3f,%.3f,%.3f\n", sorted[i].first.c_str(), zone.count,
+				zone.total / 1e6, zone.total / 1e3 / zone.count, zone.max / 1e3);
+	}
+}
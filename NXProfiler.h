@@ -0,0 +1,131 @@
+/**************************************************************************************************
+* \file	    NXProfiler.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Timed zones recorded per thread, exported as a Chrome trace or a summary\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXPROFILER_H_
+#define NXPROFILER_H_
+
+#include <cstdio>
+
+//Zones only exist in builds with NX_PROFILE defined, elsewhere the macros are empty. Each
+//thread keeps its last NXPROFILE_BUFFER_SIZE zones, oldest overwritten first.
+//
+//	void Update( void )
+//	{
+//		NX_PROFILE_ZONE("Update");
+//		...
+//	}
+//
+//Names and details must outlive the profiler, string literals or typeid names.
+
+const unsigned NXPROFILE_BUFFER_SIZE = 16384;
+
+struct NXProfileEvent
+{
+	const char *name;
+	const char *detail;		//Shown next to the name, e.g. the object type, may be null
+	long long start;		//Nanoseconds since the program started
+	long long end;			//Same as start for a marker
+};
+
+long long NXProfileNow( void );
+void NXProfileRecord(const char *name, const char *detail, long long start, long long end);
+
+//Writes every zone still held, for chrome://tracing or any viewer reading that format
+bool NXProfileExportTrace(const char *FileName);
+
+//Count, total, mean and max time of each zone over the zones still held, most expensive first
+void NXProfileWriteSummary(FILE *file);
+
+//Forgets every zone recorded so far
+void NXProfileClear( void );
+
+//"type 0", "type 1"... for zone details, e.g. of NXGameObj::GetTelemetryType
+const char* NXProfileTypeName(int type);
+
+class NXProfileScope
+{
+	public:
+		NXProfileScope(const char *name, const char *detail = 0) :
+			mName(name), mDetail(detail), mStart(NXProfileNow())
+		{
+		}
+		~NXProfileScope( void )
+		{
+			NXProfileRecord(mName, mDetail, mStart, NXProfileNow());
+		}
+
+	private:
+		const char *mName;
+		const char *mDetail;
+		long long mStart;
+};
+
+//One zone per run of work with the same detail, e.g. objects of one type in a loop. A zone per
+//item would be too fine for a buffer that must hold whole frames.
+class NXProfileRun
+{
+	public:
+		NXProfileRun(const char *name) : mName(name), mDetail(0), mStart(0)
+		{
+		}
+		~NXProfileRun( void )
+		{
+			End();
+		}
+
+		void Next(const char *detail)
+		{
+			if (detail != mDetail)
+			{
+				End();
+				mDetail = detail;
+				mStart = NXProfileNow();
+			}
+		}
+		void End( void )
+		{
+			if (mDetail)
+			{
+				NXProfileRecord(mName, mDetail, mStart, NXProfileNow());
+				mDetail = 0;
+			}
+		}
+
+	private:
+		const char *mName;
+		const char *mDetail;
+		long long mStart;
+};
+
+#ifdef NX_PROFILE
+	#define NX_PROFILE_JOIN_(a, b) a##b
+	#define NX_PROFILE_JOIN(a, b) NX_PROFILE_JOIN_(a, b)
+	#define NX_PROFILE_ZONE(name) NXProfileScope NX_PROFILE_JOIN(nxProfileZone, __LINE__)(name)
+	#define NX_PROFILE_ZONE_DETAIL(name, detail) NXProfileScope NX_PROFILE_JOIN(nxProfileZone, __LINE__)(name, detail)
+	#define NX_PROFILE_MARK(name) do { const long long nxProfileNow = NXProfileNow(); NXProfileRecord(name, 0, nxProfileNow, nxProfileNow); } while (0)
+	#define NX_PROFILE_RUN(run, name) NXProfileRun run(name)
+	#define NX_PROFILE_RUN_NEXT(run, detail) run.Next(detail)
+#else
+	#define NX_PROFILE_ZONE(name) ((void)0)
+	#define NX_PROFILE_ZONE_DETAIL(name, detail) ((void)0)
+	#define NX_PROFILE_MARK(name) ((void)0)
+	#define NX_PROFILE_RUN(run, name) ((void)0)
+	#define NX_PROFILE_RUN_NEXT(run, detail) ((void)0)
+#endif
+
+#endif
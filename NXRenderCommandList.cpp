@@ -0,0 +1,322 @@
+/**************************************************************************************************
+* \file	    NXRenderCommandList.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Records drawing calls to sort, merge and replay them later\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXRenderCommandList.h"
+#include <algorithm>
+#include <cstring>
+
+static const unsigned NO_MATRIX = ~0u;
+
+//Orders draws by key, then by the state that is most expensive to change
+struct NXRenderCommandList::DrawOrder
+{
+	bool isGrouping;
+
+	bool operator()(const Draw& lhs, const Draw& rhs) const
+	{
+		if (lhs.key != rhs.key || !isGrouping)
+		{
+			return lhs.key < rhs.key;
+		}
+		if (lhs.texture != rhs.texture)
+		{
+			return lhs.texture < rhs.texture;
+		}
+		if (lhs.vertices != rhs.vertices)
+		{
+			return lhs.vertices < rhs.vertices;
+		}
+		return lhs.flags < rhs.flags;
+	}
+};
+
+/**************************************************************************************************
+ * \fn	NXRenderCommandList::NXRenderCommandList( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXRenderCommandList::NXRenderCommandList( void )
+{
+	Clear();
+}
+
+/**************************************************************************************************
+ * \fn	NXRenderCommandList::~NXRenderCommandList( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXRenderCommandList::~NXRenderCommandList( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderCommandList::Clear( void )
+ *
+ * \brief	Removes every draw and resets the recording state to the defaults.
+**************************************************************************************************/
+
+void NXRenderCommandList::Clear( void )
+{
+	mDraws.clear();
+	mMatrices.clear();
+
+	mState.key = 0;
+	mState.transform = NO_MATRIX;
+	mState.uvTransform = NO_MATRIX;
+	mState.texture = 0;
+	mState.vertices = 0;
+	mState.color = NXCOLOR_ARGB(255,255,255,255);
+	mState.flags = 0;
+	mState.primitives = 0;
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderCommandList::Sort(bool GroupByState)
+ *
+ * \brief	Sorts the draws by key, keeping the recorded order of equal ones unless GroupByState.
+**************************************************************************************************/
+
+void NXRenderCommandList::Sort(bool GroupByState)
+{
+	DrawOrder order = { GroupByState };
+	std::stable_sort(mDraws.begin(), mDraws.end(), order);
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderCommandList::Append(const NXRenderCommandList& other)
+ *
+ * \brief	Adds the draws of another list, e.g. one recorded by another thread, after these.
+ * 			The recording state of this list is unchanged.
+**************************************************************************************************/
+
+void NXRenderCommandList::Append(const NXRenderCommandList& other)
+{
+	const unsigned offset = unsigned(mMatrices.size());
+	mMatrices.insert(mMatrices.end(), other.mMatrices.begin(), other.mMatrices.end());
+
+	const size_t first = mDraws.size();
+	mDraws.insert(mDraws.end(), other.mDraws.begin(), other.mDraws.end());
+	for (size_t i = first; i < mDraws.size(); ++i)
+	{
+		if (mDraws[i].transform != NO_MATRIX)
+		{
+			mDraws[i].transform += offset;
+		}
+		if (mDraws[i].uvTransform != NO_MATRIX)
+		{
+			mDraws[i].uvTransform += offset;
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderCommandList::Replay(NXRenderDevice& device) const
+ *
+ * \brief	Sends the draws to a device in order. The first draw sends all of its state, the
+ * 			others only what differs from the draw before.
+**************************************************************************************************/
+
+void NXRenderCommandList::Replay(NXRenderDevice& device) const
+{
+	const Draw *previous = 0;
+
+	for (size_t i = 0; i < mDraws.size(); ++i)
+	{
+		const Draw& draw = mDraws[i];
+		const unsigned changed = previous ? draw.flags ^ previous->flags : ~0u;
+
+		if (draw.flags & NXRENDER_NO_TEXTURE)
+		{
+			if (changed & NXRENDER_NO_TEXTURE)
+			{
+				device.DisableTexture();
+			}
+		}
+		else if (draw.texture && ((changed & NXRENDER_NO_TEXTURE) || draw.texture != previous->texture))
+		{
+			device.SetTexture(draw.texture);
+		}
+
+		if (draw.flags & NXRENDER_BOX)
+		{
+			if (changed & NXRENDER_BOX)
+			{
+				device.SetBox();
+			}
+		}
+		else if (draw.vertices && ((changed & NXRENDER_BOX) || draw.vertices != previous->vertices))
+		{
+			device.SetVertices(draw.vertices);
+		}
+
+		if (!previous || draw.color != previous->color)
+		{
+			device.SetColorBlending(draw.color);
+		}
+		if (changed & NXRENDER_ADDITIVE)
+		{
+			if (draw.flags & NXRENDER_ADDITIVE)
+			{
+				device.SetAdditiveBlending();
+			}
+			else
+			{
+				device.SetNormalBlending();
+			}
+		}
+		if (changed & NXRENDER_NO_Z_WRITE)
+		{
+			if (draw.flags & NXRENDER_NO_Z_WRITE)
+			{
+				device.DisableZChecking();
+			}
+			else
+			{
+				device.EnableZChecking();
+			}
+		}
+
+		if ((draw.flags & NXRENDER_UV_TRANSFORM) &&
+			((changed & NXRENDER_UV_TRANSFORM) || (draw.uvTransform != previous->uvTransform &&
+			 memcmp(&mMatrices[draw.uvTransform], &mMatrices[previous->uvTransform], sizeof(D3DXMATRIX)) != 0)))
+		{
+			device.SetTextureTransform(mMatrices[draw.uvTransform]);
+		}
+		if (draw.transform != NO_MATRIX && (!previous || previous->transform == NO_MATRIX ||
+			(draw.transform != previous->transform &&
+			 memcmp(&mMatrices[draw.transform], &mMatrices[previous->transform], sizeof(D3DXMATRIX)) != 0)))
+		{
+			device.SetObjectTransform(mMatrices[draw.transform]);
+		}
+
+		if (draw.flags & NXRENDER_LINES)
+		{
+			device.DrawLineStrip(draw.primitives);
+		}
+		else
+		{
+			device.DrawTriangleList(draw.primitives);
+		}
+		previous = &draw;
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderCommandList::AddDraw(unsigned primitives, unsigned flags)
+ *
+ * \brief	Records a draw with the current state.
+**************************************************************************************************/
+
+void NXRenderCommandList::AddDraw(unsigned primitives, unsigned flags)
+{
+	mDraws.push_back(mState);
+	mDraws.back().primitives = primitives;
+	mDraws.back().flags |= flags;
+}
+
+void NXRenderCommandList::SetTexture(NXTexture *texture)
+{
+	mState.texture = texture;
+	mState.flags &= ~NXRENDER_NO_TEXTURE;
+}
+
+void NXRenderCommandList::DisableTexture( void )
+{
+	mState.flags |= NXRENDER_NO_TEXTURE;
+}
+
+void NXRenderCommandList::SetVertices(LPDIRECT3DVERTEXBUFFER9 vertices)
+{
+	mState.vertices = vertices;
+	mState.flags &= ~NXRENDER_BOX;
+}
+
+void NXRenderCommandList::SetBox( void )
+{
+	mState.flags |= NXRENDER_BOX;
+}
+
+void NXRenderCommandList::SetColorBlending(NXCOLOR color)
+{
+	mState.color = color;
+}
+
+void NXRenderCommandList::SetAdditiveBlending( void )
+{
+	mState.flags |= NXRENDER_ADDITIVE;
+}
+
+void NXRenderCommandList::SetNormalBlending( void )
+{
+	mState.flags &= ~NXRENDER_ADDITIVE;
+}
+
+void NXRenderCommandList::EnableZChecking( void )
+{
+	mState.flags &= ~NXRENDER_NO_Z_WRITE;
+}
+
+void NXRenderCommandList::DisableZChecking( void )
+{
+	mState.flags |= NXRENDER_NO_Z_WRITE;
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderCommandList::SetTextureTransform(const D3DXMATRIX& transform)
+ *
+ * \brief	Records a texture transform. Setting the same one again stores nothing.
+**************************************************************************************************/
+
+void NXRenderCommandList::SetTextureTransform(const D3DXMATRIX& transform)
+{
+	if (mState.uvTransform == NO_MATRIX ||
+		memcmp(&mMatrices[mState.uvTransform], &transform, sizeof(D3DXMATRIX)) != 0)
+	{
+		mState.uvTransform = unsigned(mMatrices.size());
+		mMatrices.push_back(transform);
+	}
+	mState.flags |= NXRENDER_UV_TRANSFORM;
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderCommandList::SetObjectTransform(const D3DXMATRIX& transform)
+ *
+ * \brief	Records an object transform. Setting the same one again stores nothing.
+**************************************************************************************************/
+
+void NXRenderCommandList::SetObjectTransform(const D3DXMATRIX& transform)
+{
+	if (mState.transform == NO_MATRIX ||
+		memcmp(&mMatrices[mState.transform], &transform, sizeof(D3DXMATRIX)) != 0)
+	{
+		mState.transform = unsigned(mMatrices.size());
+		mMatrices.push_back(transform);
+	}
+}
+
+void NXRenderCommandList::DrawTriangleList(unsigned triangles)
+{
+	AddDraw(triangles, 0);
+}
+
+void NXRenderCommandList::DrawLineStrip(unsigned lines)
+{
+	AddDraw(lines, NXRENDER_LINES);
+}
@@ -0,0 +1,99 @@
+/**************************************************************************************************
+* \file	    NXRenderCommandList.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Records drawing calls to sort, merge and replay them later\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXRENDERCOMMANDLIST_H_
+#define NXRENDERCOMMANDLIST_H_
+
+#include "NXRenderDevice.h"
+#include <vector>
+
+//State flags of a recorded draw
+const unsigned NXRENDER_ADDITIVE		= 0x01;
+const unsigned NXRENDER_NO_Z_WRITE		= 0x02;
+const unsigned NXRENDER_UV_TRANSFORM	= 0x04;	//A texture transform was set
+const unsigned NXRENDER_NO_TEXTURE		= 0x08;	//DisableTexture instead of a texture
+const unsigned NXRENDER_BOX				= 0x10;	//SetBox instead of vertices
+const unsigned NXRENDER_LINES			= 0x20;	//A line strip instead of a triangle list
+
+//A device that records instead of drawing. Each draw keeps the whole state it was made with,
+//so the draws can be reordered and replaying them only sends the state that changes.
+//Not thread safe: record one list per thread and Append them.
+class NXRenderCommandList : public NXRenderDevice
+{
+	public:
+		NXRenderCommandList( void );
+		~NXRenderCommandList( void );
+
+		//Keeps the memory for the next frame and goes back to the default state: white, normal
+		//blending, z writing, no texture transform
+		void Clear( void );
+
+		//Draws with a smaller key are replayed first by Sort
+		void SetSortKey(unsigned key) { mState.key = key; }
+
+		//Stable sort by key. With GroupByState, draws of equal key are also grouped by texture,
+		//vertices and blending, which changes their order: only for draws that do not overlap
+		//or are z tested.
+		void Sort(bool GroupByState);
+
+		//Adds the draws of another list after these
+		void Append(const NXRenderCommandList& other);
+
+		void Replay(NXRenderDevice& device) const;
+
+		size_t GetDrawCount( void ) const { return mDraws.size(); }
+
+		void SetTexture(NXTexture *texture);
+		void DisableTexture( void );
+		void SetVertices(LPDIRECT3DVERTEXBUFFER9 vertices);
+		void SetBox( void );
+		void SetColorBlending(NXCOLOR color);
+		void SetAdditiveBlending( void );
+		void SetNormalBlending( void );
+		void EnableZChecking( void );
+		void DisableZChecking( void );
+		void SetTextureTransform(const D3DXMATRIX& transform);
+		void SetObjectTransform(const D3DXMATRIX& transform);
+		void DrawTriangleList(unsigned triangles);
+		void DrawLineStrip(unsigned lines);
+		//Text is not recorded, it is drawn over the sprites by whoever owns the device
+		void Print(int, int, NXCOLOR, const char *) {}
+
+	private:
+		struct Draw
+		{
+			unsigned key;
+			unsigned transform;		//Index into mMatrices
+			unsigned uvTransform;	//Index into mMatrices when NXRENDER_UV_TRANSFORM is set
+			NXTexture *texture;
+			LPDIRECT3DVERTEXBUFFER9 vertices;
+			NXCOLOR color;
+			unsigned flags;
+			unsigned primitives;
+		};
+
+		struct DrawOrder;
+
+		void AddDraw(unsigned primitives, unsigned flags);
+
+		std::vector<Draw> mDraws;
+		std::vector<D3DXMATRIX> mMatrices;
+		Draw mState;				//The state the next draw is made with
+};
+
+#endif
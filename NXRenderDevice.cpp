@@ -0,0 +1,53 @@
+/**************************************************************************************************
+* \file	    NXRenderDevice.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	The drawing calls sprites use, so they can go to the graphic engine, a command list
+* 			or nowhere\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXRenderDevice.h"
+#include "NXRenderStateCache.h"
+
+/**************************************************************************************************
+ * \fn	NXRenderDevice& NXGetGraphicDevice( void )
+ *
+ * \brief	The device drawing to the graphic engine of gEngine, through the state cache so
+ * 			repeated states are not sent again. It has no font, so Print through it is not
+ * 			supported.
+ *
+ * \return	The device.
+**************************************************************************************************/
+
+NXRenderDevice& NXGetGraphicDevice( void )
+{
+	return NXGetGraphicStateCache();
+}
+
+/**************************************************************************************************
+ * \fn	NXRenderDevice& NXBeginGraphicBatch( void )
+ *
+ * \brief	Gets NXGetGraphicDevice for a batch of immediate drawing. Fonts, the console and the
+ * 			editor draw to the graphic engine without going through the cache, so the state it
+ * 			remembers is dropped first and the first call of each kind reaches the engine.
+ *
+ * \return	The device.
+**************************************************************************************************/
+
+NXRenderDevice& NXBeginGraphicBatch( void )
+{
+	NXRenderStateCache& cache = NXGetGraphicStateCache();
+	cache.Invalidate();
+	return cache;
+}
@@ -0,0 +1,170 @@
+/**************************************************************************************************
+* \file	    NXRenderDevice.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	The drawing calls sprites use, so they can go to the graphic engine, a command list
+* 			or nowhere\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXRENDERDEVICE_H_
+#define NXRENDERDEVICE_H_
+
+#include "NXGraphicEngine.h"
+#include <vector>
+
+enum NXRENDER_CALL
+{
+	NXRENDER_CALL_SET_TEXTURE = 0,
+	NXRENDER_CALL_DISABLE_TEXTURE,
+	NXRENDER_CALL_SET_VERTICES,
+	NXRENDER_CALL_SET_BOX,
+	NXRENDER_CALL_SET_COLOR,
+	NXRENDER_CALL_SET_BLEND,
+	NXRENDER_CALL_SET_Z_WRITE,
+	NXRENDER_CALL_SET_TEXTURE_TRANSFORM,
+	NXRENDER_CALL_SET_OBJECT_TRANSFORM,
+	NXRENDER_CALL_DRAW,
+	NXRENDER_CALL_PRINT,
+
+	NXRENDER_CALL_TOTAL
+};
+
+class NXRenderDevice
+{
+	public:
+		virtual ~NXRenderDevice( void ) {}
+
+		virtual void SetTexture(NXTexture *texture) = 0;
+		virtual void DisableTexture( void ) = 0;
+		virtual void SetVertices(LPDIRECT3DVERTEXBUFFER9 vertices) = 0;
+		virtual void SetBox( void ) = 0;
+		virtual void SetColorBlending(NXCOLOR color) = 0;
+		virtual void SetAdditiveBlending( void ) = 0;
+		virtual void SetNormalBlending( void ) = 0;
+		virtual void EnableZChecking( void ) = 0;
+		virtual void DisableZChecking( void ) = 0;
+		virtual void SetTextureTransform(const D3DXMATRIX& transform) = 0;
+		virtual void SetObjectTransform(const D3DXMATRIX& transform) = 0;
+		virtual void DrawTriangleList(unsigned triangles) = 0;
+		virtual void DrawLineStrip(unsigned lines) = 0;
+		virtual void Print(int x, int y, NXCOLOR color, const char *text) = 0;
+};
+
+//Straight to the graphic engine
+class NXGraphicDevice : public NXRenderDevice
+{
+	public:
+		NXGraphicDevice(NXGraphicEngine *ge = 0, NXFont *font = 0) : mEngine(ge), mFont(font) {}
+
+		void SetEngine(NXGraphicEngine *ge, NXFont *font) { mEngine = ge; mFont = font; }
+
+		void SetTexture(NXTexture *texture) { mEngine->SetTexture(texture); }
+		void DisableTexture( void ) { mEngine->DisableTexture(); }
+		void SetVertices(LPDIRECT3DVERTEXBUFFER9 vertices) { mEngine->SetVertices(vertices); }
+		void SetBox( void ) { mEngine->SetBox(); }
+		void SetColorBlending(NXCOLOR color) { mEngine->SetColorBlending(color); }
+		void SetAdditiveBlending( void ) { mEngine->SetAdditiveBlending(); }
+		void SetNormalBlending( void ) { mEngine->SetNormalBlending(); }
+		void EnableZChecking( void ) { mEngine->EnableZChecking(); }
+		void DisableZChecking( void ) { mEngine->DisableZChecking(); }
+		void SetTextureTransform(const D3DXMATRIX& transform) { mEngine->SetTextureTransform(transform); }
+		void SetObjectTransform(const D3DXMATRIX& transform) { mEngine->SetObjectTransform(transform); }
+		void DrawTriangleList(unsigned triangles) { mEngine->DrawTriangleList(triangles); }
+		void DrawLineStrip(unsigned lines) { mEngine->DrawLineStrip(lines); }
+		void Print(int x, int y, NXCOLOR color, const char *text) { mEngine->NXPrint(x, y, color, text, mFont); }
+
+	private:
+		NXGraphicEngine *mEngine;
+		NXFont *mFont;
+};
+
+//One call made to a recording NXNullRenderDevice
+struct NXRenderRecord
+{
+	NXRENDER_CALL call;
+	unsigned value;		//Primitives of a draw, the color, 1 for additive blending or z checking
+};
+
+//Draws nothing, only counts the calls made to it and, if asked, records them in order
+class NXNullRenderDevice : public NXRenderDevice
+{
+	public:
+		NXNullRenderDevice( void ) : isRecording(false) { Reset(); }
+
+		void Reset( void );
+		unsigned GetCount(NXRENDER_CALL call) const { return mCounts[call]; }
+		unsigned GetTotal( void ) const;
+		unsigned GetPrimitives( void ) const { return mPrimitives; }
+
+		void SetRecording( bool record ) { isRecording = record; }
+		const std::vector<NXRenderRecord>& GetRecord( void ) const { return mRecord; }
+
+		void SetTexture(NXTexture *) { Count(NXRENDER_CALL_SET_TEXTURE, 0); }
+		void DisableTexture( void ) { Count(NXRENDER_CALL_DISABLE_TEXTURE, 0); }
+		void SetVertices(LPDIRECT3DVERTEXBUFFER9) { Count(NXRENDER_CALL_SET_VERTICES, 0); }
+		void SetBox( void ) { Count(NXRENDER_CALL_SET_BOX, 0); }
+		void SetColorBlending(NXCOLOR color) { Count(NXRENDER_CALL_SET_COLOR, color); }
+		void SetAdditiveBlending( void ) { Count(NXRENDER_CALL_SET_BLEND, 1); }
+		void SetNormalBlending( void ) { Count(NXRENDER_CALL_SET_BLEND, 0); }
+		void EnableZChecking( void ) { Count(NXRENDER_CALL_SET_Z_WRITE, 1); }
+		void DisableZChecking( void ) { Count(NXRENDER_CALL_SET_Z_WRITE, 0); }
+		void SetTextureTransform(const D3DXMATRIX&) { Count(NXRENDER_CALL_SET_TEXTURE_TRANSFORM, 0); }
+		void SetObjectTransform(const D3DXMATRIX&) { Count(NXRENDER_CALL_SET_OBJECT_TRANSFORM, 0); }
+		void DrawTriangleList(unsigned triangles) { Count(NXRENDER_CALL_DRAW, triangles); mPrimitives += triangles; }
+		void DrawLineStrip(unsigned lines) { Count(NXRENDER_CALL_DRAW, lines); mPrimitives += lines; }
+		void Print(int, int, NXCOLOR, const char *) { Count(NXRENDER_CALL_PRINT, 0); }
+
+	private:
+		void Count(NXRENDER_CALL call, unsigned value)
+		{
+			++mCounts[call];
+			if (isRecording)
+			{
+				NXRenderRecord record = { call, value };
+				mRecord.push_back(record);
+			}
+		}
+
+		unsigned mCounts[NXRENDER_CALL_TOTAL];
+		unsigned mPrimitives;
+		bool isRecording;
+		std::vector<NXRenderRecord> mRecord;
+};
+
+inline void NXNullRenderDevice::Reset( void )
+{
+	for (int i = 0; i < NXRENDER_CALL_TOTAL; ++i)
+	{
+		mCounts[i] = 0;
+	}
+	mPrimitives = 0;
+	mRecord.clear();
+}
+
+inline unsigned NXNullRenderDevice::GetTotal( void ) const
+{
+	unsigned total = 0;
+	for (int i = 0; i < NXRENDER_CALL_TOTAL; ++i)
+	{
+		total += mCounts[i];
+	}
+	return total;
+}
+
+//The graphic engine of gEngine, for code that draws immediately
+NXRenderDevice& NXGetGraphicDevice( void );
+//The same device with its cached state forgotten, for the start of each immediate batch
+NXRenderDevice& NXBeginGraphicBatch( void );
+
+#endif
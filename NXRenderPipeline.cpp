@@ -0,0 +1,240 @@
+/**************************************************************************************************
+* \file	    NXRenderPipeline.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Draws frame N on a render thread while the simulation runs frame N + 1\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXRenderPipeline.h"
+#include "NXAssert.h"
+#include "NXProfiler.h"
+#include <chrono>
+
+NXRenderPipeline gRenderPipeline;
+
+/**************************************************************************************************
+ * \fn	NXRenderPipeline::NXRenderPipeline( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXRenderPipeline::NXRenderPipeline( void ) :
+	mBack(0),
+	mDraw(0),
+	mWaitTime(0.0),
+	isFilling(false),
+	hasFrame(false),
+	isQuitting(false)
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXRenderPipeline::~NXRenderPipeline( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXRenderPipeline::~NXRenderPipeline( void )
+{
+	Stop();
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderPipeline::Start(NXRenderFunction draw, bool isThreaded)
+ *
+ * \brief	Starts the render thread. From here on it draws between EndFrame and WaitForFrame.
+ *
+ * \param	draw	  	Draws a frame from a snapshot.
+ * \param	isThreaded	false to draw in EndFrame on the calling thread instead.
+**************************************************************************************************/
+
+void NXRenderPipeline::Start(NXRenderFunction draw, bool isThreaded)
+{
+	NX_ASSERT(draw);
+	Stop();
+
+	mDraw = draw;
+	hasFrame = false;
+	isQuitting = false;
+	if (isThreaded)
+	{
+		mThread = std::thread(&NXRenderPipeline::RenderThread, this);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderPipeline::Stop( void )
+ *
+ * \brief	Lets the render thread finish the frame in flight, then joins it. A snapshot filled
+ * 			but not handed over yet is dropped.
+**************************************************************************************************/
+
+void NXRenderPipeline::Stop( void )
+{
+	isFilling = false;
+	if (!mThread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (hasFrame)
+		{
+			mFrameDrawn.wait(lock);
+		}
+		isQuitting = true;
+	}
+	mFrameReady.notify_one();
+	mThread.join();
+}
+
+/**************************************************************************************************
+ * \fn	NXRenderSnapshot& NXRenderPipeline::BeginFrame( void )
+ *
+ * \brief	Gives the simulation the snapshot to fill for this tick, emptied.
+ *
+ * \return	The snapshot.
+**************************************************************************************************/
+
+NXRenderSnapshot& NXRenderPipeline::BeginFrame( void )
+{
+	NXRenderSnapshot& snapshot = mSnapshots[mBack];
+	snapshot.Clear();
+	isFilling = true;
+	return snapshot;
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderPipeline::EndFrame( void )
+ *
+ * \brief	Publishes the filled snapshot. Waits until the render thread has drawn the previous
+ * 			one, since that is the buffer the next BeginFrame hands out.
+**************************************************************************************************/
+
+void NXRenderPipeline::EndFrame( void )
+{
+	if (!isFilling)
+	{
+		return;
+	}
+	isFilling = false;
+
+	NX_PROFILE_MARK("Frame");
+	if (!mThread.joinable())
+	{
+		if (mDraw)
+		{
+			mDraw(mSnapshots[mBack]);
+		}
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (hasFrame)
+		{
+			NX_PROFILE_ZONE("NXRenderPipeline::Wait");
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			while (hasFrame)
+			{
+				mFrameDrawn.wait(lock);
+			}
+			mWaitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+		mBack ^= 1;
+		hasFrame = true;
+	}
+	mFrameReady.notify_one();
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderPipeline::WaitForFrame( void )
+ *
+ * \brief	Blocks until the render thread has drawn the frame handed over by EndFrame, scene end
+ * 			included. The device is not used by the render thread again until the next
+ * 			EndFrame, so Present and device resets can follow.
+**************************************************************************************************/
+
+void NXRenderPipeline::WaitForFrame( void )
+{
+	if (!mThread.joinable())
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (hasFrame)
+	{
+		NX_PROFILE_ZONE("NXRenderPipeline::WaitForFrame");
+		while (hasFrame)
+		{
+			mFrameDrawn.wait(lock);
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	double NXRenderPipeline::GetWaitTime( void )
+ *
+ * \brief	Time the simulation spent blocked on the render thread since the last call. Near zero
+ * 			means rendering keeps up with the simulation.
+ *
+ * \return	The time in seconds.
+**************************************************************************************************/
+
+double NXRenderPipeline::GetWaitTime( void )
+{
+	const double time = mWaitTime;
+	mWaitTime = 0.0;
+	return time;
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderPipeline::RenderThread( void )
+ *
+ * \brief	Draws each published snapshot. The front snapshot is not written while hasFrame is
+ * 			set, so it is drawn without holding the lock.
+**************************************************************************************************/
+
+void NXRenderPipeline::RenderThread( void )
+{
+	for (;;)
+	{
+		int front;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (!hasFrame && !isQuitting)
+			{
+				mFrameReady.wait(lock);
+			}
+			if (!hasFrame)
+			{
+				return;
+			}
+			front = mBack ^ 1;
+		}
+
+		{
+			NX_PROFILE_ZONE("NXRenderPipeline::Draw");
+			mDraw(mSnapshots[front]);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			hasFrame = false;
+		}
+		mFrameDrawn.notify_one();
+	}
+}
@@ -0,0 +1,82 @@
+/**************************************************************************************************
+* \file	    NXRenderPipeline.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Draws frame N on a render thread while the simulation runs frame N + 1\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXRENDERPIPELINE_H_
+#define NXRENDERPIPELINE_H_
+
+#include "NXRenderSnapshot.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//Draws a whole frame from a snapshot, scene begin/end included
+typedef void (*NXRenderFunction)(const NXRenderSnapshot& snapshot);
+
+//Two snapshots: the simulation fills one while the render thread draws the other. D3D9 only
+//allows a second thread on a device created with D3DCREATE_MULTITHREADED, so without one the
+//pipeline is started without a thread and frames are drawn on the simulation thread. Present,
+//device resets and resource creation stay on the main thread, after WaitForFrame, so a frame
+//is never presented before its scene has ended. Handing a frame over at the start of the next
+//tick lets it be drawn while that tick is simulated.
+class NXRenderPipeline
+{
+	public:
+		NXRenderPipeline( void );
+		~NXRenderPipeline( void );
+
+		void Start(NXRenderFunction draw, bool isThreaded = true);
+		//Draws the frame in flight, then stops the render thread
+		void Stop( void );
+		bool IsRunning( void ) const { return mThread.joinable(); }
+
+		//Simulation thread. BeginFrame gives the snapshot to fill, EndFrame hands it to the
+		//render thread, waiting for it to finish the previous one first. Without a render
+		//thread EndFrame draws on the calling thread. EndFrame without a BeginFrame since
+		//the last one does nothing.
+		NXRenderSnapshot& BeginFrame( void );
+		void EndFrame( void );
+
+		//Main thread, before Present. Waits until the frame handed over is drawn.
+		void WaitForFrame( void );
+
+		//Seconds the simulation spent waiting for the render thread, since the last call
+		double GetWaitTime( void );
+
+	private:
+		NXRenderPipeline(const NXRenderPipeline&);
+		NXRenderPipeline& operator=(const NXRenderPipeline&);
+
+		void RenderThread( void );
+
+		NXRenderSnapshot mSnapshots[2];
+		int mBack;						//Filled by the simulation, the other one is drawn
+		NXRenderFunction mDraw;
+		double mWaitTime;
+		bool isFilling;					//BeginFrame was called and EndFrame was not
+
+		std::thread mThread;
+		std::mutex mMutex;
+		std::condition_variable mFrameReady;
+		std::condition_variable mFrameDrawn;
+		bool hasFrame;					//Guarded by mMutex, the front snapshot is not drawn yet
+		bool isQuitting;				//Guarded by mMutex
+};
+
+extern NXRenderPipeline gRenderPipeline;
+
+#endif
@@ -0,0 +1,145 @@
+/**************************************************************************************************
+* \file	    NXRenderSnapshot.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Everything needed to draw one frame, copied out of the game objects\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXRenderSnapshot.h"
+#include "NXEngineMain.h"
+#include <cstring>
+
+/**************************************************************************************************
+ * \fn	NXRenderSnapshot::NXRenderSnapshot( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXRenderSnapshot::NXRenderSnapshot( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXRenderSnapshot::~NXRenderSnapshot( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXRenderSnapshot::~NXRenderSnapshot( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderSnapshot::Clear( void )
+ *
+ * \brief	Empties the snapshot for the next frame, keeping its memory.
+**************************************************************************************************/
+
+void NXRenderSnapshot::Clear( void )
+{
+	mInstances.clear();
+	mTexts.clear();
+}
+
+/**************************************************************************************************
+ * \fn	NXRenderInstance& NXRenderSnapshot::AddInstance( void )
+ *
+ * \brief	Appends an instance to be filled in by the caller.
+ *
+ * \return	The instance.
+**************************************************************************************************/
+
+NXRenderInstance& NXRenderSnapshot::AddInstance( void )
+{
+	mInstances.resize(mInstances.size() + 1);
+	return mInstances.back();
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderSnapshot::AddText(int x, int y, NXCOLOR color, const char *text)
+ *
+ * \brief	Appends a line of text, cut to NXRENDER_TEXT_LENGTH - 1 characters.
+**************************************************************************************************/
+
+void NXRenderSnapshot::AddText(int x, int y, NXCOLOR color, const char *text)
+{
+	mTexts.resize(mTexts.size() + 1);
+	NXRenderText& line = mTexts.back();
+	line.x = x;
+	line.y = y;
+	line.color = color;
+	strncpy(line.text, text, NXRENDER_TEXT_LENGTH - 1);
+	line.text[NXRENDER_TEXT_LENGTH - 1] = 0;
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderSnapshot::Record(NXRenderCommandList& list) const
+ *
+ * \brief	Records a draw for every instance, in order.
+ *
+ * \param [in,out]	list	The list to record into.
+**************************************************************************************************/
+
+void NXRenderSnapshot::Record(NXRenderCommandList& list) const
+{
+	for (size_t i = 0; i < mInstances.size(); ++i)
+	{
+		const NXRenderInstance& instance = mInstances[i];
+
+		list.SetTexture(instance.texture);
+		list.SetVertices(instance.vertices);
+		list.SetColorBlending(instance.color);
+		if (instance.flags & NXRENDER_ADDITIVE)
+		{
+			list.SetAdditiveBlending();
+		}
+		else
+		{
+			list.SetNormalBlending();
+		}
+		if (instance.flags & NXRENDER_NO_Z_WRITE)
+		{
+			list.DisableZChecking();
+		}
+		else
+		{
+			list.EnableZChecking();
+		}
+		if (instance.flags & NXRENDER_UV_TRANSFORM)
+		{
+			D3DXMATRIX uv;
+			D3DXMatrixScaling(&uv, instance.uvScaleX, instance.uvScaleY, 1.0f);
+			uv._31 = instance.uvOffsetX;
+			uv._32 = instance.uvOffsetY;
+			list.SetTextureTransform(uv);
+		}
+
+		list.SetObjectTransform(instance.transform);
+		list.DrawTriangleList(2);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderSnapshot::DrawText(NXRenderDevice& device) const
+ *
+ * \brief	Prints the lines of text, to go over the sprites.
+**************************************************************************************************/
+
+void NXRenderSnapshot::DrawText(NXRenderDevice& device) const
+{
+	for (size_t i = 0; i < mTexts.size(); ++i)
+	{
+		device.Print(mTexts[i].x, mTexts[i].y, mTexts[i].color, mTexts[i].text);
+	}
+}
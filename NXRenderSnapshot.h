@@ -0,0 +1,71 @@
+/**************************************************************************************************
+* \file	    NXRenderSnapshot.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Everything needed to draw one frame, copied out of the game objects\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXRENDERSNAPSHOT_H_
+#define NXRENDERSNAPSHOT_H_
+
+#include "NXRenderCommandList.h"
+#include <vector>
+
+const int NXRENDER_TEXT_LENGTH = 64;
+
+//One sprite, drawn as two triangles
+struct NXRenderInstance
+{
+	D3DXMATRIX transform;
+	float uvScaleX, uvScaleY;
+	float uvOffsetX, uvOffsetY;
+	NXTexture *texture;
+	LPDIRECT3DVERTEXBUFFER9 vertices;
+	NXCOLOR color;
+	unsigned flags;		//NXRENDER_ADDITIVE, NXRENDER_NO_Z_WRITE, NXRENDER_UV_TRANSFORM (uv fields set)
+};
+
+struct NXRenderText
+{
+	int x, y;
+	NXCOLOR color;
+	char text[NXRENDER_TEXT_LENGTH];
+};
+
+//Written by the simulation at the end of a tick, then only read by the renderer
+class NXRenderSnapshot
+{
+	public:
+		NXRenderSnapshot( void );
+		~NXRenderSnapshot( void );
+
+		//Keeps the memory for the next frame
+		void Clear( void );
+
+		NXRenderInstance& AddInstance( void );
+		void AddText(int x, int y, NXCOLOR color, const char *text);
+
+		//Records the instances in order
+		void Record(NXRenderCommandList& list) const;
+		void DrawText(NXRenderDevice& device) const;
+
+		const std::vector<NXRenderInstance>& GetInstances( void ) const { return mInstances; }
+		const std::vector<NXRenderText>& GetTexts( void ) const { return mTexts; }
+
+	private:
+		std::vector<NXRenderInstance> mInstances;
+		std::vector<NXRenderText> mTexts;
+};
+
+#endif
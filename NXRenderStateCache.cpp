@@ -0,0 +1,300 @@
+/**************************************************************************************************
+* \file	    NXRenderStateCache.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Keeps a copy of the device state and drops calls that would not change it\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXRenderStateCache.h"
+#include "NXEngineMain.h"
+#include "NXHeadless.h"
+#include <cstring>
+
+/**************************************************************************************************
+ * \fn	NXRenderStateCache::NXRenderStateCache(NXRenderDevice *target)
+ *
+ * \brief	Constructor.
+ *
+ * \param [in]	target	The device the calls that change state go to.
+**************************************************************************************************/
+
+NXRenderStateCache::NXRenderStateCache(NXRenderDevice *target) :
+	mTarget(target),
+	mLastSubmitted(0),
+	mLastFiltered(0)
+{
+	for (int i = 0; i < NXRENDER_CALL_TOTAL; ++i)
+	{
+		mSubmitted[i] = mFiltered[i] = 0;
+	}
+	Invalidate();
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderStateCache::SetTarget(NXRenderDevice *target)
+ *
+ * \brief	Changes the device the calls go to. The state of the new one is unknown, so the
+ * 			cache is invalidated when it differs.
+ *
+ * \param [in]	target	The device.
+**************************************************************************************************/
+
+void NXRenderStateCache::SetTarget(NXRenderDevice *target)
+{
+	if (target != mTarget)
+	{
+		mTarget = target;
+		Invalidate();
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderStateCache::Invalidate( void )
+ *
+ * \brief	Forgets the state of the device.
+**************************************************************************************************/
+
+void NXRenderStateCache::Invalidate( void )
+{
+	mTexture = 0;
+	mVertices = 0;
+	mColor = 0;
+	hasTexture = hasVertices = hasColor = hasTextureTransform = false;
+	mBlend = BLEND_UNKNOWN;
+	mZWrite = Z_WRITE_UNKNOWN;
+}
+
+/**************************************************************************************************
+ * \fn	void NXRenderStateCache::BeginFrame( void )
+ *
+ * \brief	Keeps the totals of the frame that ended and starts counting again. Called once per
+ * 			frame after the scene is begun.
+**************************************************************************************************/
+
+void NXRenderStateCache::BeginFrame( void )
+{
+	mLastSubmitted = GetTotalSubmitted();
+	mLastFiltered = GetTotalFiltered();
+	for (int i = 0; i < NXRENDER_CALL_TOTAL; ++i)
+	{
+		mSubmitted[i] = mFiltered[i] = 0;
+	}
+	Invalidate();
+}
+
+/**************************************************************************************************
+ * \fn	unsigned NXRenderStateCache::GetTotalSubmitted( void ) const
+ *
+ * \brief	Gets the number of calls made to the cache this frame.
+ *
+ * \return	The number of calls.
+**************************************************************************************************/
+
+unsigned NXRenderStateCache::GetTotalSubmitted( void ) const
+{
+	unsigned total = 0;
+	for (int i = 0; i < NXRENDER_CALL_TOTAL; ++i)
+	{
+		total += mSubmitted[i];
+	}
+	return total;
+}
+
+/**************************************************************************************************
+ * \fn	unsigned NXRenderStateCache::GetTotalFiltered( void ) const
+ *
+ * \brief	Gets the number of calls dropped this frame.
+ *
+ * \return	The number of calls.
+**************************************************************************************************/
+
+unsigned NXRenderStateCache::GetTotalFiltered( void ) const
+{
+	unsigned total = 0;
+	for (int i = 0; i < NXRENDER_CALL_TOTAL; ++i)
+	{
+		total += mFiltered[i];
+	}
+	return total;
+}
+
+bool NXRenderStateCache::Submit(NXRENDER_CALL call, bool isChanging)
+{
+	++mSubmitted[call];
+	if (!isChanging)
+	{
+		++mFiltered[call];
+	}
+	return isChanging;
+}
+
+void NXRenderStateCache::SetTexture(NXTexture *texture)
+{
+	if (Submit(NXRENDER_CALL_SET_TEXTURE, !hasTexture || texture != mTexture))
+	{
+		mTexture = texture;
+		hasTexture = true;
+		mTarget->SetTexture(texture);
+	}
+}
+
+void NXRenderStateCache::DisableTexture( void )
+{
+	if (Submit(NXRENDER_CALL_DISABLE_TEXTURE, !hasTexture || mTexture != 0))
+	{
+		mTexture = 0;
+		hasTexture = true;
+		mTarget->DisableTexture();
+	}
+}
+
+void NXRenderStateCache::SetVertices(LPDIRECT3DVERTEXBUFFER9 vertices)
+{
+	if (Submit(NXRENDER_CALL_SET_VERTICES, !hasVertices || vertices != mVertices))
+	{
+		mVertices = vertices;
+		hasVertices = true;
+		mTarget->SetVertices(vertices);
+	}
+}
+
+void NXRenderStateCache::SetBox( void )
+{
+	if (Submit(NXRENDER_CALL_SET_BOX, !hasVertices || mVertices != 0))
+	{
+		mVertices = 0;
+		hasVertices = true;
+		mTarget->SetBox();
+	}
+}
+
+void NXRenderStateCache::SetColorBlending(NXCOLOR color)
+{
+	if (Submit(NXRENDER_CALL_SET_COLOR, !hasColor || color != mColor))
+	{
+		mColor = color;
+		hasColor = true;
+		mTarget->SetColorBlending(color);
+	}
+}
+
+void NXRenderStateCache::SetAdditiveBlending( void )
+{
+	if (Submit(NXRENDER_CALL_SET_BLEND, mBlend != BLEND_ADDITIVE))
+	{
+		mBlend = BLEND_ADDITIVE;
+		mTarget->SetAdditiveBlending();
+	}
+}
+
+void NXRenderStateCache::SetNormalBlending( void )
+{
+	if (Submit(NXRENDER_CALL_SET_BLEND, mBlend != BLEND_NORMAL))
+	{
+		mBlend = BLEND_NORMAL;
+		mTarget->SetNormalBlending();
+	}
+}
+
+void NXRenderStateCache::EnableZChecking( void )
+{
+	if (Submit(NXRENDER_CALL_SET_Z_WRITE, mZWrite != Z_WRITE_ON))
+	{
+		mZWrite = Z_WRITE_ON;
+		mTarget->EnableZChecking();
+	}
+}
+
+void NXRenderStateCache::DisableZChecking( void )
+{
+	if (Submit(NXRENDER_CALL_SET_Z_WRITE, mZWrite != Z_WRITE_OFF))
+	{
+		mZWrite = Z_WRITE_OFF;
+		mTarget->DisableZChecking();
+	}
+}
+
+void NXRenderStateCache::SetTextureTransform(const D3DXMATRIX& transform)
+{
+	if (Submit(NXRENDER_CALL_SET_TEXTURE_TRANSFORM,
+		!hasTextureTransform || memcmp(&transform, &mTextureTransform, sizeof(D3DXMATRIX)) != 0))
+	{
+		mTextureTransform = transform;
+		hasTextureTransform = true;
+		mTarget->SetTextureTransform(transform);
+	}
+}
+
+void NXRenderStateCache::SetObjectTransform(const D3DXMATRIX& transform)
+{
+	Submit(NXRENDER_CALL_SET_OBJECT_TRANSFORM, true);
+	mTarget->SetObjectTransform(transform);
+}
+
+void NXRenderStateCache::DrawTriangleList(unsigned triangles)
+{
+	Submit(NXRENDER_CALL_DRAW, true);
+	mTarget->DrawTriangleList(triangles);
+}
+
+void NXRenderStateCache::DrawLineStrip(unsigned lines)
+{
+	Submit(NXRENDER_CALL_DRAW, true);
+	mTarget->DrawLineStrip(lines);
+}
+
+//Fonts set their own states
+void NXRenderStateCache::Print(int x, int y, NXCOLOR color, const char *text)
+{
+	Submit(NXRENDER_CALL_PRINT, true);
+	mTarget->Print(x, y, color, text);
+	Invalidate();
+}
+
+/**************************************************************************************************
+ * \fn	NXRenderStateCache& NXGetGraphicStateCache( void )
+ *
+ * \brief	The cache in front of the graphic engine of gEngine, which NXGetGraphicDevice hands
+ * 			out. Headless builds put it in front of the headless device instead.
+ *
+ * \return	The cache.
+**************************************************************************************************/
+
+#ifdef NX_HEADLESS
+
+NXRenderStateCache& NXGetGraphicStateCache( void )
+{
+	static NXRenderStateCache cache(&NXGetHeadlessDevice());
+	return cache;
+}
+
+#else
+
+NXRenderStateCache& NXGetGraphicStateCache( void )
+{
+	static NXGraphicDevice device;
+	static NXRenderStateCache cache(&device);
+	static NXGraphicEngine *engine = 0;
+
+	NXGraphicEngine *ge = gEngine.GetGraphicEngine();
+	if (ge != engine)
+	{
+		engine = ge;
+		device.SetEngine(ge, 0);
+		cache.Invalidate();
+	}
+	return cache;
+}
+
+#endif
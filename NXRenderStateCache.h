@@ -0,0 +1,108 @@
+/**************************************************************************************************
+* \file	    NXRenderStateCache.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Keeps a copy of the device state and drops calls that would not change it\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXRENDERSTATECACHE_H_
+#define NXRENDERSTATECACHE_H_
+
+#include "NXRenderDevice.h"
+
+//Sits in front of another device. Anything drawing to the same engine without going through
+//the cache (fonts, the console) must be followed by Invalidate, NXBeginGraphicBatch and
+//BeginFrame do it as well.
+class NXRenderStateCache : public NXRenderDevice
+{
+	public:
+		NXRenderStateCache(NXRenderDevice *target = 0);
+
+		void SetTarget(NXRenderDevice *target);
+		NXRenderDevice* GetTarget( void ) const { return mTarget; }
+
+		//Forgets the state, so the next call of each kind is always sent
+		void Invalidate( void );
+
+		//Invalidates and starts counting a new frame
+		void BeginFrame( void );
+
+		//Calls made to the cache and calls it did not pass on, this frame and the frame before
+		unsigned GetSubmitted(NXRENDER_CALL call) const { return mSubmitted[call]; }
+		unsigned GetFiltered(NXRENDER_CALL call) const { return mFiltered[call]; }
+		unsigned GetTotalSubmitted( void ) const;
+		unsigned GetTotalFiltered( void ) const;
+		unsigned GetLastFrameSubmitted( void ) const { return mLastSubmitted; }
+		unsigned GetLastFrameFiltered( void ) const { return mLastFiltered; }
+
+		void SetTexture(NXTexture *texture);
+		void DisableTexture( void );
+		void SetVertices(LPDIRECT3DVERTEXBUFFER9 vertices);
+		void SetBox( void );
+		void SetColorBlending(NXCOLOR color);
+		void SetAdditiveBlending( void );
+		void SetNormalBlending( void );
+		void EnableZChecking( void );
+		void DisableZChecking( void );
+		void SetTextureTransform(const D3DXMATRIX& transform);
+		//Object transforms differ for nearly every sprite, they are counted but not compared
+		void SetObjectTransform(const D3DXMATRIX& transform);
+		void DrawTriangleList(unsigned triangles);
+		void DrawLineStrip(unsigned lines);
+		void Print(int x, int y, NXCOLOR color, const char *text);
+
+	private:
+		enum BLEND
+		{
+			BLEND_UNKNOWN,
+			BLEND_NORMAL,
+			BLEND_ADDITIVE
+		};
+
+		enum Z_WRITE
+		{
+			Z_WRITE_UNKNOWN,
+			Z_WRITE_ON,
+			Z_WRITE_OFF
+		};
+
+		//Counts the call, true when it has to be passed on
+		bool Submit(NXRENDER_CALL call, bool isChanging);
+
+		NXRenderDevice *mTarget;
+
+		//Valid only while the matching has flag is set
+		NXTexture *mTexture;				//0 while texturing is disabled
+		LPDIRECT3DVERTEXBUFFER9 mVertices;	//0 while the box is set
+		NXCOLOR mColor;
+		D3DXMATRIX mTextureTransform;
+		bool hasTexture;
+		bool hasVertices;
+		bool hasColor;
+		bool hasTextureTransform;
+		BLEND mBlend;
+		Z_WRITE mZWrite;
+
+		unsigned mSubmitted[NXRENDER_CALL_TOTAL];
+		unsigned mFiltered[NXRENDER_CALL_TOTAL];
+		unsigned mLastSubmitted;
+		unsigned mLastFiltered;
+};
+
+//The cache in front of the graphic engine of gEngine. The pool and tile map entry points start
+//each batch with NXBeginGraphicBatch, so state changed behind its back is never trusted there.
+//Objects drawn one at a time keep the cached state between them.
+NXRenderStateCache& NXGetGraphicStateCache( void );
+
+#endif
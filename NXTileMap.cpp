@@ -18,8 +18,21 @@
 **************************************************************************************************/
 #include "NXTileMap.h"
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <queue>
+#include <algorithm>
 #include "tinyxml.h"
 #include "NXAssert.h"
+#include "NXEngineMain.h"
+#include "NXCamera.h"
+#include "NXProfiler.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 NXTileMap gCollisionTile;
 
@@ -33,7 +46,13 @@ NXTileMap::NXTileMap( void ):
      BINARY_MAP_WIDTH (0),
 	 BINARY_MAP_HEIGHT(0),
 	 MapData(0),
-	 BinaryCollisionArray(0)
+	 mCollisionLayout(NXBITGRID_ROW_MAJOR),
+	 isMapped(false),
+	 mStreamer(0),
+	 mStreamMargin(0),
+	 mEditDepth(0),
+	 hasEdit(false),
+	 mDirtyBase(0)
 {
 }
 
@@ -60,21 +79,177 @@ NXTileMap::~NXTileMap( void )
 \param Y
 	The which row in which you want to find out
 \return
-	Return the value in which it is stored if its out of bound will return 0
+	Return 1 if the cell is solid, 0 if it is empty or out of bound
 
 */
 /******************************************************************************/
-int NXTileMap::GetCellValue(const int& X, const int& Y)
+int NXTileMap::GetCellValue(const int& X, const int& Y) const
 {
-	int tempReturn = 0;
+	if (mStreamer)
+	{
+		return mStreamer->GetCellValue(X, Y);
+	}
+	return BinaryCollisionArray.GetCellValue(X, Y);
+}
 
-	if(X < BINARY_MAP_WIDTH  && 
-	   Y < BINARY_MAP_HEIGHT &&
-	   X >= 0 && Y >= 0)
+/**************************************************************************************************
+ * \fn	int NXTileMap::GetTileValue(const int& X, const int& Y) const
+ *
+ * \brief	Gets the tile id of a cell, works whether the map is resident or streamed.
+ *
+ * \return	The tile id, 0 if out of bound or not loaded yet.
+**************************************************************************************************/
 
-	tempReturn = BinaryCollisionArray[X + Y * BINARY_MAP_WIDTH];
-	
-	return tempReturn;
+int NXTileMap::GetTileValue(const int& X, const int& Y) const
+{
+	if (mStreamer)
+	{
+		return mStreamer->GetTileValue(X, Y);
+	}
+	if (MapData == 0 || unsigned(X) >= unsigned(BINARY_MAP_WIDTH) || 
+		unsigned(Y) >= unsigned(BINARY_MAP_HEIGHT))
+	{
+		return 0;
+	}
+	return MapData[X + Y * BINARY_MAP_WIDTH];
+}
+
+/**************************************************************************************************
+ * \fn	int NXTileMap::SetCellValue(const int& X, const int& Y, const int& Tile)
+ *
+ * \brief	Changes the tile of a cell in place, e.g. when a wall is blown up. The tile id and the
+ * 			collision bit are written directly (a mapped map is copy on write, so the file is not
+ * 			touched) and the cell is added to the current edit. Outside BeginEdit/EndEdit the
+ * 			edit is applied at once.
+ *
+ * \param	X		The column.
+ * \param	Y		The row.
+ * \param	Tile	The new tile id, 0 for empty.
+ *
+ * \return	1 if the cell was changed, 0 if out of bound or the map is streamed.
+**************************************************************************************************/
+
+int NXTileMap::SetCellValue(const int& X, const int& Y, const int& Tile)
+{
+	if (MapData == 0 || mStreamer ||
+		unsigned(X) >= unsigned(BINARY_MAP_WIDTH) || unsigned(Y) >= unsigned(BINARY_MAP_HEIGHT))
+	{
+		return 0;
+	}
+
+	int& cell = MapData[X + Y * BINARY_MAP_WIDTH];
+	if (cell == Tile)
+	{
+		return 1;
+	}
+	cell = Tile;
+	BinaryCollisionArray.Set(X, Y, Tile != 0);
+
+	if (hasEdit)
+	{
+		if (X < mEditRect.x0) mEditRect.x0 = X;
+		if (Y < mEditRect.y0) mEditRect.y0 = Y;
+		if (X > mEditRect.x1) mEditRect.x1 = X;
+		if (Y > mEditRect.y1) mEditRect.y1 = Y;
+	}
+	else
+	{
+		mEditRect.x0 = mEditRect.x1 = X;
+		mEditRect.y0 = mEditRect.y1 = Y;
+		hasEdit = true;
+	}
+
+	if (mEditDepth == 0)
+	{
+		EndEdit();
+	}
+	return 1;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileMap::BeginEdit( void )
+ *
+ * \brief	Starts a batch of SetCellValue calls, the caches are updated once at EndEdit for the
+ * 			bounding rectangle of the batch. Batches may nest.
+**************************************************************************************************/
+
+void NXTileMap::BeginEdit( void )
+{
+	++mEditDepth;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileMap::EndEdit( void )
+ *
+ * \brief	Ends a batch. The ground table, solid rectangles and occupancy pyramid are updated
+ * 			over the edited rectangle only, and the rectangle is logged for the caches outside
+ * 			the map (render chunks, flow fields) to pick up with GetDirtyRectsSince.
+**************************************************************************************************/
+
+void NXTileMap::EndEdit( void )
+{
+	if (mEditDepth > 0)
+	{
+		--mEditDepth;
+	}
+	if (mEditDepth > 0 || !hasEdit)
+	{
+		return;
+	}
+	hasEdit = false;
+
+	const NXTileDirtyRect& rect = mEditRect;
+	mGroundTable.RebuildColumns(BinaryCollisionArray, rect.x0, rect.x1);
+	mSolidRects.RebuildRegion(BinaryCollisionArray, rect.x0, rect.y0, rect.x1, rect.y1);
+	mOccupancy.Update(BinaryCollisionArray, rect.x0, rect.y0, rect.x1, rect.y1);
+
+	LogDirtyRect(rect);
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileMap::LogDirtyRect(const NXTileDirtyRect& rect)
+ *
+ * \brief	Adds a changed rectangle to the log read by GetDirtyRectsSince.
+**************************************************************************************************/
+
+void NXTileMap::LogDirtyRect(const NXTileDirtyRect& rect)
+{
+	// Drop the older half once full, consumers that far behind rebuild everything
+	if (mDirtyRects.size() >= NXTILEMAP_DIRTY_LOG_SIZE)
+	{
+		const size_t drop = NXTILEMAP_DIRTY_LOG_SIZE / 2;
+		mDirtyRects.erase(mDirtyRects.begin(), mDirtyRects.begin() + drop);
+		mDirtyBase += drop;
+	}
+	mDirtyRects.push_back(rect);
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::GetDirtyRectsSince(size_t *Cursor,
+ * 			std::vector<NXTileDirtyRect>& Rects) const
+ *
+ * \brief	Gets the rectangles edited since a consumer last looked. Each consumer keeps its own
+ * 			cursor, starting from GetDirtyCursor.
+ *
+ * \param [in,out]	Cursor	The consumer's cursor, moved past the returned rectangles.
+ * \param [out]	Rects	 	The edited rectangles, appended in order.
+ *
+ * \return	false if the log no longer reaches back to the cursor (too many edits, or another
+ * 			map was loaded), the consumer must then rebuild everything.
+**************************************************************************************************/
+
+bool NXTileMap::GetDirtyRectsSince(size_t *Cursor, std::vector<NXTileDirtyRect>& Rects) const
+{
+	const size_t end = GetDirtyCursor();
+	if (*Cursor < mDirtyBase || *Cursor > end)
+	{
+		*Cursor = end;
+		return false;
+	}
+
+	Rects.insert(Rects.end(), mDirtyRects.begin() + (*Cursor - mDirtyBase), mDirtyRects.end());
+	*Cursor = end;
+	return true;
 }
 
 
@@ -120,7 +295,7 @@ int NXTileMap::GetCellValue(const int& X, const int& Y)
 int NXTileMap::CheckInstanceBinaryMapCollision(	const float& PosX,
 												const float& PosY, 
 												const float& scaleX,
-												const float& scaleY)
+												const float& scaleY) const
 {
 	float x1, y1, x2, y2;
 	float x3, y3, x4, y4;
@@ -183,6 +358,604 @@ int NXTileMap::CheckInstanceBinaryMapCollision(	const float& PosX,
 	return flag;
 }
 
+#if defined(__AVX2__)
+/**************************************************************************************************
+ * \fn	static __m256i TestHotspots(const int *Words, const NXBitGrid& Grid, __m256 X, __m256 Y)
+ *
+ * \brief	Tests 8 hotspots against the collision grid with one gather. Cells are truncated the
+ * 			same way as int(x) in GetCellValue and out of bound lanes are never loaded.
+ *
+ * \return	All ones in the lanes whose cell is solid.
+**************************************************************************************************/
+
+static __m256i TestHotspots(const int *Words, const NXBitGrid& Grid, __m256 X, __m256 Y)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i cellX = _mm256_cvttps_epi32(X);
+	const __m256i cellY = _mm256_cvttps_epi32(Y);
+
+	// 0 <= cell < size, as an unsigned compare
+	const __m256i bias = _mm256_set1_epi32(int(0x80000000));
+	const __m256i inX = _mm256_cmpgt_epi32(_mm256_set1_epi32(Grid.GetWidth() ^ int(0x80000000)),
+										   _mm256_xor_si256(cellX, bias));
+	const __m256i inY = _mm256_cmpgt_epi32(_mm256_set1_epi32(Grid.GetHeight() ^ int(0x80000000)),
+										   _mm256_xor_si256(cellY, bias));
+	const __m256i inside = _mm256_and_si256(inX, inY);
+
+	// Address the 64 bit words as pairs of 32 bit words
+	__m256i index, bit;
+	if (Grid.GetLayout() == NXBITGRID_ROW_MAJOR)
+	{
+		index = _mm256_add_epi32(_mm256_mullo_epi32(cellY, _mm256_set1_epi32(Grid.GetStride() * 2)),
+								 _mm256_srli_epi32(cellX, 5));
+		bit = _mm256_and_si256(cellX, _mm256_set1_epi32(31));
+	}
+	else
+	{
+		const __m256i block = _mm256_add_epi32(
+			_mm256_mullo_epi32(_mm256_srli_epi32(cellY, 3), _mm256_set1_epi32(Grid.GetStride())),
+			_mm256_srli_epi32(cellX, 3));
+		index = _mm256_add_epi32(_mm256_slli_epi32(block, 1),
+								 _mm256_and_si256(_mm256_srli_epi32(cellY, 2), _mm256_set1_epi32(1)));
+		bit = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(cellY, _mm256_set1_epi32(3)), 3),
+							  _mm256_and_si256(cellX, _mm256_set1_epi32(7)));
+	}
+	index = _mm256_and_si256(index, inside);
+
+	const __m256i words = _mm256_mask_i32gather_epi32(zero, Words, index, inside, 4);
+	const __m256i cell = _mm256_and_si256(_mm256_srlv_epi32(words, bit), _mm256_set1_epi32(1));
+	return _mm256_cmpgt_epi32(cell, zero);
+}
+#endif
+
+/**************************************************************************************************
+ * \fn	void NXTileMap::CheckInstanceBinaryMapCollision(const float *PosX, const float *PosY,
+ * 			const float *scaleX, const float *scaleY, int *Flags, size_t Count) const
+ *
+ * \brief	Batched version of CheckInstanceBinaryMapCollision for a whole manager. The inputs
+ * 			are separate arrays of Count elements and Flags[i] gets the same COLLISION_ bits the
+ * 			single version returns for object i. With AVX2 the 8 hotspots of 8 objects are
+ * 			tested with gathers. Only reads the map, so it is safe to call from several threads.
+ *
+ * \param	PosX		 	The X positions.
+ * \param	PosY		 	The Y positions.
+ * \param	scaleX		 	The X scales.
+ * \param	scaleY		 	The Y scales.
+ * \param [out]	Flags	The collision flags.
+ * \param	Count		 	Number of objects.
+**************************************************************************************************/
+
+void NXTileMap::CheckInstanceBinaryMapCollision(const float *PosX,
+												const float *PosY,
+												const float *scaleX,
+												const float *scaleY,
+												int *Flags,
+												size_t Count) const
+{
+	NX_PROFILE_ZONE("NXTileMap::CheckCollision");
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	const int *words = reinterpret_cast<const int*>(BinaryCollisionArray.GetWords());
+	if (words)
+	{
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 quarter = _mm256_set1_ps(0.25f);
+
+		for (; i + 8 <= Count; i += 8)
+		{
+			const __m256 x = _mm256_loadu_ps(PosX + i);
+			const __m256 y = _mm256_loadu_ps(PosY + i);
+			const __m256 hx = _mm256_mul_ps(_mm256_loadu_ps(scaleX + i), half);
+			const __m256 hy = _mm256_mul_ps(_mm256_loadu_ps(scaleY + i), half);
+			const __m256 qx = _mm256_mul_ps(_mm256_loadu_ps(scaleX + i), quarter);
+			const __m256 qy = _mm256_mul_ps(_mm256_loadu_ps(scaleY + i), quarter);
+
+			const __m256 right = _mm256_add_ps(x, hx), left = _mm256_sub_ps(x, hx);
+			const __m256 top = _mm256_add_ps(y, hy), bottom = _mm256_sub_ps(y, hy);
+			const __m256 upper = _mm256_add_ps(y, qy), lower = _mm256_sub_ps(y, qy);
+			const __m256 front = _mm256_add_ps(x, qx), back = _mm256_sub_ps(x, qx);
+
+			const __m256i hitRight = _mm256_or_si256(TestHotspots(words, BinaryCollisionArray, right, upper),
+													 TestHotspots(words, BinaryCollisionArray, right, lower));
+			const __m256i hitBottom = _mm256_or_si256(TestHotspots(words, BinaryCollisionArray, front, bottom),
+													  TestHotspots(words, BinaryCollisionArray, back, bottom));
+			const __m256i hitLeft = _mm256_or_si256(TestHotspots(words, BinaryCollisionArray, left, upper),
+													TestHotspots(words, BinaryCollisionArray, left, lower));
+			const __m256i hitTop = _mm256_or_si256(TestHotspots(words, BinaryCollisionArray, front, top),
+												   TestHotspots(words, BinaryCollisionArray, back, top));
+
+			__m256i flag = _mm256_and_si256(hitRight, _mm256_set1_epi32(COLLISION_RIGHT));
+			flag = _mm256_or_si256(flag, _mm256_and_si256(hitBottom, _mm256_set1_epi32(COLLISION_BOTTOM)));
+			flag = _mm256_or_si256(flag, _mm256_and_si256(hitLeft, _mm256_set1_epi32(COLLISION_LEFT)));
+			flag = _mm256_or_si256(flag, _mm256_and_si256(hitTop, _mm256_set1_epi32(COLLISION_TOP)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(Flags + i), flag);
+		}
+	}
+#endif
+
+	for (; i < Count; ++i)
+	{
+		Flags[i] = CheckInstanceBinaryMapCollision(PosX[i], PosY[i], scaleX[i], scaleY[i]);
+	}
+}
+
+
+/**************************************************************************************************
+ * \fn	static void SweepSpan(float Lo, float Hi, float Move, int *Cell0, int *Cell1)
+ *
+ * \brief	Cells covered by the box on the axis it is not stepping on. Faces that only touch a
+ * 			cell do not count, except on the side the box is moving towards so that a box passing
+ * 			exactly through a corner still sees the diagonal cell.
+**************************************************************************************************/
+
+static void SweepSpan(float Lo, float Hi, float Move, int *Cell0, int *Cell1)
+{
+	const float epsilon = 1e-4f;
+
+	Lo += (Move < 0) ? -epsilon : epsilon;
+	Hi += (Move > 0) ? epsilon : -epsilon;
+	*Cell0 = int(floorf(Lo));
+	*Cell1 = int(floorf(Hi));
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::SweepBinaryMapCollision(const float& PosX, const float& PosY,
+ * 			const float& scaleX, const float& scaleY, const float& MoveX, const float& MoveY,
+ * 			NXTileSweepHit *Hit) const
+ *
+ * \brief	Continuous version of CheckInstanceBinaryMapCollision. The object's box (same extents
+ * 			as the hotspots, scale/2 each way) is swept along the movement and the grid lines it
+ * 			crosses are walked in order (DDA), testing the row or column span the leading face
+ * 			enters against the bit grid. Nothing is skipped however large the movement is, so
+ * 			fast objects cannot tunnel through thin walls.\n
+ * 			Cells the box already overlaps at the start are ignored, those are resolved by the
+ * 			hotspot check as before.
+ *
+ * \param	PosX			The X position of the object.
+ * \param	PosY			The Y position of the object.
+ * \param	scaleX			The X scale of the object.
+ * \param	scaleY			The Y scale of the object.
+ * \param	MoveX			The X movement this frame (velocity * dt).
+ * \param	MoveY			The Y movement this frame (velocity * dt).
+ * \param [out]	Hit		The first contact, only written when there is one.
+ *
+ * \return	true if the box hits a solid cell before the end of the movement.
+**************************************************************************************************/
+
+bool NXTileMap::SweepBinaryMapCollision(const float& PosX,
+										const float& PosY,
+										const float& scaleX,
+										const float& scaleY,
+										const float& MoveX,
+										const float& MoveY,
+										NXTileSweepHit *Hit) const
+{
+	const float infinity = 1e30f;
+	const float minX = PosX - fabsf(scaleX)/2, maxX = PosX + fabsf(scaleX)/2;
+	const float minY = PosY - fabsf(scaleY)/2, maxY = PosY + fabsf(scaleY)/2;
+
+	// Next grid line the leading face crosses on each axis
+	int stepX = 0, stepY = 0, cellX = 0, cellY = 0;
+	float nextX = infinity, nextY = infinity, deltaX = infinity, deltaY = infinity;
+
+	if (MoveX > 0)
+	{
+		stepX = 1;
+		cellX = int(ceilf(maxX));
+		nextX = (cellX - maxX) / MoveX;
+		deltaX = 1.0f / MoveX;
+	}
+	else if (MoveX < 0)
+	{
+		stepX = -1;
+		cellX = int(floorf(minX)) - 1;
+		nextX = (cellX + 1 - minX) / MoveX;
+		deltaX = -1.0f / MoveX;
+	}
+
+	if (MoveY > 0)
+	{
+		stepY = 1;
+		cellY = int(ceilf(maxY));
+		nextY = (cellY - maxY) / MoveY;
+		deltaY = 1.0f / MoveY;
+	}
+	else if (MoveY < 0)
+	{
+		stepY = -1;
+		cellY = int(floorf(minY)) - 1;
+		nextY = (cellY + 1 - minY) / MoveY;
+		deltaY = -1.0f / MoveY;
+	}
+
+	for (;;)
+	{
+		// Nothing solid outside the map, stop walking an axis that has left it
+		if ((stepX > 0 && cellX >= BINARY_MAP_WIDTH) || (stepX < 0 && cellX < 0))
+		{
+			nextX = infinity;
+		}
+		if ((stepY > 0 && cellY >= BINARY_MAP_HEIGHT) || (stepY < 0 && cellY < 0))
+		{
+			nextY = infinity;
+		}
+
+		const float t = (nextX <= nextY) ? nextX : nextY;
+		if (t > 1.0f)
+		{
+			return false;
+		}
+
+		int from, to;
+		if (nextX <= nextY)
+		{
+			SweepSpan(minY + MoveY * t, maxY + MoveY * t, MoveY, &from, &to);
+			const int cell = BinaryCollisionArray.FindFirstInColumn(cellX, from, to);
+			if (cell >= 0)
+			{
+				Hit->time = t;
+				Hit->normalX = float(-stepX);
+				Hit->normalY = 0.0f;
+				Hit->cellX = cellX;
+				Hit->cellY = cell;
+				return true;
+			}
+			cellX += stepX;
+			nextX += deltaX;
+		}
+		else
+		{
+			SweepSpan(minX + MoveX * t, maxX + MoveX * t, MoveX, &from, &to);
+			const int cell = BinaryCollisionArray.FindFirstInRow(cellY, from, to);
+			if (cell >= 0)
+			{
+				Hit->time = t;
+				Hit->normalX = 0.0f;
+				Hit->normalY = float(-stepY);
+				Hit->cellX = cell;
+				Hit->cellY = cellY;
+				return true;
+			}
+			cellY += stepY;
+			nextY += deltaY;
+		}
+	}
+}
+
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::GetGroundBelow(const float& PosX, const float& PosY,
+ * 			float *Height) const
+ *
+ * \brief	Gets the height of the first walkable surface at or below a point, from the ground
+ * 			table built at load time instead of probing cells.
+ *
+ * \param	PosX			The X position.
+ * \param	PosY			The Y position.
+ * \param [out]	Height	The surface height.
+ *
+ * \return	false if there is no ground below the point.
+**************************************************************************************************/
+
+bool NXTileMap::GetGroundBelow(const float& PosX, const float& PosY, float *Height) const
+{
+	return mGroundTable.GetGroundBelow(int(floorf(PosX)), PosY, Height);
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::IsOnGround(const float& PosX, const float& PosY, const float& scaleX,
+ * 			const float& scaleY, const float& Tolerance) const
+ *
+ * \brief	Query if an object is standing on the ground, using the same two bottom hotspots as
+ * 			CheckInstanceBinaryMapCollision. With a Tolerance of 0 this is true exactly when the
+ * 			COLLISION_BOTTOM flag would be set inside the map, a larger one also accepts feet
+ * 			slightly above the surface.
+ *
+ * \param	PosX		The X position of the object.
+ * \param	PosY		The Y position of the object.
+ * \param	scaleX		The X scale of the object.
+ * \param	scaleY		The Y scale of the object.
+ * \param	Tolerance	How far above the surface still counts as on the ground.
+ *
+ * \return	true if on ground, false if not.
+**************************************************************************************************/
+
+bool NXTileMap::IsOnGround(const float& PosX,
+						   const float& PosY,
+						   const float& scaleX,
+						   const float& scaleY,
+						   const float& Tolerance) const
+{
+	const float feet = PosY - scaleY/2;
+	float height;
+
+	if (GetGroundBelow(PosX + scaleX/4, feet, &height) && feet - height < Tolerance)
+	{
+		return true;
+	}
+	if (GetGroundBelow(PosX - scaleX/4, feet, &height) && feet - height < Tolerance)
+	{
+		return true;
+	}
+	return false;
+}
+
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::OverlapsTerrain(const float& PosX, const float& PosY,
+ * 			const float& scaleX, const float& scaleY) const
+ *
+ * \brief	Broad phase test of an object's box against the merged solid rectangles, so large
+ * 			solid areas cost one test instead of one per cell.
+ *
+ * \param	PosX	The X position of the object.
+ * \param	PosY	The Y position of the object.
+ * \param	scaleX	The X scale of the object.
+ * \param	scaleY	The Y scale of the object.
+ *
+ * \return	true if the box overlaps any solid cell.
+**************************************************************************************************/
+
+bool NXTileMap::OverlapsTerrain(const float& PosX,
+								const float& PosY,
+								const float& scaleX,
+								const float& scaleY) const
+{
+	const float halfX = fabsf(scaleX)/2, halfY = fabsf(scaleY)/2;
+	return mSolidRects.Overlaps(PosX - halfX, PosY - halfY, PosX + halfX, PosY + halfY);
+}
+
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::Raycast(const float& FromX, const float& FromY, const float& ToX,
+ * 			const float& ToY, NXTileSweepHit *Hit) const
+ *
+ * \brief	Finds the first solid cell on a segment. The segment is walked cell by cell (DDA), but
+ * 			wherever the occupancy pyramid says the 8x8 or 64x64 block around the current cell is
+ * 			empty the whole block is crossed in one step, so a long ray over open space touches a
+ * 			few blocks instead of every cell.
+ *
+ * \param	FromX			The start x.
+ * \param	FromY			The start y.
+ * \param	ToX				The end x.
+ * \param	ToY				The end y.
+ * \param [out]	Hit		The first solid cell, time is the fraction of the segment. May be null.
+ *
+ * \return	true if the segment enters a solid cell before its end.
+**************************************************************************************************/
+
+bool NXTileMap::Raycast(const float& FromX,
+						const float& FromY,
+						const float& ToX,
+						const float& ToY,
+						NXTileSweepHit *Hit) const
+{
+	const float dx = ToX - FromX, dy = ToY - FromY;
+	const float width = float(BINARY_MAP_WIDTH), height = float(BINARY_MAP_HEIGHT);
+
+	// Clip the segment to the map, nothing outside it is solid
+	float t = 0.0f, tEnd = 1.0f;
+	const float from[2] = { FromX, FromY }, delta[2] = { dx, dy }, extent[2] = { width, height };
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		if (delta[axis] == 0.0f)
+		{
+			if (from[axis] < 0.0f || from[axis] >= extent[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+		float t0 = -from[axis] / delta[axis], t1 = (extent[axis] - from[axis]) / delta[axis];
+		if (t0 > t1)
+		{
+			const float swap = t0; t0 = t1; t1 = swap;
+		}
+		t = t0 > t ? t0 : t;
+		tEnd = t1 < tEnd ? t1 : tEnd;
+	}
+	if (t > tEnd)
+	{
+		return false;
+	}
+
+	const int stepX = dx > 0.0f ? 1 : dx < 0.0f ? -1 : 0;
+	const int stepY = dy > 0.0f ? 1 : dy < 0.0f ? -1 : 0;
+	int cellX = int(floorf(FromX + dx * t)), cellY = int(floorf(FromY + dy * t));
+	if (cellX >= BINARY_MAP_WIDTH) cellX = BINARY_MAP_WIDTH - 1;
+	if (cellY >= BINARY_MAP_HEIGHT) cellY = BINARY_MAP_HEIGHT - 1;
+	if (cellX < 0) cellX = 0;
+	if (cellY < 0) cellY = 0;
+	int normalX = 0, normalY = 0;
+
+	for (;;)
+	{
+		const int size = NXOCCUPANCY_BLOCK_SIZE[mStreamer ? 0 : mOccupancy.GetEmptyLevel(cellX, cellY)];
+		if (size == 1 && GetCellValue(cellX, cellY))
+		{
+			if (Hit)
+			{
+				Hit->time = t;
+				Hit->normalX = float(normalX);
+				Hit->normalY = float(normalY);
+				Hit->cellX = cellX;
+				Hit->cellY = cellY;
+			}
+			return true;
+		}
+
+		// Leave the block (or cell) through the first face the segment reaches
+		const int blockX = cellX - cellX % size, blockY = cellY - cellY % size;
+		const float tx = stepX > 0 ? (blockX + size - FromX) / dx : stepX < 0 ? (blockX - FromX) / dx : 2.0f;
+		const float ty = stepY > 0 ? (blockY + size - FromY) / dy : stepY < 0 ? (blockY - FromY) / dy : 2.0f;
+		const float tNext = tx < ty ? tx : ty;
+		if (tNext >= tEnd)
+		{
+			return false;
+		}
+
+		if (tx <= ty)
+		{
+			cellX = stepX > 0 ? blockX + size : blockX - 1;
+			normalX = -stepX;
+		}
+		else
+		{
+			cellX = int(floorf(FromX + dx * ty));
+			cellX = cellX < blockX ? blockX : cellX >= blockX + size ? blockX + size - 1 : cellX;
+			normalX = 0;
+		}
+		if (ty <= tx)
+		{
+			cellY = stepY > 0 ? blockY + size : blockY - 1;
+			normalY = -stepY;
+		}
+		else
+		{
+			cellY = int(floorf(FromY + dy * tx));
+			cellY = cellY < blockY ? blockY : cellY >= blockY + size ? blockY + size - 1 : cellY;
+			normalY = 0;
+		}
+		t = tNext;
+
+		if (unsigned(cellX) >= unsigned(BINARY_MAP_WIDTH) || unsigned(cellY) >= unsigned(BINARY_MAP_HEIGHT))
+		{
+			return false;
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::HasLineOfSight(const float& FromX, const float& FromY, const float& ToX,
+ * 			const float& ToY) const
+ *
+ * \brief	Query if no solid cell lies between two points, e.g. for ranged enemies deciding
+ * 			whether they can shoot.
+**************************************************************************************************/
+
+bool NXTileMap::HasLineOfSight(const float& FromX,
+							   const float& FromY,
+							   const float& ToX,
+							   const float& ToY) const
+{
+	return !Raycast(FromX, FromY, ToX, ToY, 0);
+}
+
+/**************************************************************************************************
+ * \fn	static float BlockDistance2(float PosX, float PosY, int X0, int Y0, int X1, int Y1)
+ *
+ * \brief	Squared distance from a point to the cells X0 to X1, Y0 to Y1, 0 if inside.
+**************************************************************************************************/
+
+static float BlockDistance2(float PosX, float PosY, int X0, int Y0, int X1, int Y1)
+{
+	const float dx = PosX < X0 ? X0 - PosX : PosX > X1 + 1 ? PosX - (X1 + 1) : 0.0f;
+	const float dy = PosY < Y0 ? Y0 - PosY : PosY > Y1 + 1 ? PosY - (Y1 + 1) : 0.0f;
+	return dx * dx + dy * dy;
+}
+
+//Block waiting in FindNearestFreeCell, nearest first
+struct FreeCellNode
+{
+	float distance;		//Squared distance from the point to the block
+	int level;
+	int x;				//First cell of the block
+	int y;
+	bool operator<(const FreeCellNode& rhs) const { return distance > rhs.distance; }
+};
+
+/**************************************************************************************************
+ * \fn	bool NXTileMap::FindNearestFreeCell(const float& PosX, const float& PosY,
+ * 			const float& MaxDistance, int *CellX, int *CellY) const
+ *
+ * \brief	Finds the empty cell closest to a point, e.g. to spawn something that would otherwise
+ * 			end up inside a wall. Best first search over the occupancy pyramid: blocks are visited
+ * 			by their distance to the point, full blocks are dropped whole and the first empty block
+ * 			reached holds the answer, so only mixed blocks near the point are opened.
+ *
+ * \param	PosX			The X position.
+ * \param	PosY			The Y position.
+ * \param	MaxDistance		How far from the point to search.
+ * \param [out]	CellX	The free cell x.
+ * \param [out]	CellY	The free cell y.
+ *
+ * \return	false if there is no free cell within MaxDistance.
+**************************************************************************************************/
+
+bool NXTileMap::FindNearestFreeCell(const float& PosX,
+									const float& PosY,
+									const float& MaxDistance,
+									int *CellX,
+									int *CellY) const
+{
+	const float maxDistance2 = MaxDistance * MaxDistance;
+	std::priority_queue<FreeCellNode> open;
+
+	const int top = (mStreamer || !mOccupancy.IsBuilt()) ? 0 : NXOCCUPANCY_LEVELS - 1;
+	const int topSize = NXOCCUPANCY_BLOCK_SIZE[top];
+	int x0 = int(floorf(PosX - MaxDistance)), x1 = int(floorf(PosX + MaxDistance));
+	int y0 = int(floorf(PosY - MaxDistance)), y1 = int(floorf(PosY + MaxDistance));
+	x0 = x0 < 0 ? 0 : x0 / topSize;
+	y0 = y0 < 0 ? 0 : y0 / topSize;
+	x1 = (x1 >= BINARY_MAP_WIDTH ? BINARY_MAP_WIDTH - 1 : x1) / topSize;
+	y1 = (y1 >= BINARY_MAP_HEIGHT ? BINARY_MAP_HEIGHT - 1 : y1) / topSize;
+
+	for (int by = y0; by <= y1; ++by)
+	{
+		for (int bx = x0; bx <= x1; ++bx)
+		{
+			const FreeCellNode node = { BlockDistance2(PosX, PosY, bx * topSize, by * topSize,
+											   bx * topSize + topSize - 1, by * topSize + topSize - 1),
+								top, bx * topSize, by * topSize };
+			if (node.distance <= maxDistance2)
+			{
+				open.push(node);
+			}
+		}
+	}
+
+	while (!open.empty())
+	{
+		const FreeCellNode node = open.top();
+		open.pop();
+
+		const int size = NXOCCUPANCY_BLOCK_SIZE[node.level];
+		const int endX = node.x + size < BINARY_MAP_WIDTH ? node.x + size : BINARY_MAP_WIDTH;
+		const int endY = node.y + size < BINARY_MAP_HEIGHT ? node.y + size : BINARY_MAP_HEIGHT;
+		const int state = node.level == 0 ? (GetCellValue(node.x, node.y) ? NXOCCUPANCY_FULL : NXOCCUPANCY_EMPTY)
+										  : mOccupancy.GetState(node.level, node.x, node.y);
+
+		if (state == NXOCCUPANCY_EMPTY)
+		{
+			// The cell of the block closest to the point
+			const int x = int(floorf(PosX)), y = int(floorf(PosY));
+			*CellX = x < node.x ? node.x : x >= endX ? endX - 1 : x;
+			*CellY = y < node.y ? node.y : y >= endY ? endY - 1 : y;
+			return true;
+		}
+		if (state == NXOCCUPANCY_FULL)
+		{
+			continue;
+		}
+
+		const int childSize = NXOCCUPANCY_BLOCK_SIZE[node.level - 1];
+		for (int cy = node.y; cy < endY; cy += childSize)
+		{
+			for (int cx = node.x; cx < endX; cx += childSize)
+			{
+				const FreeCellNode child = { BlockDistance2(PosX, PosY, cx, cy, cx + childSize - 1, cy + childSize - 1),
+									 node.level - 1, cx, cy };
+				if (child.distance <= maxDistance2)
+				{
+					open.push(child);
+				}
+			}
+		}
+	}
+	return false;
+}
+
 
 /******************************************************************************/
 /*!
@@ -202,6 +975,164 @@ void NXTileMap::SnapToCell(float *Coordinate)
 	*Coordinate = float(int(*Coordinate))+0.5f;
 }
 
+/**************************************************************************************************
+ * \fn	static bool IsCompiledMapCurrent(const char *FileName, const char *CacheName)
+ *
+ * \brief	Query if the compiled cache exists and is not older than the xml map.
+**************************************************************************************************/
+
+static bool IsCompiledMapCurrent(const char *FileName, const char *CacheName)
+{
+	time_t xmlTime = 0, cacheTime = 0;
+	bool hasXml = NXMappedFile::GetModifiedTime(FileName, &xmlTime);
+	bool hasCache = NXMappedFile::GetModifiedTime(CacheName, &cacheTime);
+
+	return hasCache && (!hasXml || cacheTime >= xmlTime);
+}
+
+/**************************************************************************************************
+ * \fn	int NXTileMap::LoadMapData(char *FileName)
+ *
+ * \brief	Loads a map, using the compiled cache next to the xml file when it is up to date.
+ * 			The xml file is always the source of truth, if it is newer than the cache (or the
+ * 			cache is missing or unreadable) it is imported and the cache is rewritten first.
+ *
+ * \param [in]	FileName	Name of the xml map file.
+ *
+ * \return	1 if the map was loaded, 0 otherwise.
+**************************************************************************************************/
+
+int NXTileMap::LoadMapData(char *FileName)
+{
+	std::string cacheName = std::string(FileName) + NXTILEMAP_FILE_EXTENSION;
+
+	if (IsCompiledMapCurrent(FileName, cacheName.c_str()))
+	{
+		if (OpenCompiledMapData(cacheName.c_str()) &&
+			BinaryCollisionArray.GetLayout() == mCollisionLayout)
+		{
+			return 1;
+		}
+	}
+
+	// Cache is stale, compile it from the xml
+	if (!ImportMapDataFromFile(FileName))
+	{
+		return 0;
+	}
+
+	if (!CompileMapDataToFile(cacheName.c_str()))
+	{
+		// Still playable from the imported data
+		NX_MESG("Unable to write compiled map cache!");
+		return 1;
+	}
+
+	// Prefer the mapping so the heap copy is not kept around
+	FreeMapData();
+	if (!OpenCompiledMapData(cacheName.c_str()))
+	{
+		return ImportMapDataFromFile(FileName);
+	}
+	return 1;
+}
+
+/**************************************************************************************************
+ * \fn	int NXTileMap::StreamMapData(char *FileName, size_t MemoryBudget, float PrefetchMargin,
+ * 			int DefaultValue)
+ *
+ * \brief	Opens a map for streaming instead of loading it whole. The compiled cache is brought
+ * 			up to date like LoadMapData and compiled again once if it cannot be opened. Only the
+ * 			chunks around the camera are kept resident, loaded on a background thread. Peak
+ * 			memory is set by MemoryBudget and does not grow with the level length.\n
+ * 			While streaming, GetCellValue and the collision checks see cells of chunks that are
+ * 			not loaded yet as DefaultValue and GetTileValue sees them as empty. GetMapData,
+ * 			GetCollisionData, the sweep and the ground queries need a resident map and see an
+ * 			empty one.
+ *
+ * \param [in]	FileName		Name of the xml map file.
+ * \param	MemoryBudget		Maximum bytes of chunk data.
+ * \param	PrefetchMargin		Cells loaded around the view ahead of the camera.
+ * \param	DefaultValue		Collision value of cells not loaded yet, 1 keeps objects from
+ * 								falling through chunks that arrive late.
+ *
+ * \return	1 if the map was opened, 0 otherwise.
+**************************************************************************************************/
+
+int NXTileMap::StreamMapData(char *FileName, size_t MemoryBudget, float PrefetchMargin, int DefaultValue)
+{
+	std::string cacheName = std::string(FileName) + NXTILEMAP_FILE_EXTENSION;
+	bool isCompiled = false;
+
+	if (!IsCompiledMapCurrent(FileName, cacheName.c_str()))
+	{
+		if (!ImportMapDataFromFile(FileName) || !CompileMapDataToFile(cacheName.c_str()))
+		{
+			FreeMapData();
+			return 0;
+		}
+		isCompiled = true;
+	}
+
+	FreeMapData();
+
+	NXTileStreamer *streamer = new NXTileStreamer;
+	bool isOpen = streamer->Open(cacheName.c_str(), MemoryBudget, DefaultValue);
+	if (!isOpen && !isCompiled)
+	{
+		// Newer than the xml but unreadable (older format, truncated), compile it again once
+		if (ImportMapDataFromFile(FileName) && CompileMapDataToFile(cacheName.c_str()))
+		{
+			isOpen = streamer->Open(cacheName.c_str(), MemoryBudget, DefaultValue);
+		}
+		FreeMapData();
+	}
+	if (!isOpen)
+	{
+		delete streamer;
+		return 0;
+	}
+	mStreamer = streamer;
+
+	BINARY_MAP_WIDTH = mStreamer->GetWidth();
+	BINARY_MAP_HEIGHT = mStreamer->GetHeight();
+	mStreamMargin = PrefetchMargin;
+	UpdateStreaming();
+	return 1;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileMap::UpdateStreaming( void )
+ *
+ * \brief	Moves the resident window of a streamed map to follow gCamera. Call once per frame.
+ * 			Chunks that arrived are logged like edits, so caches built from cells that were
+ * 			not resident yet (render chunks, flow fields) are rebuilt.
+**************************************************************************************************/
+
+void NXTileMap::UpdateStreaming( void )
+{
+	if (mStreamer == 0)
+	{
+		return;
+	}
+
+	const Vec3 camera = gCamera.GetPosition();
+	const float halfView = float(gEngine.GetFovX());
+	mStreamer->Update(camera.x, camera.y, halfView, halfView, mStreamMargin);
+
+	const std::vector<int>& installed = mStreamer->GetInstalled();
+	const int chunksX = (BINARY_MAP_WIDTH + NXTILESTREAM_CHUNK_SIZE - 1) / NXTILESTREAM_CHUNK_SIZE;
+	for (size_t i = 0; i < installed.size(); ++i)
+	{
+		NXTileDirtyRect rect;
+		rect.x0 = (installed[i] % chunksX) * NXTILESTREAM_CHUNK_SIZE;
+		rect.y0 = (installed[i] / chunksX) * NXTILESTREAM_CHUNK_SIZE;
+		rect.x1 = std::min(rect.x0 + NXTILESTREAM_CHUNK_SIZE, BINARY_MAP_WIDTH) - 1;
+		rect.y1 = std::min(rect.y0 + NXTILESTREAM_CHUNK_SIZE, BINARY_MAP_HEIGHT) - 1;
+		LogDirtyRect(rect);
+	}
+}
+
 /******************************************************************************/
 /*!
 \brief
@@ -237,12 +1168,13 @@ void NXTileMap::SnapToCell(float *Coordinate)
 	and\n
 	\n
 	1 1 1 1 1\n
+	1 1 1 1 1\n
 	1 1 1 0 1\n
 	1 0 0 0 1\n
-	1 0 0 0 1\n
 	1 1 1 1 1\n
 	\n
-	respectively.\n
+	respectively. Every non zero tile is solid, the collision array only
+	keeps one bit per cell.\n
 	\n
 	Finally, the function returns 1 if the file named "FileName" exists, 
 	otherwise it returns 0\n
@@ -286,28 +1218,38 @@ int NXTileMap::ImportMapDataFromFile(char *FileName)
 
 	// Load map array
 	const char *mapText = Map->GetText();
-	
-	char buffer[512];
-	sprintf_s(buffer,"%s",mapText);	
-	
+	if (mapText == 0 || BINARY_MAP_WIDTH <= 0 || BINARY_MAP_HEIGHT <= 0)
+	{
+		NX_MESG("Map has no data!");
+		doc.Clear();
+		return 0;
+	}
+
+	FreeMapData();
+
 	// Allocate memory for map and binary
 	MapData = new int[BINARY_MAP_WIDTH*BINARY_MAP_HEIGHT];
-	BinaryCollisionArray = new int[BINARY_MAP_WIDTH*BINARY_MAP_HEIGHT];
+	memset(MapData, 0, sizeof(int)*BINARY_MAP_WIDTH*BINARY_MAP_HEIGHT);
+	BinaryCollisionArray.Init(BINARY_MAP_WIDTH, BINARY_MAP_HEIGHT, mCollisionLayout);
 
-	// store map data
-	int i = 0, j=0;
-	while(buffer[i] != NULL)
+	// store map data, read straight from the element text so maps are
+	// not limited by the size of a copy buffer
+	int i = 0, j = 0;
+	while(mapText[i] != 0 && j < BINARY_MAP_WIDTH*BINARY_MAP_HEIGHT)
 	{
-		if(buffer[i] != ' ')
+		if(mapText[i] >= '0' && mapText[i] <= '9')
 		{
-			MapData[j] = buffer[i] - '0';
-			BinaryCollisionArray[j] = buffer[i] - '0';
+			MapData[j] = mapText[i] - '0';
+			BinaryCollisionArray.Set(j % BINARY_MAP_WIDTH, j / BINARY_MAP_WIDTH, 
+									 MapData[j] != 0);
 			++j;
 		}
 			++i;
 	}
-	
-	
+
+	mGroundTable.Build(BinaryCollisionArray);
+	mSolidRects.Build(BinaryCollisionArray);
+	mOccupancy.Build(BinaryCollisionArray);
 
 	//free tinyxml doc memory
 	doc.Clear();		
@@ -327,18 +1269,32 @@ int * NXTileMap::GetMapData( void ) const
 }
 
 /**************************************************************************************************
- * \fn	int * NXTileMap::GetCollisionData( void ) const
+ * \fn	const NXBitGrid& NXTileMap::GetCollisionData( void ) const
  *
- * \brief	Gets the collision data.
+ * \brief	Gets the collision data, one bit per cell.
  *
- * \return	null if it fails, else the collision data.
+ * \return	The collision grid, empty if no map is loaded.
 **************************************************************************************************/
 
-int * NXTileMap::GetCollisionData( void ) const
+const NXBitGrid& NXTileMap::GetCollisionData( void ) const
 {
 	return BinaryCollisionArray;
 }
 
+/**************************************************************************************************
+ * \fn	void NXTileMap::SetCollisionLayout(NXBITGRID_LAYOUT Layout)
+ *
+ * \brief	Sets the collision grid layout used by the next load. The 8x8 block layout keeps
+ * 			neighbouring rows in the same word, which suits column and area queries.
+ *
+ * \param	Layout	The layout.
+**************************************************************************************************/
+
+void NXTileMap::SetCollisionLayout(NXBITGRID_LAYOUT Layout)
+{
+	mCollisionLayout = Layout;
+}
+
 /**************************************************************************************************
  * \fn	int NXTileMap::GetWidth( void ) const
  *
@@ -377,12 +1333,156 @@ int  NXTileMap::GetHeight( void ) const
 /******************************************************************************/
 void NXTileMap::FreeMapData( void )
 {
-	if(MapData)
-		delete [] MapData;
+	if (isMapped)
+	{
+		mMappedFile.Close();
+		isMapped = false;
+	}
+	else
+	{
+		if(MapData)
+			delete [] MapData;
+	}
+
+	if (mStreamer)
+	{
+		delete mStreamer;
+		mStreamer = 0;
+	}
+
+	MapData = 0;
+	BinaryCollisionArray.Free();
+
+	// Leave every consumer's cursor behind so they rebuild for the next map
+	mDirtyBase += mDirtyRects.size() + 1;
+	mDirtyRects.clear();
+	mEditDepth = 0;
+	hasEdit = false;
+
+	mGroundTable.Free();
+	mSolidRects.Free();
+	mOccupancy.Free();
+}
+
+/**************************************************************************************************
+ * \fn	int NXTileMap::CompileMapDataToFile(const char *FileName) const
+ *
+ * \brief	Writes the loaded map in the compiled format, a NXTileMapFileHeader followed by the
+ * 			tile plane and the collision plane. Can be run offline over every level or on
+ * 			first run by LoadMapData.
+ *
+ * \param	FileName	Name of the compiled file.
+ *
+ * \return	1 if the file was written, 0 otherwise.
+**************************************************************************************************/
+
+int NXTileMap::CompileMapDataToFile(const char *FileName) const
+{
+	if (MapData == 0 || BinaryCollisionArray.GetWords() == 0)
+	{
+		return 0;
+	}
+
+	const unsigned planeSize = sizeof(int) * BINARY_MAP_WIDTH * BINARY_MAP_HEIGHT;
+	const unsigned collisionSize = unsigned(sizeof(NXBitWord) * BinaryCollisionArray.GetWordCount());
 
-	if(BinaryCollisionArray)
-		delete [] BinaryCollisionArray;
+	NXTileMapFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, NXTILEMAP_FILE_MAGIC, sizeof(header.magic));
+	header.version = NXTILEMAP_FILE_VERSION;
+	header.width = BINARY_MAP_WIDTH;
+	header.height = BINARY_MAP_HEIGHT;
+	header.tileOffset = (sizeof(header) + 15) & ~15u;
+	header.collisionOffset = (header.tileOffset + planeSize + 15) & ~15u;
+	header.collisionLayout = BinaryCollisionArray.GetLayout();
+
+	// Write to a temporary file first so a crash never leaves a torn cache
+	std::string tempName = std::string(FileName) + ".tmp";
+	FILE *file = fopen(tempName.c_str(), "wb");
+	if (file == 0)
+	{
+		return 0;
+	}
+
+	const char padding[16] = {0};
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	ok = ok && fwrite(padding, header.tileOffset - sizeof(header), 1, file) <= 1;
+	ok = ok && fwrite(MapData, planeSize, 1, file) == 1;
+	ok = ok && fwrite(padding, header.collisionOffset - header.tileOffset - planeSize, 1, file) <= 1;
+	ok = ok && fwrite(BinaryCollisionArray.GetWords(), collisionSize, 1, file) == 1;
+	ok = (fclose(file) == 0) && ok;
+
+	if (!ok)
+	{
+		remove(tempName.c_str());
+		return 0;
+	}
+
+	remove(FileName);
+	if (rename(tempName.c_str(), FileName) != 0)
+	{
+		remove(tempName.c_str());
+		return 0;
+	}
+	return 1;
 }
 
+/**************************************************************************************************
+ * \fn	int NXTileMap::OpenCompiledMapData(const char *FileName)
+ *
+ * \brief	Maps a compiled map file and uses its planes in place, nothing is parsed or copied.
+ *
+ * \param	FileName	Name of the compiled file.
+ *
+ * \return	1 if the file is a valid compiled map, 0 otherwise.
+**************************************************************************************************/
+
+int NXTileMap::OpenCompiledMapData(const char *FileName)
+{
+	FreeMapData();
+
+	if (!mMappedFile.Open(FileName))
+	{
+		return 0;
+	}
+
+	const size_t fileSize = mMappedFile.GetSize();
+	char *base = static_cast<char*>(mMappedFile.GetData());
+	const NXTileMapFileHeader *header = reinterpret_cast<const NXTileMapFileHeader*>(base);
 
+	bool valid = fileSize >= sizeof(NXTileMapFileHeader) &&
+				 memcmp(header->magic, NXTILEMAP_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+				 header->version == NXTILEMAP_FILE_VERSION &&
+				 header->width > 0 && header->height > 0 &&
+				 header->collisionLayout <= NXBITGRID_BLOCK_8X8;
+
+	if (valid)
+	{
+		const NXBITGRID_LAYOUT layout = NXBITGRID_LAYOUT(header->collisionLayout);
+		const size_t planeSize = sizeof(int) * size_t(header->width) * size_t(header->height);
+		const size_t collisionSize = sizeof(NXBitWord) * 
+			NXBitGrid::GetWordCount(header->width, header->height, layout);
+		valid = (header->tileOffset & 15) == 0 && (header->collisionOffset & 15) == 0 &&
+				header->tileOffset + planeSize <= fileSize &&
+				header->collisionOffset + collisionSize <= fileSize;
+	}
 
+	if (!valid)
+	{
+		NX_MESG("Compiled map file is invalid or out of date!");
+		mMappedFile.Close();
+		return 0;
+	}
+
+	BINARY_MAP_WIDTH = header->width;
+	BINARY_MAP_HEIGHT = header->height;
+	MapData = reinterpret_cast<int*>(base + header->tileOffset);
+	BinaryCollisionArray.Attach(reinterpret_cast<NXBitWord*>(base + header->collisionOffset),
+								header->width, header->height, 
+								NXBITGRID_LAYOUT(header->collisionLayout));
+	isMapped = true;
+	mGroundTable.Build(BinaryCollisionArray);
+	mSolidRects.Build(BinaryCollisionArray);
+	mOccupancy.Build(BinaryCollisionArray);
+	return 1;
+}
@@ -17,9 +17,56 @@
 * 			Institute of Technology is prohibited.
 **************************************************************************************************/
 #include "NXMaths.h"
+#include "NXMappedFile.h"
+#include "NXBitGrid.h"
+#include "NXGroundTable.h"
+#include "NXTileRects.h"
+#include "NXOccupancyPyramid.h"
+#include "NXTileStreamer.h"
+#include <vector>
 
 #ifndef NXTILE_H_
 #define NXTILE_H_
+
+//Compiled map file, written by CompileMapDataToFile and mapped in place by
+//OpenCompiledMapData. Native endian, planes are 16 byte aligned.
+const char		NXTILEMAP_FILE_MAGIC[4] = { 'N', 'X', 'T', 'M' };
+const unsigned	NXTILEMAP_FILE_VERSION  = 2;
+const char		NXTILEMAP_FILE_EXTENSION[] = ".nxmap";
+
+struct NXTileMapFileHeader
+{
+	char		magic[4];
+	unsigned	version;
+	int			width;
+	int			height;
+	unsigned	tileOffset;			//Byte offset of the tile id plane (int per cell)
+	unsigned	collisionOffset;	//Byte offset of the collision plane (NXBitGrid words)
+	unsigned	collisionLayout;	//NXBITGRID_LAYOUT of the collision plane
+	unsigned	reserved;
+};
+
+//Result of a swept tile collision query
+struct NXTileSweepHit
+{
+	float time;		//Fraction of the movement (0-1) at which the box touches the cell
+	float normalX;	//Normal of the face that was hit, -1, 0 or 1
+	float normalY;
+	int cellX;		//The solid cell that was hit
+	int cellY;
+};
+
+//Rectangle of edited cells, inclusive
+struct NXTileDirtyRect
+{
+	int x0;
+	int y0;
+	int x1;
+	int y1;
+};
+
+const size_t NXTILEMAP_DIRTY_LOG_SIZE = 256;	//Dirty rectangles kept for consumers to catch up on
+
 class NXTileMap
 {
 	enum BLOCKTYPE
@@ -31,24 +78,92 @@ class NXTileMap
 	public:
 		NXTileMap( void );
 		~NXTileMap( void );
-		int	GetCellValue(const int& X, const int& Y);
+		int	GetCellValue(const int& X, const int& Y) const;
 		int	CheckInstanceBinaryMapCollision(const float& PosX,
 											const float& PosY, 
 											const float& scaleX,
-											const float& scaleY);
+											const float& scaleY) const;
+		void CheckInstanceBinaryMapCollision(const float *PosX,
+											 const float *PosY,
+											 const float *scaleX,
+											 const float *scaleY,
+											 int *Flags,
+											 size_t Count) const;
+		bool SweepBinaryMapCollision(const float& PosX,
+									 const float& PosY,
+									 const float& scaleX,
+									 const float& scaleY,
+									 const float& MoveX,
+									 const float& MoveY,
+									 NXTileSweepHit *Hit) const;
+		bool GetGroundBelow(const float& PosX, const float& PosY, float *Height) const;
+		bool IsOnGround(const float& PosX,
+						const float& PosY,
+						const float& scaleX,
+						const float& scaleY,
+						const float& Tolerance = 0.0f) const;
+		const NXGroundTable& GetGroundTable( void ) const { return mGroundTable; }
+		bool OverlapsTerrain(const float& PosX,
+							 const float& PosY,
+							 const float& scaleX,
+							 const float& scaleY) const;
+		const NXTileRects& GetSolidRects( void ) const { return mSolidRects; }
+		bool Raycast(const float& FromX,
+					 const float& FromY,
+					 const float& ToX,
+					 const float& ToY,
+					 NXTileSweepHit *Hit) const;
+		bool HasLineOfSight(const float& FromX,
+							const float& FromY,
+							const float& ToX,
+							const float& ToY) const;
+		bool FindNearestFreeCell(const float& PosX,
+								 const float& PosY,
+								 const float& MaxDistance,
+								 int *CellX,
+								 int *CellY) const;
+		const NXOccupancyPyramid& GetOccupancy( void ) const { return mOccupancy; }
 		void SnapToCell(float *Coordinate);
+		int	LoadMapData(char *FileName);
+		int	StreamMapData(char *FileName, size_t MemoryBudget, float PrefetchMargin = 32.0f, int DefaultValue = 0);
+		void UpdateStreaming( void );
+		bool IsStreaming( void ) const { return mStreamer != 0; }
+		int	GetTileValue(const int& X, const int& Y) const;
+		int	SetCellValue(const int& X, const int& Y, const int& Tile);
+		void BeginEdit( void );
+		void EndEdit( void );
+		size_t GetDirtyCursor( void ) const { return mDirtyBase + mDirtyRects.size(); }
+		bool GetDirtyRectsSince(size_t *Cursor, std::vector<NXTileDirtyRect>& Rects) const;
 		int	ImportMapDataFromFile(char *FileName);
+		int	CompileMapDataToFile(const char *FileName) const;
+		int	OpenCompiledMapData(const char *FileName);
 		void FreeMapData( void );
 		int * GetMapData( void ) const;
-		int * GetCollisionData( void ) const;
+		const NXBitGrid& GetCollisionData( void ) const;
+		void SetCollisionLayout(NXBITGRID_LAYOUT Layout);
 		int  GetWidth( void ) const;
 		int  GetHeight( void ) const;
 
 	private:
+		void LogDirtyRect(const NXTileDirtyRect& rect);
+
 		int BINARY_MAP_WIDTH;
 		int BINARY_MAP_HEIGHT;
 		int *MapData;
-		int *BinaryCollisionArray;
+		NXBitGrid BinaryCollisionArray;
+		NXBITGRID_LAYOUT mCollisionLayout;
+		NXGroundTable mGroundTable;
+		NXTileRects mSolidRects;
+		NXOccupancyPyramid mOccupancy;
+		NXMappedFile mMappedFile;
+		bool isMapped;
+		NXTileStreamer *mStreamer;
+		float mStreamMargin;
+		int mEditDepth;
+		bool hasEdit;
+		NXTileDirtyRect mEditRect;
+		std::vector<NXTileDirtyRect> mDirtyRects;
+		size_t mDirtyBase;
 };
 
 extern NXTileMap gCollisionTile;
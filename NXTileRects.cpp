@@ -0,0 +1,482 @@
+/**************************************************************************************************
+* \file	    NXTileRects.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Solid tiles merged into axis aligned rectangles\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXTileRects.h"
+#include "NXEngineMain.h"
+#include "NXRenderDevice.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	struct GridSolid
+	{
+		const NXBitGrid& grid;
+		GridSolid(const NXBitGrid& g) : grid(g) {}
+		int operator()(int X, int Y) const { return grid.Get(X, Y) ? 1 : 0; }
+	private:
+		GridSolid& operator=(const GridSolid&);
+	};
+
+	struct TileSolid
+	{
+		const int *tiles;
+		int width;
+		TileSolid(const int *t, int w) : tiles(t), width(w) {}
+		int operator()(int X, int Y) const { return tiles[X + Y * width]; }
+	};
+}
+
+/**************************************************************************************************
+ * \fn	NXTileRects::NXTileRects( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXTileRects::NXTileRects( void ) :
+	mWidth(0),
+	mHeight(0),
+	mBucketsX(0),
+	mBucketsY(0)
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXTileRects::~NXTileRects( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXTileRects::~NXTileRects( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::Build(const NXBitGrid& Grid)
+ *
+ * \brief	Merges the solid cells of a collision grid into rectangles.
+ *
+ * \param	Grid	The collision grid.
+**************************************************************************************************/
+
+void NXTileRects::Build(const NXBitGrid& Grid)
+{
+	Merge(Grid.GetWidth(), Grid.GetHeight(), GridSolid(Grid));
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::BuildFromTiles(const int *Tiles, int Width, int Height)
+ *
+ * \brief	Merges cells with the same non zero tile id into rectangles, each rectangle can be
+ * 			drawn as one quad of its tile.
+ *
+ * \param	Tiles 	The tile ids, row major.
+ * \param	Width 	The map width.
+ * \param	Height	The map height.
+**************************************************************************************************/
+
+void NXTileRects::BuildFromTiles(const int *Tiles, int Width, int Height)
+{
+	Merge(Width, Height, TileSolid(Tiles, Width));
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::Free( void )
+ *
+ * \brief	Releases the rectangles.
+**************************************************************************************************/
+
+void NXTileRects::Free( void )
+{
+	std::vector<Rect>().swap(mRects);
+	std::vector< std::vector<int> >().swap(mBuckets);
+	std::vector<int>().swap(mFreeSlots);
+	mWidth = mHeight = 0;
+	mBucketsX = mBucketsY = 0;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::RebuildRegion(const NXBitGrid& Grid, int X0, int Y0, int X1, int Y1)
+ *
+ * \brief	Updates the rectangles after the cells X0 to X1, Y0 to Y1 of the collision grid were
+ * 			edited.
+**************************************************************************************************/
+
+void NXTileRects::RebuildRegion(const NXBitGrid& Grid, int X0, int Y0, int X1, int Y1)
+{
+	if (Grid.GetWidth() != mWidth || Grid.GetHeight() != mHeight)
+	{
+		Build(Grid);
+		return;
+	}
+	RebuildWindow(X0, Y0, X1, Y1, GridSolid(Grid));
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::RebuildTilesRegion(const int *Tiles, int X0, int Y0, int X1, int Y1)
+ *
+ * \brief	Updates the rectangles after the tile ids X0 to X1, Y0 to Y1 were edited. The map
+ * 			size is the one given to BuildFromTiles.
+**************************************************************************************************/
+
+void NXTileRects::RebuildTilesRegion(const int *Tiles, int X0, int Y0, int X1, int Y1)
+{
+	RebuildWindow(X0, Y0, X1, Y1, TileSolid(Tiles, mWidth));
+}
+
+/**************************************************************************************************
+ * \fn	template <class Solid> void NXTileRects::Merge(int Width, int Height, const Solid& solid)
+ *
+ * \brief	Replaces every rectangle by merging the whole map.
+**************************************************************************************************/
+
+template <class Solid>
+void NXTileRects::Merge(int Width, int Height, const Solid& solid)
+{
+	Free();
+	if (Width <= 0 || Height <= 0)
+	{
+		return;
+	}
+
+	mWidth = Width;
+	mHeight = Height;
+	mBucketsX = (Width + NXTILERECTS_BUCKET_SIZE - 1) / NXTILERECTS_BUCKET_SIZE;
+	mBucketsY = (Height + NXTILERECTS_BUCKET_SIZE - 1) / NXTILERECTS_BUCKET_SIZE;
+	mBuckets.resize(size_t(mBucketsX) * mBucketsY);
+
+	NXBitGrid covered;
+	covered.Init(Width, Height);
+	MergeWindow(0, 0, Width, Height, solid, covered);
+}
+
+/**************************************************************************************************
+ * \fn	template <class Solid> void NXTileRects::MergeWindow(int X0, int Y0, int X1, int Y1,
+ * 			const Solid& solid, NXBitGrid& covered)
+ *
+ * \brief	Greedy meshing of the cells X0 to X1 - 1, Y0 to Y1 - 1. From each cell not yet
+ * 			covered, grow a rectangle as far right as the row allows, then up one row at a time
+ * 			while the whole span matches.
+ *
+ * \param	X0			 	The window left.
+ * \param	Y0			 	The window bottom.
+ * \param	X1			 	One past the window right.
+ * \param	Y1			 	One past the window top.
+ * \param	solid		 	Tile of a cell, 0 for none.
+ * \param [in,out]	covered	Cells of the window already in a rectangle, relative to X0, Y0.
+**************************************************************************************************/
+
+template <class Solid>
+void NXTileRects::MergeWindow(int X0, int Y0, int X1, int Y1, const Solid& solid, NXBitGrid& covered)
+{
+	for (int y = Y0; y < Y1; ++y)
+	{
+		for (int x = X0; x < X1; ++x)
+		{
+			const int tile = solid(x, y);
+			if (tile == 0 || covered.Get(x - X0, y - Y0))
+			{
+				continue;
+			}
+
+			int width = 1;
+			while (x + width < X1 && solid(x + width, y) == tile && !covered.Get(x + width - X0, y - Y0))
+			{
+				++width;
+			}
+
+			int height = 1;
+			for (; y + height < Y1; ++height)
+			{
+				bool match = true;
+				for (int i = 0; i < width && match; ++i)
+				{
+					match = solid(x + i, y + height) == tile && !covered.Get(x + i - X0, y + height - Y0);
+				}
+				if (!match)
+				{
+					break;
+				}
+			}
+
+			for (int j = 0; j < height; ++j)
+			{
+				for (int i = 0; i < width; ++i)
+				{
+					covered.Set(x + i - X0, y + j - Y0, true);
+				}
+			}
+
+			Rect rect = { x, y, width, height, tile };
+			AddRect(rect);
+			x += width - 1;
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	template <class Solid> void NXTileRects::RebuildWindow(int X0, int Y0, int X1, int Y1,
+ * 			const Solid& solid)
+ *
+ * \brief	Drops the rectangles touching the edited cells (inclusive) and merges again the cells
+ * 			they and the edit cover. Rectangles around them are kept, so the cost follows the size
+ * 			of the edit and not of the map.
+**************************************************************************************************/
+
+template <class Solid>
+void NXTileRects::RebuildWindow(int X0, int Y0, int X1, int Y1, const Solid& solid)
+{
+	X0 = std::max(X0, 0);
+	Y0 = std::max(Y0, 0);
+	X1 = std::min(X1, mWidth - 1);
+	Y1 = std::min(Y1, mHeight - 1);
+	if (X0 > X1 || Y0 > Y1)
+	{
+		return;
+	}
+
+	std::vector<int> touched;
+	Query(float(X0), float(Y0), float(X1 + 1), float(Y1 + 1), touched);
+
+	// Window (exclusive end) holding the edit and every dropped rectangle
+	int wx0 = X0, wy0 = Y0, wx1 = X1 + 1, wy1 = Y1 + 1;
+	for (size_t i = 0; i < touched.size(); ++i)
+	{
+		const Rect& rect = mRects[touched[i]];
+		wx0 = std::min(wx0, rect.x);
+		wy0 = std::min(wy0, rect.y);
+		wx1 = std::max(wx1, rect.x + rect.width);
+		wy1 = std::max(wy1, rect.y + rect.height);
+		RemoveRect(touched[i]);
+	}
+
+	// Kept rectangles reaching into the window must not be covered twice
+	NXBitGrid covered;
+	covered.Init(wx1 - wx0, wy1 - wy0);
+	Query(float(wx0), float(wy0), float(wx1), float(wy1), touched);
+	for (size_t i = 0; i < touched.size(); ++i)
+	{
+		const Rect& rect = mRects[touched[i]];
+		const int x0 = std::max(rect.x, wx0), x1 = std::min(rect.x + rect.width, wx1);
+		const int y0 = std::max(rect.y, wy0), y1 = std::min(rect.y + rect.height, wy1);
+		for (int y = y0; y < y1; ++y)
+		{
+			for (int x = x0; x < x1; ++x)
+			{
+				covered.Set(x - wx0, y - wy0, true);
+			}
+		}
+	}
+
+	MergeWindow(wx0, wy0, wx1, wy1, solid, covered);
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::AddRect(const Rect& rect)
+ *
+ * \brief	Stores a rectangle in a free slot and files it under each bucket it overlaps.
+**************************************************************************************************/
+
+void NXTileRects::AddRect(const Rect& rect)
+{
+	int index;
+	if (mFreeSlots.empty())
+	{
+		index = int(mRects.size());
+		mRects.push_back(rect);
+	}
+	else
+	{
+		index = mFreeSlots.back();
+		mFreeSlots.pop_back();
+		mRects[index] = rect;
+	}
+
+	const int bx0 = rect.x / NXTILERECTS_BUCKET_SIZE;
+	const int by0 = rect.y / NXTILERECTS_BUCKET_SIZE;
+	const int bx1 = (rect.x + rect.width - 1) / NXTILERECTS_BUCKET_SIZE;
+	const int by1 = (rect.y + rect.height - 1) / NXTILERECTS_BUCKET_SIZE;
+
+	for (int by = by0; by <= by1; ++by)
+	{
+		for (int bx = bx0; bx <= bx1; ++bx)
+		{
+			mBuckets[by * mBucketsX + bx].push_back(index);
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::RemoveRect(int Index)
+ *
+ * \brief	Takes a rectangle out of its buckets and frees its slot.
+**************************************************************************************************/
+
+void NXTileRects::RemoveRect(int Index)
+{
+	Rect& rect = mRects[Index];
+	const int bx0 = rect.x / NXTILERECTS_BUCKET_SIZE;
+	const int by0 = rect.y / NXTILERECTS_BUCKET_SIZE;
+	const int bx1 = (rect.x + rect.width - 1) / NXTILERECTS_BUCKET_SIZE;
+	const int by1 = (rect.y + rect.height - 1) / NXTILERECTS_BUCKET_SIZE;
+
+	for (int by = by0; by <= by1; ++by)
+	{
+		for (int bx = bx0; bx <= bx1; ++bx)
+		{
+			std::vector<int>& bucket = mBuckets[by * mBucketsX + bx];
+			bucket.erase(std::remove(bucket.begin(), bucket.end(), Index), bucket.end());
+		}
+	}
+
+	rect.width = rect.height = 0;
+	mFreeSlots.push_back(Index);
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileRects::Overlaps(const Rect& rect, float MinX, float MinY, float MaxX,
+ * 			float MaxY) const
+ *
+ * \brief	Query if a rectangle overlaps a box.
+**************************************************************************************************/
+
+bool NXTileRects::Overlaps(const Rect& rect, float MinX, float MinY, float MaxX, float MaxY) const
+{
+	return MinX < float(rect.x + rect.width) && MaxX > float(rect.x) &&
+		   MinY < float(rect.y + rect.height) && MaxY > float(rect.y);
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::Query(float MinX, float MinY, float MaxX, float MaxY,
+ * 			std::vector<int>& Result) const
+ *
+ * \brief	Collects the indices of the rectangles overlapping a box, each once.
+ *
+ * \param	MinX		  	The box left.
+ * \param	MinY		  	The box bottom.
+ * \param	MaxX		  	The box right.
+ * \param	MaxY		  	The box top.
+ * \param [out]	Result	Indices into GetRects.
+**************************************************************************************************/
+
+void NXTileRects::Query(float MinX, float MinY, float MaxX, float MaxY, std::vector<int>& Result) const
+{
+	Result.clear();
+	if (mBuckets.empty())
+	{
+		return;
+	}
+
+	int bx0 = int(floorf(MinX)) / NXTILERECTS_BUCKET_SIZE, bx1 = int(floorf(MaxX)) / NXTILERECTS_BUCKET_SIZE;
+	int by0 = int(floorf(MinY)) / NXTILERECTS_BUCKET_SIZE, by1 = int(floorf(MaxY)) / NXTILERECTS_BUCKET_SIZE;
+	if (MaxX < 0 || MaxY < 0)
+	{
+		return;
+	}
+	bx0 = std::max(bx0, 0); bx1 = std::min(bx1, mBucketsX - 1);
+	by0 = std::max(by0, 0); by1 = std::min(by1, mBucketsY - 1);
+
+	for (int by = by0; by <= by1; ++by)
+	{
+		for (int bx = bx0; bx <= bx1; ++bx)
+		{
+			const std::vector<int>& bucket = mBuckets[by * mBucketsX + bx];
+			for (size_t i = 0; i < bucket.size(); ++i)
+			{
+				if (Overlaps(mRects[bucket[i]], MinX, MinY, MaxX, MaxY))
+				{
+					Result.push_back(bucket[i]);
+				}
+			}
+		}
+	}
+
+	// A rectangle spanning several buckets shows up once per bucket
+	std::sort(Result.begin(), Result.end());
+	Result.erase(std::unique(Result.begin(), Result.end()), Result.end());
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileRects::Overlaps(float MinX, float MinY, float MaxX, float MaxY) const
+ *
+ * \brief	Broad phase test of a box against the terrain.
+ *
+ * \return	true if any rectangle overlaps the box.
+**************************************************************************************************/
+
+bool NXTileRects::Overlaps(float MinX, float MinY, float MaxX, float MaxY) const
+{
+	if (mBuckets.empty() || MaxX < 0 || MaxY < 0)
+	{
+		return false;
+	}
+
+	int bx0 = std::max(int(floorf(MinX)) / NXTILERECTS_BUCKET_SIZE, 0);
+	int by0 = std::max(int(floorf(MinY)) / NXTILERECTS_BUCKET_SIZE, 0);
+	int bx1 = std::min(int(floorf(MaxX)) / NXTILERECTS_BUCKET_SIZE, mBucketsX - 1);
+	int by1 = std::min(int(floorf(MaxY)) / NXTILERECTS_BUCKET_SIZE, mBucketsY - 1);
+
+	for (int by = by0; by <= by1; ++by)
+	{
+		for (int bx = bx0; bx <= bx1; ++bx)
+		{
+			const std::vector<int>& bucket = mBuckets[by * mBucketsX + bx];
+			for (size_t i = 0; i < bucket.size(); ++i)
+			{
+				if (Overlaps(mRects[bucket[i]], MinX, MinY, MaxX, MaxY))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRects::RenderDebugInfo( void ) const
+ *
+ * \brief	Draws every rectangle as a box outline, the same way object bounding boxes are drawn.
+**************************************************************************************************/
+
+void NXTileRects::RenderDebugInfo( void ) const
+{
+	if (GetCount() == 0)
+	{
+		return;
+	}
+
+	NXRenderDevice& device = NXBeginGraphicBatch();
+	device.DisableTexture();
+	device.SetBox();
+
+	for (size_t i = 0; i < mRects.size(); ++i)
+	{
+		const Rect& rect = mRects[i];
+		if (rect.width == 0)
+		{
+			continue;
+		}
+		const float w = float(rect.width), h = float(rect.height);
+		device.SetObjectTransform(D3DXMATRIX(	w,		0.0f,	0.0f,	0.0f,
+											0.0f,	h,		0.0f,	0.0f,
+											0.0f,	0.0f,	1.0f,	0.0f,
+											rect.x + w * 0.5f,	rect.y + h * 0.5f,	0.0f,	1.0f));
+		device.DrawLineStrip(4);
+	}
+}
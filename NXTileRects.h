@@ -0,0 +1,81 @@
+/**************************************************************************************************
+* \file	    NXTileRects.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Solid tiles merged into axis aligned rectangles\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXTILERECTS_H_
+#define NXTILERECTS_H_
+
+#include "NXBitGrid.h"
+#include <vector>
+
+const int NXTILERECTS_BUCKET_SIZE = 16;	//Cells per side of a query bucket
+
+class NXTileRects
+{
+	public:
+		//Cells x to x + width - 1, y to y + height - 1
+		struct Rect
+		{
+			int x;
+			int y;
+			int width;
+			int height;
+			int tile;	//Tile id when built from tiles, 1 when built from collision
+		};
+
+		NXTileRects( void );
+		~NXTileRects( void );
+
+		void Build(const NXBitGrid& Grid);
+		void BuildFromTiles(const int *Tiles, int Width, int Height);
+		void Free( void );
+
+		//Re-merges around a rectangle of edited cells (inclusive) instead of the whole map
+		void RebuildRegion(const NXBitGrid& Grid, int X0, int Y0, int X1, int Y1);
+		void RebuildTilesRegion(const int *Tiles, int X0, int Y0, int X1, int Y1);
+
+		//Rectangles overlapping a box in world units, faces that only touch do not count
+		void Query(float MinX, float MinY, float MaxX, float MaxY, std::vector<int>& Result) const;
+		bool Overlaps(float MinX, float MinY, float MaxX, float MaxY) const;
+
+		void RenderDebugInfo( void ) const;
+
+		//Slots freed by RebuildRegion are kept with a width of 0
+		const std::vector<Rect>& GetRects( void ) const { return mRects; }
+		size_t GetCount( void ) const { return mRects.size() - mFreeSlots.size(); }
+
+	private:
+		template <class Solid>
+		void Merge(int Width, int Height, const Solid& solid);
+		template <class Solid>
+		void MergeWindow(int X0, int Y0, int X1, int Y1, const Solid& solid, NXBitGrid& covered);
+		template <class Solid>
+		void RebuildWindow(int X0, int Y0, int X1, int Y1, const Solid& solid);
+		void AddRect(const Rect& rect);
+		void RemoveRect(int Index);
+		bool Overlaps(const Rect& rect, float MinX, float MinY, float MaxX, float MaxY) const;
+
+		std::vector<Rect> mRects;
+		std::vector< std::vector<int> > mBuckets;
+		std::vector<int> mFreeSlots;
+		int mWidth;
+		int mHeight;
+		int mBucketsX;
+		int mBucketsY;
+};
+
+#endif
@@ -0,0 +1,387 @@
+/**************************************************************************************************
+* \file	    NXTileRenderer.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Draws a tile map from static per chunk vertex buffers\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXTileRenderer.h"
+#include "NXTileMap.h"
+#include "NXEngineMain.h"
+#include "NXRenderDevice.h"
+#include "NXCamera.h"
+#include "NXAssert.h"
+#include <cmath>
+#include <cstring>
+
+#ifndef NX_HEADLESS
+
+/**************************************************************************************************
+ * \fn	static LPDIRECT3DVERTEXBUFFER9 CreateChunkBuffer(const std::vector<NXTileVertex>& vertices)
+ *
+ * \brief	Uploads the vertices of a chunk into a static, write only vertex buffer.
+ *
+ * \return	null if it fails, else the buffer.
+**************************************************************************************************/
+
+static LPDIRECT3DVERTEXBUFFER9 CreateChunkBuffer(const std::vector<NXTileVertex>& vertices)
+{
+	const UINT size = UINT(vertices.size() * sizeof(NXTileVertex));
+	LPDIRECT3DVERTEXBUFFER9 buffer = 0;
+
+	if (FAILED(gEngine.GetGraphicEngine()->GetDevice()->CreateVertexBuffer(
+				size, D3DUSAGE_WRITEONLY, NXTILEVERTEX_FVF, D3DPOOL_MANAGED, &buffer, 0)))
+	{
+		NX_MESG(L"NXTileRenderer: Unable to create chunk vertex buffer\n");
+		return 0;
+	}
+
+	void *data = 0;
+	if (FAILED(buffer->Lock(0, size, &data, 0)))
+	{
+		buffer->Release();
+		return 0;
+	}
+	memcpy(data, &vertices[0], size);
+	buffer->Unlock();
+	return buffer;
+}
+
+#endif
+
+/**************************************************************************************************
+ * \fn	NXTileRenderer::NXTileRenderer( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXTileRenderer::NXTileRenderer( void ) :
+	mMap(0),
+	mAtlasColumns(1),
+	mAtlasRows(1),
+	mDepth(0),
+	mChunksX(0),
+	mChunksY(0),
+	mEditCursor(0),
+	mChunksDrawn(0),
+	mChunksRebuilt(0)
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXTileRenderer::~NXTileRenderer( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXTileRenderer::~NXTileRenderer( void )
+{
+	Free();
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::Init(const NXTileMap& map, const std::wstring& atlasSpriteID,
+ * 			int atlasColumns, int atlasRows, float depth)
+ *
+ * \brief	Prepares the chunks of a loaded map. They are baked on the first Render.
+ *
+ * \param	map				The tile map.
+ * \param	atlasSpriteID	Sprite holding every tile.
+ * \param	atlasColumns	Number of tiles across the atlas.
+ * \param	atlasRows		Number of tiles down the atlas.
+ * \param	depth			Z of the tile layer.
+**************************************************************************************************/
+
+void NXTileRenderer::Init(const NXTileMap& map, const std::wstring& atlasSpriteID,
+						  int atlasColumns, int atlasRows, float depth)
+{
+	Free();
+
+	mMap = &map;
+	mAtlasSpriteID = atlasSpriteID;
+	mAtlasColumns = atlasColumns > 0 ? atlasColumns : 1;
+	mAtlasRows = atlasRows > 0 ? atlasRows : 1;
+	mDepth = depth;
+	mChunksX = (map.GetWidth() + NXTILERENDER_CHUNK_SIZE - 1) / NXTILERENDER_CHUNK_SIZE;
+	mChunksY = (map.GetHeight() + NXTILERENDER_CHUNK_SIZE - 1) / NXTILERENDER_CHUNK_SIZE;
+
+	Chunk empty;
+	empty.buffer = 0;
+	empty.triangles = 0;
+	empty.isDirty = true;
+	empty.isBaked = false;
+	mChunks.assign(size_t(mChunksX) * mChunksY, empty);
+	mEditCursor = map.GetDirtyCursor();
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::Free( void )
+ *
+ * \brief	Releases every chunk buffer.
+**************************************************************************************************/
+
+void NXTileRenderer::Free( void )
+{
+	for (size_t i = 0; i < mChunks.size(); ++i)
+	{
+		if (mChunks[i].buffer)
+		{
+			mChunks[i].buffer->Release();
+		}
+	}
+	mChunks.clear();
+	mBaked.clear();
+	mMap = 0;
+	mChunksX = mChunksY = 0;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::MarkDirty(int X0, int Y0, int X1, int Y1)
+ *
+ * \brief	Marks the chunks overlapping a rectangle of cells (inclusive) for rebaking.
+**************************************************************************************************/
+
+void NXTileRenderer::MarkDirty(int X0, int Y0, int X1, int Y1)
+{
+	int cx0 = X0 / NXTILERENDER_CHUNK_SIZE, cx1 = X1 / NXTILERENDER_CHUNK_SIZE;
+	int cy0 = Y0 / NXTILERENDER_CHUNK_SIZE, cy1 = Y1 / NXTILERENDER_CHUNK_SIZE;
+	if (cx0 < 0) cx0 = 0;
+	if (cy0 < 0) cy0 = 0;
+	if (cx1 >= mChunksX) cx1 = mChunksX - 1;
+	if (cy1 >= mChunksY) cy1 = mChunksY - 1;
+
+	for (int cy = cy0; cy <= cy1; ++cy)
+	{
+		for (int cx = cx0; cx <= cx1; ++cx)
+		{
+			mChunks[cy * mChunksX + cx].isDirty = true;
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::MarkAllDirty( void )
+ *
+ * \brief	Marks every chunk for rebaking, e.g. after the device was reset.
+**************************************************************************************************/
+
+void NXTileRenderer::MarkAllDirty( void )
+{
+	for (size_t i = 0; i < mChunks.size(); ++i)
+	{
+		mChunks[i].isDirty = true;
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::BuildChunk(int index)
+ *
+ * \brief	Bakes the non empty tiles of a chunk into one triangle list, two triangles per tile.
+**************************************************************************************************/
+
+void NXTileRenderer::BuildChunk(int index)
+{
+	Chunk& chunk = mChunks[index];
+	if (chunk.buffer)
+	{
+		chunk.buffer->Release();
+		chunk.buffer = 0;
+	}
+	chunk.triangles = 0;
+	chunk.isDirty = false;
+	if (!chunk.isBaked)
+	{
+		chunk.isBaked = true;
+		mBaked.push_back(index);
+	}
+
+	const int x0 = (index % mChunksX) * NXTILERENDER_CHUNK_SIZE;
+	const int y0 = (index / mChunksX) * NXTILERENDER_CHUNK_SIZE;
+	const float du = 1.0f / mAtlasColumns, dv = 1.0f / mAtlasRows;
+
+	mScratch.clear();
+	for (int y = y0; y < y0 + NXTILERENDER_CHUNK_SIZE && y < mMap->GetHeight(); ++y)
+	{
+		for (int x = x0; x < x0 + NXTILERENDER_CHUNK_SIZE && x < mMap->GetWidth(); ++x)
+		{
+			const int tile = mMap->GetTileValue(x, y);
+			if (tile <= 0)
+			{
+				continue;
+			}
+
+			// World y goes up, atlas v goes down
+			const float u0 = ((tile - 1) % mAtlasColumns) * du;
+			const float v0 = ((tile - 1) / mAtlasColumns) * dv;
+			const NXTileVertex topLeft     = { float(x),     float(y + 1), mDepth, u0,      v0      };
+			const NXTileVertex topRight    = { float(x + 1), float(y + 1), mDepth, u0 + du, v0      };
+			const NXTileVertex bottomLeft  = { float(x),     float(y),     mDepth, u0,      v0 + dv };
+			const NXTileVertex bottomRight = { float(x + 1), float(y),     mDepth, u0 + du, v0 + dv };
+
+			mScratch.push_back(topLeft);
+			mScratch.push_back(topRight);
+			mScratch.push_back(bottomLeft);
+			mScratch.push_back(bottomLeft);
+			mScratch.push_back(topRight);
+			mScratch.push_back(bottomRight);
+		}
+	}
+
+	if (mScratch.empty())
+	{
+		return;
+	}
+
+#ifdef NX_HEADLESS
+	// Nothing to upload to, the chunk is still drawn on the headless device
+	chunk.triangles = unsigned(mScratch.size() / 3);
+#else
+	chunk.buffer = CreateChunkBuffer(mScratch);
+	if (chunk.buffer)
+	{
+		chunk.triangles = unsigned(mScratch.size() / 3);
+	}
+#endif
+	++mChunksRebuilt;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::ReleaseChunk(int index)
+ *
+ * \brief	Frees the buffer of a chunk and leaves it dirty, so it is baked again when next seen.
+**************************************************************************************************/
+
+void NXTileRenderer::ReleaseChunk(int index)
+{
+	Chunk& chunk = mChunks[index];
+	if (chunk.buffer)
+	{
+		chunk.buffer->Release();
+		chunk.buffer = 0;
+	}
+	chunk.triangles = 0;
+	chunk.isDirty = true;
+	chunk.isBaked = false;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::ReleaseFarChunks(int cx0, int cy0, int cx1, int cy1)
+ *
+ * \brief	Releases every baked chunk more than NXTILERENDER_KEEP_MARGIN chunks outside the
+ * 			visible chunk rectangle (inclusive), so a camera crossing a large map keeps a
+ * 			bounded number of buffers alive.
+**************************************************************************************************/
+
+void NXTileRenderer::ReleaseFarChunks(int cx0, int cy0, int cx1, int cy1)
+{
+	cx0 -= NXTILERENDER_KEEP_MARGIN;
+	cy0 -= NXTILERENDER_KEEP_MARGIN;
+	cx1 += NXTILERENDER_KEEP_MARGIN;
+	cy1 += NXTILERENDER_KEEP_MARGIN;
+
+	for (size_t i = 0; i < mBaked.size(); )
+	{
+		const int index = mBaked[i];
+		const int cx = index % mChunksX, cy = index / mChunksX;
+		if (cx >= cx0 && cx <= cx1 && cy >= cy0 && cy <= cy1)
+		{
+			++i;
+			continue;
+		}
+
+		ReleaseChunk(index);
+		mBaked[i] = mBaked.back();
+		mBaked.pop_back();
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileRenderer::Render( void )
+ *
+ * \brief	Draws the chunks overlapping the camera rectangle with one draw call each. Only
+ * 			dirty chunks are rebaked, so an unchanged map costs no uploads and an edited tile
+ * 			rebakes the one chunk holding it. Streamed chunks arriving are logged by the map
+ * 			like edits, so a chunk baked before its tiles were resident is baked again.
+**************************************************************************************************/
+
+void NXTileRenderer::Render( void )
+{
+	mChunksDrawn = 0;
+	mChunksRebuilt = 0;
+	if (mMap == 0 || mChunks.empty())
+	{
+		return;
+	}
+
+	mEdits.clear();
+	if (mMap->GetDirtyRectsSince(&mEditCursor, mEdits))
+	{
+		for (size_t i = 0; i < mEdits.size(); ++i)
+		{
+			MarkDirty(mEdits[i].x0, mEdits[i].y0, mEdits[i].x1, mEdits[i].y1);
+		}
+	}
+	else
+	{
+		MarkAllDirty();
+	}
+
+	const Vec3 camera = gCamera.GetPosition();
+	const float halfView = float(gEngine.GetFovX());
+	int cx0 = int(floorf((camera.x - halfView) / NXTILERENDER_CHUNK_SIZE));
+	int cx1 = int(floorf((camera.x + halfView) / NXTILERENDER_CHUNK_SIZE));
+	int cy0 = int(floorf((camera.y - halfView) / NXTILERENDER_CHUNK_SIZE));
+	int cy1 = int(floorf((camera.y + halfView) / NXTILERENDER_CHUNK_SIZE));
+	if (cx0 < 0) cx0 = 0;
+	if (cy0 < 0) cy0 = 0;
+	if (cx1 >= mChunksX) cx1 = mChunksX - 1;
+	if (cy1 >= mChunksY) cy1 = mChunksY - 1;
+
+	NXRenderDevice& device = NXBeginGraphicBatch();
+	bool firstChunk = true;
+
+	for (int cy = cy0; cy <= cy1; ++cy)
+	{
+		for (int cx = cx0; cx <= cx1; ++cx)
+		{
+			const int index = cy * mChunksX + cx;
+			if (mChunks[index].isDirty)
+			{
+				BuildChunk(index);
+			}
+			if (mChunks[index].triangles == 0)
+			{
+				continue;
+			}
+
+			if (firstChunk)
+			{
+				D3DXMATRIX identity;
+				D3DXMatrixIdentity(&identity);
+				device.SetTexture(gEngine.GetMeshManager()->GetTexture(mAtlasSpriteID));
+				device.SetTextureTransform(identity);
+				device.SetColorBlending(NXCOLOR_ARGB(255,255,255,255));
+				device.SetNormalBlending();
+				device.SetObjectTransform(identity);
+				firstChunk = false;
+			}
+
+			device.SetVertices(mChunks[index].buffer);
+			device.DrawTriangleList(mChunks[index].triangles);
+			++mChunksDrawn;
+		}
+	}
+
+	ReleaseFarChunks(cx0, cy0, cx1, cy1);
+}
@@ -0,0 +1,94 @@
+/**************************************************************************************************
+* \file	    NXTileRenderer.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Draws a tile map from static per chunk vertex buffers\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXTILERENDERER_H_
+#define NXTILERENDERER_H_
+
+#include "NXGraphicEngine.h"
+#include "NXTileMap.h"
+#include <string>
+#include <vector>
+
+const int NXTILERENDER_CHUNK_SIZE = 32;
+//Baked chunks further than this many chunks outside the camera give their buffers back
+const int NXTILERENDER_KEEP_MARGIN = 2;
+
+//Vertex of a baked tile quad, position in world units and atlas UV
+struct NXTileVertex
+{
+	float x, y, z;
+	float u, v;
+};
+
+const unsigned long NXTILEVERTEX_FVF = D3DFVF_XYZ | D3DFVF_TEX1;
+
+class NXTileRenderer
+{
+	public:
+		NXTileRenderer( void );
+		~NXTileRenderer( void );
+
+		//Tile id n (n > 0) uses atlas cell n-1, counted left to right, top to bottom
+		void Init(const NXTileMap& map, const std::wstring& atlasSpriteID,
+				  int atlasColumns, int atlasRows, float depth = 0.0f);
+		void Free( void );
+
+		void MarkDirty(int X0, int Y0, int X1, int Y1);
+		void MarkAllDirty( void );
+
+		//Picks up the map's tile edits, rebuilds dirty chunks, then draws every chunk
+		//overlapping the camera
+		void Render( void );
+
+		unsigned GetChunksDrawn( void ) const { return mChunksDrawn; }
+		unsigned GetChunksRebuilt( void ) const { return mChunksRebuilt; }
+		unsigned GetChunksBaked( void ) const { return unsigned(mBaked.size()); }
+
+	private:
+		struct Chunk
+		{
+			LPDIRECT3DVERTEXBUFFER9 buffer;
+			unsigned triangles;
+			bool isDirty;
+			bool isBaked;
+		};
+
+		NXTileRenderer(const NXTileRenderer&);
+		NXTileRenderer& operator=(const NXTileRenderer&);
+
+		void BuildChunk(int index);
+		void ReleaseChunk(int index);
+		void ReleaseFarChunks(int cx0, int cy0, int cx1, int cy1);
+
+		const NXTileMap *mMap;
+		std::wstring mAtlasSpriteID;
+		int mAtlasColumns;
+		int mAtlasRows;
+		float mDepth;
+		int mChunksX;
+		int mChunksY;
+		std::vector<Chunk> mChunks;
+		std::vector<int> mBaked;
+		std::vector<NXTileVertex> mScratch;
+		size_t mEditCursor;
+		std::vector<NXTileDirtyRect> mEdits;
+		unsigned mChunksDrawn;
+		unsigned mChunksRebuilt;
+};
+
+#endif
@@ -0,0 +1,480 @@
+/**************************************************************************************************
+* \file	    NXTileStreamer.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Streams a compiled tile map in chunks around the camera\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXTileStreamer.h"
+#include "NXTileMap.h"
+#include "NXAssert.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	//Chunk waiting to be requested and its distance to the camera chunk
+	struct ChunkRequest
+	{
+		int index;
+		int distance;
+		bool operator<(const ChunkRequest& rhs) const { return distance < rhs.distance; }
+	};
+}
+
+/**************************************************************************************************
+ * \fn	NXTileStreamer::NXTileStreamer( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXTileStreamer::NXTileStreamer( void ) :
+	mFile(0),
+	mTileOffset(0),
+	mWidth(0),
+	mHeight(0),
+	mChunksX(0),
+	mChunksY(0),
+	mDefaultValue(0),
+	mMaxResident(0),
+	mResidentCount(0),
+	mPendingCount(0),
+	isQuitting(false)
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXTileStreamer::~NXTileStreamer( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXTileStreamer::~NXTileStreamer( void )
+{
+	Close();
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileStreamer::Open(const char *FileName, size_t MemoryBudget, int DefaultValue)
+ *
+ * \brief	Opens a compiled map (see NXTileMap::CompileMapDataToFile) for streaming and starts
+ * 			the loader thread. Only the header is read here.
+ *
+ * \param	FileName		Name of the compiled map file.
+ * \param	MemoryBudget	Maximum bytes of chunk data, resident and in flight.
+ * \param	DefaultValue	Collision value of cells that are not resident yet.
+ *
+ * \return	true if it succeeds, false if it fails.
+**************************************************************************************************/
+
+bool NXTileStreamer::Open(const char *FileName, size_t MemoryBudget, int DefaultValue)
+{
+	Close();
+
+	mFile = fopen(FileName, "rb");
+	if (mFile == 0)
+	{
+		return false;
+	}
+
+	NXTileMapFileHeader header;
+	if (fread(&header, sizeof(header), 1, mFile) != 1 ||
+		memcmp(header.magic, NXTILEMAP_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != NXTILEMAP_FILE_VERSION ||
+		header.width <= 0 || header.height <= 0)
+	{
+		NX_MESG("Compiled map file is invalid or out of date!");
+		fclose(mFile);
+		mFile = 0;
+		return false;
+	}
+
+	// A truncated file would only fail later, on the loader thread
+	const long tileEnd = long(header.tileOffset + size_t(header.width) * header.height * sizeof(int));
+	if (fseek(mFile, 0, SEEK_END) != 0 || ftell(mFile) < tileEnd)
+	{
+		NX_MESG("Compiled map file is truncated!");
+		fclose(mFile);
+		mFile = 0;
+		return false;
+	}
+
+	mTileOffset = header.tileOffset;
+	mWidth = header.width;
+	mHeight = header.height;
+	mChunksX = (mWidth + NXTILESTREAM_CHUNK_SIZE - 1) / NXTILESTREAM_CHUNK_SIZE;
+	mChunksY = (mHeight + NXTILESTREAM_CHUNK_SIZE - 1) / NXTILESTREAM_CHUNK_SIZE;
+	mDefaultValue = DefaultValue;
+	mMaxResident = MemoryBudget / sizeof(Chunk);
+	if (mMaxResident == 0)
+	{
+		mMaxResident = 1;
+	}
+	mResidentCount = 0;
+	mPendingCount = 0;
+
+	mChunks.assign(size_t(mChunksX) * mChunksY, static_cast<Chunk*>(0));
+	mState.assign(size_t(mChunksX) * mChunksY, CHUNK_EMPTY);
+
+	isQuitting = false;
+	mLoader = std::thread(&NXTileStreamer::LoaderThread, this);
+	return true;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileStreamer::Close( void )
+ *
+ * \brief	Stops the loader thread and frees every chunk.
+**************************************************************************************************/
+
+void NXTileStreamer::Close( void )
+{
+	if (mLoader.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			isQuitting = true;
+		}
+		mWake.notify_one();
+		mLoader.join();
+	}
+
+	for (size_t i = 0; i < mChunks.size(); ++i)
+	{
+		delete mChunks[i];
+	}
+	for (size_t i = 0; i < mRequests.size(); ++i)
+	{
+		delete mRequests[i];
+	}
+	for (size_t i = 0; i < mCompleted.size(); ++i)
+	{
+		delete mCompleted[i];
+	}
+	for (size_t i = 0; i < mFreeChunks.size(); ++i)
+	{
+		delete mFreeChunks[i];
+	}
+	mChunks.clear();
+	mState.clear();
+	mRequests.clear();
+	mCompleted.clear();
+	mFreeChunks.clear();
+	mInstalled.clear();
+	mResidentCount = 0;
+	mPendingCount = 0;
+
+	if (mFile)
+	{
+		fclose(mFile);
+		mFile = 0;
+	}
+	mWidth = mHeight = mChunksX = mChunksY = 0;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileStreamer::Update(float CenterX, float CenterY, float HalfWidth,
+ * 			float HalfHeight, float Margin)
+ *
+ * \brief	Keeps the chunks covering the view plus a prefetch margin resident. Never holds more
+ * 			chunks than the memory budget allows. Missing chunks are requested nearest the
+ * 			center first, but resident chunks inside the window are not evicted to make room,
+ * 			so a budget smaller than the window can leave near chunks missing until the
+ * 			camera moves.
+ *
+ * \param	CenterX   	The view center X.
+ * \param	CenterY   	The view center Y.
+ * \param	HalfWidth 	Half the view width.
+ * \param	HalfHeight	Half the view height.
+ * \param	Margin	  	Extra cells to prefetch around the view.
+**************************************************************************************************/
+
+void NXTileStreamer::Update(float CenterX, float CenterY, float HalfWidth, float HalfHeight, float Margin)
+{
+	mInstalled.clear();
+	if (mChunks.empty())
+	{
+		return;
+	}
+
+	// Install what the loader finished since last frame
+	std::vector<Chunk*> completed;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		completed.swap(mCompleted);
+	}
+	for (size_t i = 0; i < completed.size(); ++i)
+	{
+		Chunk *chunk = completed[i];
+		mChunks[chunk->index] = chunk;
+		mState[chunk->index] = CHUNK_RESIDENT;
+		mInstalled.push_back(chunk->index);
+		++mResidentCount;
+		--mPendingCount;
+	}
+
+	// Window of wanted chunks
+	const int size = NXTILESTREAM_CHUNK_SIZE;
+	int cx0 = int(floorf((CenterX - HalfWidth - Margin) / size));
+	int cx1 = int(floorf((CenterX + HalfWidth + Margin) / size));
+	int cy0 = int(floorf((CenterY - HalfHeight - Margin) / size));
+	int cy1 = int(floorf((CenterY + HalfHeight + Margin) / size));
+	cx0 = std::max(cx0, 0); cx1 = std::min(cx1, mChunksX - 1);
+	cy0 = std::max(cy0, 0); cy1 = std::min(cy1, mChunksY - 1);
+
+	// Evict everything outside of it
+	for (size_t i = 0; i < mState.size(); ++i)
+	{
+		if (mState[i] != CHUNK_RESIDENT)
+		{
+			continue;
+		}
+		const int cx = int(i) % mChunksX, cy = int(i) / mChunksX;
+		if (cx < cx0 || cx > cx1 || cy < cy0 || cy > cy1)
+		{
+			Evict(int(i));
+		}
+	}
+
+	// Only report what is still resident, the camera may have moved past a late chunk
+	for (size_t i = 0; i < mInstalled.size(); )
+	{
+		if (mState[mInstalled[i]] == CHUNK_RESIDENT)
+		{
+			++i;
+			continue;
+		}
+		mInstalled[i] = mInstalled.back();
+		mInstalled.pop_back();
+	}
+
+	if (cx0 > cx1 || cy0 > cy1)
+	{
+		return;
+	}
+
+	// Request missing chunks, nearest to the camera first
+	const int centerX = int(floorf(CenterX / size)), centerY = int(floorf(CenterY / size));
+	std::vector<ChunkRequest> missing;
+	for (int cy = cy0; cy <= cy1; ++cy)
+	{
+		for (int cx = cx0; cx <= cx1; ++cx)
+		{
+			const int index = cy * mChunksX + cx;
+			if (mState[index] == CHUNK_EMPTY)
+			{
+				ChunkRequest request;
+				request.index = index;
+				request.distance = std::abs(cx - centerX) + std::abs(cy - centerY);
+				missing.push_back(request);
+			}
+		}
+	}
+	if (missing.empty())
+	{
+		return;
+	}
+	std::sort(missing.begin(), missing.end());
+
+	// Chunks in flight count towards the budget. Memory is only allocated when
+	// nothing can be recycled, so the total never goes over it either.
+	std::vector<Chunk*> requests;
+	for (size_t i = 0; i < missing.size(); ++i)
+	{
+		if (mResidentCount + mPendingCount >= mMaxResident)
+		{
+			break;
+		}
+
+		Chunk *chunk;
+		if (!mFreeChunks.empty())
+		{
+			chunk = mFreeChunks.back();
+			mFreeChunks.pop_back();
+		}
+		else
+		{
+			chunk = new Chunk;
+		}
+		chunk->index = missing[i].index;
+		mState[chunk->index] = CHUNK_PENDING;
+		++mPendingCount;
+		requests.push_back(chunk);
+	}
+
+	if (!requests.empty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mRequests.insert(mRequests.end(), requests.begin(), requests.end());
+		}
+		mWake.notify_one();
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileStreamer::Evict(int index)
+ *
+ * \brief	Drops a resident chunk, its memory is kept for the next request.
+**************************************************************************************************/
+
+void NXTileStreamer::Evict(int index)
+{
+	mFreeChunks.push_back(mChunks[index]);
+	mChunks[index] = 0;
+	mState[index] = CHUNK_EMPTY;
+	--mResidentCount;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTileStreamer::LoaderThread( void )
+ *
+ * \brief	Background I/O, loads requested chunks in order until told to quit.
+**************************************************************************************************/
+
+void NXTileStreamer::LoaderThread( void )
+{
+	for (;;)
+	{
+		Chunk *chunk;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (!isQuitting && mRequests.empty())
+			{
+				mWake.wait(lock);
+			}
+			if (isQuitting)
+			{
+				return;
+			}
+			chunk = mRequests.front();
+			mRequests.pop_front();
+		}
+
+		LoadChunk(chunk);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mCompleted.push_back(chunk);
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileStreamer::LoadChunk(Chunk *chunk)
+ *
+ * \brief	Reads the tile rows of one chunk from the tile plane and derives its collision bits
+ * 			(every non zero tile is solid). Cells past the map edge and rows that fail to read
+ * 			are left empty.
+**************************************************************************************************/
+
+bool NXTileStreamer::LoadChunk(Chunk *chunk)
+{
+	const int size = NXTILESTREAM_CHUNK_SIZE;
+	const int x0 = (chunk->index % mChunksX) * size;
+	const int y0 = (chunk->index / mChunksX) * size;
+	const int columns = std::min(size, mWidth - x0);
+	bool ok = true;
+
+	memset(chunk->tiles, 0, sizeof(chunk->tiles));
+	memset(chunk->collision, 0, sizeof(chunk->collision));
+
+	for (int row = 0; row < size && y0 + row < mHeight; ++row)
+	{
+		int *tiles = chunk->tiles + row * size;
+		const long offset = long(mTileOffset + (size_t(y0 + row) * mWidth + x0) * sizeof(int));
+		if (fseek(mFile, offset, SEEK_SET) != 0 ||
+			fread(tiles, sizeof(int), columns, mFile) != size_t(columns))
+		{
+			memset(tiles, 0, sizeof(int) * size);
+			ok = false;
+			continue;
+		}
+
+		unsigned bits = 0;
+		for (int x = 0; x < columns; ++x)
+		{
+			bits |= unsigned(tiles[x] != 0) << x;
+		}
+		chunk->collision[row] = bits;
+	}
+	return ok;
+}
+
+/**************************************************************************************************
+ * \fn	const NXTileStreamer::Chunk * NXTileStreamer::FindChunk(int X, int Y) const
+ *
+ * \brief	Gets the resident chunk holding a cell.
+ *
+ * \return	null if the cell is outside the map or its chunk is not resident.
+**************************************************************************************************/
+
+const NXTileStreamer::Chunk * NXTileStreamer::FindChunk(int X, int Y) const
+{
+	if (unsigned(X) >= unsigned(mWidth) || unsigned(Y) >= unsigned(mHeight))
+	{
+		return 0;
+	}
+	return mChunks[(Y / NXTILESTREAM_CHUNK_SIZE) * mChunksX + X / NXTILESTREAM_CHUNK_SIZE];
+}
+
+/**************************************************************************************************
+ * \fn	int NXTileStreamer::GetCellValue(int X, int Y) const
+ *
+ * \brief	Gets the collision value of a cell.
+ *
+ * \return	1 if solid, 0 if empty or outside the map, DefaultValue if not resident.
+**************************************************************************************************/
+
+int NXTileStreamer::GetCellValue(int X, int Y) const
+{
+	const Chunk *chunk = FindChunk(X, Y);
+	if (chunk == 0)
+	{
+		return IsResident(X, Y) ? 0 : mDefaultValue;
+	}
+	return (chunk->collision[Y % NXTILESTREAM_CHUNK_SIZE] >> (X % NXTILESTREAM_CHUNK_SIZE)) & 1;
+}
+
+/**************************************************************************************************
+ * \fn	int NXTileStreamer::GetTileValue(int X, int Y) const
+ *
+ * \brief	Gets the tile id of a cell, 0 if it is not resident.
+**************************************************************************************************/
+
+int NXTileStreamer::GetTileValue(int X, int Y) const
+{
+	const Chunk *chunk = FindChunk(X, Y);
+	if (chunk == 0)
+	{
+		return 0;
+	}
+	return chunk->tiles[(Y % NXTILESTREAM_CHUNK_SIZE) * NXTILESTREAM_CHUNK_SIZE + X % NXTILESTREAM_CHUNK_SIZE];
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTileStreamer::IsResident(int X, int Y) const
+ *
+ * \brief	Query if the data of a cell is available. Cells outside the map always are.
+**************************************************************************************************/
+
+bool NXTileStreamer::IsResident(int X, int Y) const
+{
+	if (unsigned(X) >= unsigned(mWidth) || unsigned(Y) >= unsigned(mHeight))
+	{
+		return true;
+	}
+	return FindChunk(X, Y) != 0;
+}
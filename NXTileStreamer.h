@@ -0,0 +1,105 @@
+/**************************************************************************************************
+* \file	    NXTileStreamer.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Streams a compiled tile map in chunks around the camera\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXTILESTREAMER_H_
+#define NXTILESTREAMER_H_
+
+#include <cstdio>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+const int NXTILESTREAM_CHUNK_SIZE = 32;	//Cells per chunk side, one collision row is 32 bits
+
+class NXTileStreamer
+{
+	public:
+		struct Chunk
+		{
+			int index;
+			int tiles[NXTILESTREAM_CHUNK_SIZE * NXTILESTREAM_CHUNK_SIZE];
+			unsigned collision[NXTILESTREAM_CHUNK_SIZE];
+		};
+
+		NXTileStreamer( void );
+		~NXTileStreamer( void );
+
+		bool Open(const char *FileName, size_t MemoryBudget, int DefaultValue = 0);
+		void Close( void );
+
+		//Main thread, once per frame. Installs finished chunks, evicts chunks
+		//outside the view plus margin and queues missing ones nearest first.
+		void Update(float CenterX, float CenterY, float HalfWidth, float HalfHeight, float Margin);
+
+		//DefaultValue for cells whose chunk is not resident yet
+		int  GetCellValue(int X, int Y) const;
+		int  GetTileValue(int X, int Y) const;
+		bool IsResident(int X, int Y) const;
+
+		int  GetWidth( void ) const { return mWidth; }
+		int  GetHeight( void ) const { return mHeight; }
+		size_t GetResidentCount( void ) const { return mResidentCount; }
+		size_t GetResidentBytes( void ) const { return mResidentCount * sizeof(Chunk); }
+		size_t GetMaxResident( void ) const { return mMaxResident; }
+
+		//Chunks that became resident during the last Update
+		const std::vector<int>& GetInstalled( void ) const { return mInstalled; }
+
+	private:
+		enum CHUNKSTATE
+		{
+			CHUNK_EMPTY = 0,
+			CHUNK_PENDING,
+			CHUNK_RESIDENT
+		};
+
+		NXTileStreamer(const NXTileStreamer&);
+		NXTileStreamer& operator=(const NXTileStreamer&);
+
+		void LoaderThread( void );
+		bool LoadChunk(Chunk *chunk);
+		const Chunk * FindChunk(int X, int Y) const;
+		void Evict(int index);
+
+		FILE *mFile;				//Only touched by the loader thread once it runs
+		unsigned mTileOffset;
+		int mWidth;
+		int mHeight;
+		int mChunksX;
+		int mChunksY;
+		int mDefaultValue;
+		size_t mMaxResident;
+		size_t mResidentCount;
+		size_t mPendingCount;
+
+		std::vector<Chunk*> mChunks;		//Only written by the main thread
+		std::vector<unsigned char> mState;
+		std::vector<Chunk*> mFreeChunks;	//Recycled chunk memory
+		std::vector<int> mInstalled;
+
+		std::thread mLoader;
+		std::mutex mMutex;
+		std::condition_variable mWake;
+		std::deque<Chunk*> mRequests;		//Guarded by mMutex
+		std::vector<Chunk*> mCompleted;		//Guarded by mMutex
+		bool isQuitting;					//Guarded by mMutex
+};
+
+#endif
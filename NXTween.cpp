@@ -0,0 +1,588 @@
+/**************************************************************************************************
+* \file	    NXTween.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Updates many interpolations at once and writes them into their targets\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "NXTween.h"
+#include "NXAssert.h"
+#include "NXProfiler.h"
+#include <cmath>
+
+#if defined(NXTWEEN_SSE2)
+#include <emmintrin.h>
+#endif
+
+NXTweenSystem gTweenSystem;
+
+static const int		TWEEN_CHANNELS[NXTWEEN_KIND_TOTAL] = { 1, 3, 4 };
+static const unsigned	TWEEN_SLOT_BITS = 20;	//The rest of an id is the slot's generation
+static const unsigned	TWEEN_SLOT_MASK = (1u << TWEEN_SLOT_BITS) - 1;
+
+/**************************************************************************************************
+ * \fn	NXTweenSystem::NXTweenSystem( void )
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+NXTweenSystem::NXTweenSystem( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenSystem::~NXTweenSystem( void )
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+NXTweenSystem::~NXTweenSystem( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenID NXTweenSystem::Add(float *target, float start, float end,
+ * 			float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
+ *
+ * \brief	Tweens a float, e.g. a fade.
+ *
+ * \return	The tween.
+**************************************************************************************************/
+
+NXTweenID NXTweenSystem::Add(float *target, float start, float end, float Start_To_End_Seconds,
+							 NXINTERPOLANT_BEHAVIOUR behaviour)
+{
+	return Insert(NXTWEEN_FLOAT, target, &start, &end, Start_To_End_Seconds, behaviour);
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenID NXTweenSystem::Add(Vec3 *target, const Vec3& start, const Vec3& end,
+ * 			float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
+ *
+ * \brief	Tweens a vector, e.g. a bobbing position or a pulsing scale.
+ *
+ * \return	The tween.
+**************************************************************************************************/
+
+NXTweenID NXTweenSystem::Add(Vec3 *target, const Vec3& start, const Vec3& end, float Start_To_End_Seconds,
+							 NXINTERPOLANT_BEHAVIOUR behaviour)
+{
+	const float from[3] = { start.x, start.y, start.z };
+	const float to[3] = { end.x, end.y, end.z };
+	return Insert(NXTWEEN_VEC3, target, from, to, Start_To_End_Seconds, behaviour);
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenID NXTweenSystem::Add(NXCOLOR *target, NXCOLOR start, NXCOLOR end,
+ * 			float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
+ *
+ * \brief	Tweens a color, e.g. a flashing color modulation. Alpha, red, green and blue are
+ * 			interpolated separately.
+ *
+ * \return	The tween.
+**************************************************************************************************/
+
+NXTweenID NXTweenSystem::Add(NXCOLOR *target, NXCOLOR start, NXCOLOR end, float Start_To_End_Seconds,
+							 NXINTERPOLANT_BEHAVIOUR behaviour)
+{
+	return Add(target, NXInterpolant<NXColorF>(NXColorF(start), NXColorF(end), Start_To_End_Seconds, behaviour));
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenID NXTweenSystem::Add(float *target, const NXInterpolant<float>& interpolant)
+ *
+ * \brief	Moves an interpolant into the system, starting from its beginning.
+ *
+ * \return	The tween.
+**************************************************************************************************/
+
+NXTweenID NXTweenSystem::Add(float *target, const NXInterpolant<float>& interpolant)
+{
+	return Add(target, interpolant.GetStart(), interpolant.GetEnd(), interpolant.GetDuration(),
+			   interpolant.GetBehaviour());
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenID NXTweenSystem::Add(Vec3 *target, const NXInterpolant<Vec3>& interpolant)
+ *
+ * \brief	Moves an interpolant into the system, starting from its beginning.
+ *
+ * \return	The tween.
+**************************************************************************************************/
+
+NXTweenID NXTweenSystem::Add(Vec3 *target, const NXInterpolant<Vec3>& interpolant)
+{
+	return Add(target, interpolant.GetStart(), interpolant.GetEnd(), interpolant.GetDuration(),
+			   interpolant.GetBehaviour());
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenID NXTweenSystem::Add(NXCOLOR *target, const NXInterpolant<NXColorF>& interpolant)
+ *
+ * \brief	Moves an interpolant into the system, starting from its beginning.
+ *
+ * \return	The tween.
+**************************************************************************************************/
+
+NXTweenID NXTweenSystem::Add(NXCOLOR *target, const NXInterpolant<NXColorF>& interpolant)
+{
+	const NXColorF& start = interpolant.GetStart();
+	const NXColorF& end = interpolant.GetEnd();
+	const float from[4] = { start.a, start.r, start.g, start.b };
+	const float to[4] = { end.a, end.r, end.g, end.b };
+	return Insert(NXTWEEN_COLOR, target, from, to, interpolant.GetDuration(), interpolant.GetBehaviour());
+}
+
+/**************************************************************************************************
+ * \fn	NXTweenID NXTweenSystem::Insert(NXTWEEN_KIND kind, void *target, const float *start,
+ * 			const float *end, float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
+ *
+ * \brief	Appends a tween to the group of its kind and behaviour.
+**************************************************************************************************/
+
+NXTweenID NXTweenSystem::Insert(NXTWEEN_KIND kind, void *target, const float *start, const float *end,
+								float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour)
+{
+	NX_ASSERT(target);
+
+	unsigned slot;
+	if (mFreeSlots.empty())
+	{
+		slot = unsigned(mSlots.size());
+		NX_ASSERT(slot < TWEEN_SLOT_MASK);
+		Slot empty = { 0, -1, 0 };
+		mSlots.push_back(empty);
+	}
+	else
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+
+	const int index = kind * NXTWEEN_BEHAVIOUR_TOTAL + behaviour;
+	Group& group = mGroups[index];
+	const float seconds = fabsf(Start_To_End_Seconds);
+	const float speed = seconds > 0.0f ? 1.0f / seconds : 0.0f;
+
+	// A tween without a duration sits at its end
+	group.phase.push_back(seconds > 0.0f ? 0.0f : 1.0f);
+	group.rate.push_back(speed);
+	group.speed.push_back(speed);
+	for (int c = 0; c < TWEEN_CHANNELS[kind]; ++c)
+	{
+		group.start[c].push_back(start[c]);
+		group.delta[c].push_back(end[c] - start[c]);
+	}
+	group.target.push_back(target);
+	group.slot.push_back(slot);
+
+	mSlots[slot].group = index;
+	mSlots[slot].index = unsigned(group.phase.size() - 1);
+	return (mSlots[slot].generation << TWEEN_SLOT_BITS) | (slot + 1);
+}
+
+/**************************************************************************************************
+ * \fn	const NXTweenSystem::Slot* NXTweenSystem::Find(NXTweenID id) const
+ *
+ * \brief	Gets the slot of a tween.
+ *
+ * \return	null if the tween was removed.
+**************************************************************************************************/
+
+const NXTweenSystem::Slot* NXTweenSystem::Find(NXTweenID id) const
+{
+	const unsigned slot = (id & TWEEN_SLOT_MASK) - 1;
+	if (slot >= mSlots.size())
+	{
+		return 0;
+	}
+	const Slot& s = mSlots[slot];
+	if (s.group < 0 || (s.generation & (0xffffffffu >> TWEEN_SLOT_BITS)) != (id >> TWEEN_SLOT_BITS))
+	{
+		return 0;
+	}
+	return &s;
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::Erase(int group, unsigned index)
+ *
+ * \brief	Removes a tween by moving the last one of its group into its place.
+**************************************************************************************************/
+
+void NXTweenSystem::Erase(int group, unsigned index)
+{
+	Group& g = mGroups[group];
+	const int channels = TWEEN_CHANNELS[group / NXTWEEN_BEHAVIOUR_TOTAL];
+	const unsigned last = unsigned(g.phase.size() - 1);
+
+	Slot& removed = mSlots[g.slot[index]];
+	removed.group = -1;
+	++removed.generation;
+	mFreeSlots.push_back(g.slot[index]);
+
+	if (index != last)
+	{
+		g.phase[index] = g.phase[last];
+		g.rate[index] = g.rate[last];
+		g.speed[index] = g.speed[last];
+		for (int c = 0; c < channels; ++c)
+		{
+			g.start[c][index] = g.start[c][last];
+			g.delta[c][index] = g.delta[c][last];
+		}
+		g.target[index] = g.target[last];
+		g.slot[index] = g.slot[last];
+		mSlots[g.slot[index]].index = index;
+	}
+
+	g.phase.pop_back();
+	g.rate.pop_back();
+	g.speed.pop_back();
+	for (int c = 0; c < channels; ++c)
+	{
+		g.start[c].pop_back();
+		g.delta[c].pop_back();
+	}
+	g.target.pop_back();
+	g.slot.pop_back();
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::Remove(NXTweenID id)
+ *
+ * \brief	Removes a tween, its target keeps the last value written.
+**************************************************************************************************/
+
+void NXTweenSystem::Remove(NXTweenID id)
+{
+	const Slot *slot = Find(id);
+	if (slot)
+	{
+		Erase(slot->group, slot->index);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::RemoveTarget(const void *target)
+ *
+ * \brief	Removes every tween writing to a target, e.g. before the object holding it is
+ * 			destroyed.
+**************************************************************************************************/
+
+void NXTweenSystem::RemoveTarget(const void *target)
+{
+	for (int group = 0; group < NXTWEEN_KIND_TOTAL * NXTWEEN_BEHAVIOUR_TOTAL; ++group)
+	{
+		std::vector<void*>& targets = mGroups[group].target;
+		for (size_t i = targets.size(); i-- > 0; )
+		{
+			if (targets[i] == target)
+			{
+				Erase(group, unsigned(i));
+			}
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::Clear( void )
+ *
+ * \brief	Removes every tween.
+**************************************************************************************************/
+
+void NXTweenSystem::Clear( void )
+{
+	for (int group = 0; group < NXTWEEN_KIND_TOTAL * NXTWEEN_BEHAVIOUR_TOTAL; ++group)
+	{
+		while (!mGroups[group].phase.empty())
+		{
+			Erase(group, unsigned(mGroups[group].phase.size() - 1));
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::SetPause(NXTweenID id, bool pause)
+ *
+ * \brief	Pauses or resumes a tween. A paused tween still writes its target.
+**************************************************************************************************/
+
+void NXTweenSystem::SetPause(NXTweenID id, bool pause)
+{
+	const Slot *slot = Find(id);
+	if (slot)
+	{
+		Group& group = mGroups[slot->group];
+		group.rate[slot->index] = pause ? 0.0f : group.speed[slot->index];
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::SetPercentage(NXTweenID id, float percentage)
+ *
+ * \brief	Jumps to a point between start (0) and end (1). A circular tween resumes towards the
+ * 			end.
+**************************************************************************************************/
+
+void NXTweenSystem::SetPercentage(NXTweenID id, float percentage)
+{
+	const Slot *slot = Find(id);
+	if (slot)
+	{
+		const float p = percentage < 0.0f ? 0.0f : percentage > 1.0f ? 1.0f : percentage;
+		mGroups[slot->group].phase[slot->index] = p;
+	}
+}
+
+/**************************************************************************************************
+ * \fn	float NXTweenSystem::GetPercentage(NXTweenID id) const
+ *
+ * \brief	Gets where a tween is between start (0) and end (1).
+**************************************************************************************************/
+
+float NXTweenSystem::GetPercentage(NXTweenID id) const
+{
+	const Slot *slot = Find(id);
+	if (slot == 0)
+	{
+		return 1.0f;
+	}
+	const float phase = mGroups[slot->group].phase[slot->index];
+	if (slot->group % NXTWEEN_BEHAVIOUR_TOTAL == NXINTERPOLANT_CIRCULAR)
+	{
+		return 1.0f - fabsf(phase - 1.0f);
+	}
+	return phase;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTweenSystem::IsFinished(NXTweenID id) const
+ *
+ * \brief	Query if a tween has reached its end for good (NXINTERPOLANT_ONCE) or was removed.
+**************************************************************************************************/
+
+bool NXTweenSystem::IsFinished(NXTweenID id) const
+{
+	const Slot *slot = Find(id);
+	if (slot == 0)
+	{
+		return true;
+	}
+	return slot->group % NXTWEEN_BEHAVIOUR_TOTAL == NXINTERPOLANT_ONCE &&
+		   mGroups[slot->group].phase[slot->index] >= 1.0f;
+}
+
+/**************************************************************************************************
+ * \fn	bool NXTweenSystem::IsValid(NXTweenID id) const
+ *
+ * \brief	Query if a tween has not been removed.
+**************************************************************************************************/
+
+bool NXTweenSystem::IsValid(NXTweenID id) const
+{
+	return Find(id) != 0;
+}
+
+/**************************************************************************************************
+ * \fn	size_t NXTweenSystem::GetCount( void ) const
+ *
+ * \brief	Gets the number of tweens.
+**************************************************************************************************/
+
+size_t NXTweenSystem::GetCount( void ) const
+{
+	return mSlots.size() - mFreeSlots.size();
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::Advance(Group& group, NXINTERPOLANT_BEHAVIOUR behaviour, float dt,
+ * 			float *weight)
+ *
+ * \brief	Moves the phase of every tween of a group and gets how far each is from start to end.
+ * 			The behaviour is fixed for the group, so each loop is straight arithmetic:\n
+ * 			loop		phase wraps to [0, 1)\n
+ * 			once		phase stops at 1\n
+ * 			circular	phase wraps to [0, 2), the way back is 2 - phase
+**************************************************************************************************/
+
+void NXTweenSystem::Advance(Group& group, NXINTERPOLANT_BEHAVIOUR behaviour, float dt, float *weight)
+{
+	const size_t count = group.phase.size();
+	float *phase = &group.phase[0];
+	const float *rate = &group.rate[0];
+	size_t i = 0;
+
+#if defined(NXTWEEN_SSE2)
+	const __m128 step = _mm_set1_ps(dt);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 sign = _mm_set1_ps(-0.0f);
+#endif
+
+	// Phases are never negative, so truncating is flooring
+	switch (behaviour)
+	{
+		case NXINTERPOLANT_LOOP:
+#if defined(NXTWEEN_SSE2)
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 t = _mm_add_ps(_mm_loadu_ps(phase + i), _mm_mul_ps(_mm_loadu_ps(rate + i), step));
+				t = _mm_sub_ps(t, _mm_cvtepi32_ps(_mm_cvttps_epi32(t)));
+				_mm_storeu_ps(phase + i, t);
+				_mm_storeu_ps(weight + i, t);
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				const float t = phase[i] + rate[i] * dt;
+				phase[i] = weight[i] = t - float(int(t));
+			}
+			break;
+
+		case NXINTERPOLANT_ONCE:
+#if defined(NXTWEEN_SSE2)
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 t = _mm_add_ps(_mm_loadu_ps(phase + i), _mm_mul_ps(_mm_loadu_ps(rate + i), step));
+				t = _mm_min_ps(t, one);
+				_mm_storeu_ps(phase + i, t);
+				_mm_storeu_ps(weight + i, t);
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				const float t = phase[i] + rate[i] * dt;
+				phase[i] = weight[i] = t < 1.0f ? t : 1.0f;
+			}
+			break;
+
+		default:
+#if defined(NXTWEEN_SSE2)
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 t = _mm_add_ps(_mm_loadu_ps(phase + i), _mm_mul_ps(_mm_loadu_ps(rate + i), step));
+				t = _mm_sub_ps(t, _mm_mul_ps(two, _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(t, half)))));
+				_mm_storeu_ps(phase + i, t);
+				_mm_storeu_ps(weight + i, _mm_sub_ps(one, _mm_andnot_ps(sign, _mm_sub_ps(t, one))));
+			}
+#endif
+			for (; i < count; ++i)
+			{
+				float t = phase[i] + rate[i] * dt;
+				t -= 2.0f * float(int(t * 0.5f));
+				phase[i] = t;
+				weight[i] = 1.0f - fabsf(t - 1.0f);
+			}
+			break;
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::Blend(const Group& group, int channel, const float *weight,
+ * 			float *value)
+ *
+ * \brief	Computes start + delta * weight for one channel of every tween of a group.
+**************************************************************************************************/
+
+void NXTweenSystem::Blend(const Group& group, int channel, const float *weight, float *value)
+{
+	const size_t count = group.phase.size();
+	const float *start = &group.start[channel][0];
+	const float *delta = &group.delta[channel][0];
+	size_t i = 0;
+
+#if defined(NXTWEEN_SSE2)
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(start + i),
+											_mm_mul_ps(_mm_loadu_ps(delta + i), _mm_loadu_ps(weight + i))));
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		value[i] = start[i] + delta[i] * weight[i];
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void NXTweenSystem::Update(float dt)
+ *
+ * \brief	Advances every tween and writes its value into its target. Call once per frame.
+ *
+ * \param	dt	The frame time.
+**************************************************************************************************/
+
+void NXTweenSystem::Update(float dt)
+{
+	NX_PROFILE_ZONE("NXTweenSystem::Update");
+	for (int index = 0; index < NXTWEEN_KIND_TOTAL * NXTWEEN_BEHAVIOUR_TOTAL; ++index)
+	{
+		Group& group = mGroups[index];
+		const size_t count = group.phase.size();
+		if (count == 0)
+		{
+			continue;
+		}
+
+		const NXTWEEN_KIND kind = NXTWEEN_KIND(index / NXTWEEN_BEHAVIOUR_TOTAL);
+		const int channels = TWEEN_CHANNELS[kind];
+		if (mWeight.size() < count)
+		{
+			mWeight.resize(count);
+			for (int c = 0; c < 4; ++c)
+			{
+				mValue[c].resize(count);
+			}
+		}
+
+		Advance(group, NXINTERPOLANT_BEHAVIOUR(index % NXTWEEN_BEHAVIOUR_TOTAL), dt, &mWeight[0]);
+		for (int c = 0; c < channels; ++c)
+		{
+			Blend(group, c, &mWeight[0], &mValue[c][0]);
+		}
+
+		void * const *target = &group.target[0];
+		switch (kind)
+		{
+			case NXTWEEN_FLOAT:
+				for (size_t i = 0; i < count; ++i)
+				{
+					*static_cast<float*>(target[i]) = mValue[0][i];
+				}
+				break;
+			case NXTWEEN_VEC3:
+				for (size_t i = 0; i < count; ++i)
+				{
+					Vec3 *v = static_cast<Vec3*>(target[i]);
+					v->x = mValue[0][i];
+					v->y = mValue[1][i];
+					v->z = mValue[2][i];
+				}
+				break;
+			default:
+				for (size_t i = 0; i < count; ++i)
+				{
+					// Rounding of start + delta * phase can step outside 0 to 255, clamp like NXColorF
+					*static_cast<NXCOLOR*>(target[i]) = NXCOLOR_ARGB(NXColorF::ToChannel(mValue[0][i]),
+																	 NXColorF::ToChannel(mValue[1][i]),
+																	 NXColorF::ToChannel(mValue[2][i]),
+																	 NXColorF::ToChannel(mValue[3][i]));
+				}
+				break;
+		}
+	}
+}
@@ -0,0 +1,118 @@
+/**************************************************************************************************
+* \file	    NXTween.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	Updates many interpolations at once and writes them into their targets\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef NXTWEEN_H_
+#define NXTWEEN_H_
+
+#include "NXMaths.h"
+#include "NXGraphicEngine.h"
+#include "NXInterpolant.h"
+#include "NXColorF.h"
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NXTWEEN_SSE2
+#endif
+
+//0 is never a valid tween
+typedef unsigned NXTweenID;
+
+enum NXTWEEN_KIND
+{
+	NXTWEEN_FLOAT = 0,	//Writes a float
+	NXTWEEN_VEC3,		//Writes a Vec3
+	NXTWEEN_COLOR,		//Writes an NXCOLOR, each of a, r, g, b interpolated
+
+	NXTWEEN_KIND_TOTAL
+};
+
+const int NXTWEEN_BEHAVIOUR_TOTAL = 3;
+
+class NXTweenSystem
+{
+	public:
+		NXTweenSystem( void );
+		~NXTweenSystem( void );
+
+		//The target must stay valid until the tween is removed
+		NXTweenID Add(float *target, float start, float end, float Start_To_End_Seconds,
+					  NXINTERPOLANT_BEHAVIOUR behaviour);
+		NXTweenID Add(Vec3 *target, const Vec3& start, const Vec3& end, float Start_To_End_Seconds,
+					  NXINTERPOLANT_BEHAVIOUR behaviour);
+		NXTweenID Add(NXCOLOR *target, NXCOLOR start, NXCOLOR end, float Start_To_End_Seconds,
+					  NXINTERPOLANT_BEHAVIOUR behaviour);
+		NXTweenID Add(float *target, const NXInterpolant<float>& interpolant);
+		NXTweenID Add(Vec3 *target, const NXInterpolant<Vec3>& interpolant);
+		NXTweenID Add(NXCOLOR *target, const NXInterpolant<NXColorF>& interpolant);
+
+		void Remove(NXTweenID id);
+		void RemoveTarget(const void *target);
+		void Clear( void );
+
+		void SetPause(NXTweenID id, bool pause);
+		void SetPercentage(NXTweenID id, float percentage);
+		float GetPercentage(NXTweenID id) const;
+		bool IsFinished(NXTweenID id) const;
+		bool IsValid(NXTweenID id) const;
+
+		//Advances every tween and writes every target, one pass per group
+		void Update(float dt);
+
+		size_t GetCount( void ) const;
+
+	private:
+		//Tweens of one kind and behaviour, one array per field
+		struct Group
+		{
+			std::vector<float> phase;	//Time / duration, wrapped by the behaviour
+			std::vector<float> rate;	//1 / duration, 0 while paused
+			std::vector<float> speed;	//1 / duration
+			std::vector<float> start[4];
+			std::vector<float> delta[4];
+			std::vector<void*> target;
+			std::vector<unsigned> slot;
+		};
+
+		struct Slot
+		{
+			unsigned generation;
+			int group;			//-1 when free
+			unsigned index;
+		};
+
+		NXTweenSystem(const NXTweenSystem&);
+		NXTweenSystem& operator=(const NXTweenSystem&);
+
+		NXTweenID Insert(NXTWEEN_KIND kind, void *target, const float *start, const float *end,
+						 float Start_To_End_Seconds, NXINTERPOLANT_BEHAVIOUR behaviour);
+		const Slot* Find(NXTweenID id) const;
+		void Erase(int group, unsigned index);
+
+		static void Advance(Group& group, NXINTERPOLANT_BEHAVIOUR behaviour, float dt, float *weight);
+		static void Blend(const Group& group, int channel, const float *weight, float *value);
+
+		Group mGroups[NXTWEEN_KIND_TOTAL * NXTWEEN_BEHAVIOUR_TOTAL];
+		std::vector<Slot> mSlots;
+		std::vector<unsigned> mFreeSlots;
+		std::vector<float> mWeight;
+		std::vector<float> mValue[4];
+};
+
+extern NXTweenSystem gTweenSystem;
+
+#endif
@@ -0,0 +1,447 @@
+/**************************************************************************************************
+* \file	    StateBenchmark.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	State timing the object pool, rendering, tile collision and interpolants\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "StateBenchmark.h"
+#include "StateManager.h"
+#include "GameObj.h"
+#include "GameObjManager.h"
+#include "NXTileMap.h"
+#include "NXInterpolant.h"
+#include "NXRenderStateCache.h"
+#include "NXBenchmark.h"
+#include "NXObjSnapshot.h"
+#include "NXAssert.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <vector>
+
+StateBenchmark gStateBenchmark;
+
+static const char *NXBENCHMARK_FILE = "Benchmark.csv";
+static const char *NXBENCHMARK_MAP_FILE = "BenchmarkMap.xml";
+static const int NXBENCHMARK_SAMPLES = 9;
+
+//Objects are drawn with the sprites and mesh of the test state
+static const wchar_t *NXBENCHMARK_MESH = L"SQUARETOP";
+static const wchar_t *NXBENCHMARK_SPRITES[] = { L"SONIC", L"PLAYER1_2" };
+
+typedef ObjManager<GameObj> BenchmarkManager;
+
+static NXBenchmarkReport report;
+
+struct NoSetup
+{
+	void operator()( void ) const {}
+};
+
+/**************************************************************************************************
+ * \fn	template <class Setup, class Body> static void Measure(const char *name, size_t size,
+ * 			size_t operations, Setup setup, Body body)
+ *
+ * \brief	Times a number of samples of the body and adds them to the report. The setup runs
+ * 			before each sample and is not timed.
+**************************************************************************************************/
+
+template <class Setup, class Body>
+static void Measure(const char *name, size_t size, size_t operations, Setup setup, Body body)
+{
+	std::vector<double> seconds;
+
+	// One run to warm the caches
+	setup();
+	body();
+
+	for (int i = 0; i < NXBENCHMARK_SAMPLES; ++i)
+	{
+		setup();
+		NXStopwatch watch;
+		body();
+		seconds.push_back(watch.GetSeconds());
+	}
+	report.Add(name, size, operations, seconds);
+}
+
+template <class Body>
+static void Measure(const char *name, size_t size, size_t operations, Body body)
+{
+	Measure(name, size, operations, NoSetup(), body);
+}
+
+/**************************************************************************************************
+ * \fn	static void Fill(BenchmarkManager& manager, size_t count, int spriteRun)
+ *
+ * \brief	Creates objects spread over the screen. Sprites change every spriteRun objects, 0 for
+ * 			one sprite for all.
+**************************************************************************************************/
+
+static void Fill(BenchmarkManager& manager, size_t count, int spriteRun)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const int sprite = spriteRun > 0 ? int(i / spriteRun) % 2 : 0;
+		GameObj *obj = manager.CreateGameObj(NXBENCHMARK_MESH, NXBENCHMARK_SPRITES[sprite]);
+		if (obj == 0)
+		{
+			return;
+		}
+		obj->SetPosition(Vec3(float(rand() % 64), float(rand() % 64), -1.0f));
+		obj->SetScale(Vec3(1.0f, 1.0f, 1.0f));
+		obj->SetVelocity(Vec3(1.0f, 0.0f, 0.0f));
+	}
+}
+
+/**************************************************************************************************
+ * \fn	static void BenchmarkCreate( void )
+ *
+ * \brief	Creating objects in a pool that is already partly in use. The free slots are spread
+ * 			at random, so the search for one gets longer as the pool fills.
+**************************************************************************************************/
+
+static void BenchmarkCreate( void )
+{
+	const size_t capacity = 10000;
+	const int occupancies[] = { 0, 50, 90, 99 };
+
+	for (size_t o = 0; o < sizeof(occupancies) / sizeof(occupancies[0]); ++o)
+	{
+		BenchmarkManager manager(capacity);
+		Fill(manager, capacity, 0);
+
+		std::vector<GameObj>& objects = manager.GetManagerList();
+		size_t free = 0;
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			if (rand() % 100 >= occupancies[o])
+			{
+				objects[i].SetDestroy();
+				++free;
+			}
+		}
+
+		// Half the free slots at most, so every create finds one and a failing spawn is never timed
+		const size_t batch = std::min(free / 2, capacity / 100);
+		if (batch == 0)
+		{
+			continue;
+		}
+
+		// Each sample takes a batch of free slots and gives back whatever it took
+		std::vector<GameObj*> created;
+		created.reserve(batch);
+		Measure("create", size_t(occupancies[o]), batch,
+			[&]()
+			{
+				for (size_t i = 0; i < created.size(); ++i)
+				{
+					created[i]->SetDestroy();
+				}
+				created.clear();
+			},
+			[&]()
+			{
+				for (size_t i = 0; i < batch; ++i)
+				{
+					GameObj *obj = manager.CreateGameObj(NXBENCHMARK_MESH, NXBENCHMARK_SPRITES[0]);
+					if (obj)
+					{
+						created.push_back(obj);
+					}
+				}
+			});
+		NX_ASSERT(manager.GetTotalFailed() == 0);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	static void BenchmarkUpdate( void )
+ *
+ * \brief	Updating every object of a full pool.
+**************************************************************************************************/
+
+static void BenchmarkUpdate( void )
+{
+	const size_t counts[] = { 1000, 10000, 100000 };
+
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+	{
+		BenchmarkManager manager(counts[c]);
+		Fill(manager, counts[c], 0);
+		Measure("update", counts[c], counts[c], [&]() { manager.Update(); });
+	}
+}
+
+/**************************************************************************************************
+ * \fn	static void BenchmarkRender( void )
+ *
+ * \brief	Submitting draws to a device that does nothing, so only the cost of getting to the
+ * 			device is measured. Sprites are all the same, alternate in runs of 64, or alternate
+ * 			every object; each mix straight to the device and through the state cache.
+**************************************************************************************************/
+
+static void BenchmarkRender( void )
+{
+	const size_t count = 10000;
+	const int runs[] = { 0, 64, 1 };
+	const char *names[] = { "render_one_sprite", "render_sprite_runs", "render_mixed_sprites" };
+	const char *cachedNames[] = { "render_one_sprite_cached", "render_sprite_runs_cached", "render_mixed_sprites_cached" };
+
+	NXNullRenderDevice device;
+	NXRenderStateCache cache(&device);
+
+	for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); ++r)
+	{
+		BenchmarkManager manager(count);
+		Fill(manager, count, runs[r]);
+
+		Measure(names[r], count, count, [&]() { device.Reset(); }, [&]() { manager.Render(device); });
+		Measure(cachedNames[r], count, count, [&]() { device.Reset(); cache.BeginFrame(); }, [&]() { manager.Render(cache); });
+	}
+
+	BenchmarkManager manager(count);
+	Fill(manager, count, 0);
+	Measure("render_same_objects", count, count, [&]() { device.Reset(); }, [&]() { manager.RenderSameObjects(device); });
+}
+
+/**************************************************************************************************
+ * \fn	static void BenchmarkMaps( void )
+ *
+ * \brief	Importing maps of several sizes, then tile collision on the largest one for single
+ * 			objects and for batches.
+**************************************************************************************************/
+
+static void BenchmarkMaps( void )
+{
+	const int sizes[] = { 64, 256, 1024 };
+	std::string fileName(NXBENCHMARK_MAP_FILE);
+
+	NXTileMap map;
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		if (!NXWriteBenchmarkMap(NXBENCHMARK_MAP_FILE, sizes[s], sizes[s]))
+		{
+			return;
+		}
+		Measure("import_map", size_t(sizes[s]) * sizes[s], 1, [&]() { map.ImportMapDataFromFile(&fileName[0]); });
+	}
+	remove(NXBENCHMARK_MAP_FILE);
+
+	const size_t count = 10000;
+	const float extent = float(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1] - 4);
+	std::vector<float> posX(count), posY(count), scaleX(count), scaleY(count);
+	std::vector<int> flags(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		posX[i] = 2.0f + extent * rand() / RAND_MAX;
+		posY[i] = 2.0f + extent * rand() / RAND_MAX;
+		scaleX[i] = 0.5f + 2.0f * rand() / RAND_MAX;
+		scaleY[i] = 0.5f + 2.0f * rand() / RAND_MAX;
+	}
+
+	Measure("tile_collision", count, count,
+		[&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				flags[i] = map.CheckInstanceBinaryMapCollision(posX[i], posY[i], scaleX[i], scaleY[i]);
+			}
+		});
+	Measure("tile_collision_batch", count, count,
+		[&]()
+		{
+			map.CheckInstanceBinaryMapCollision(&posX[0], &posY[0], &scaleX[0], &scaleY[0], &flags[0], count);
+		});
+
+	map.FreeMapData();
+}
+
+/**************************************************************************************************
+ * \fn	static void BenchmarkInterpolants( void )
+ *
+ * \brief	Advancing and reading interpolants, stepped, time based and with fixed behaviour.
+**************************************************************************************************/
+
+static void BenchmarkInterpolants( void )
+{
+	const size_t count = 10000;
+	const float dt = 1.0f / 60.0f;
+	volatile float sink = 0.0f;
+
+	std::vector< NXInterpolant<float> > stepped(count), timed(count);
+	std::vector< NXEasedInterpolant<float, NXWrapLoop> > eased(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float seconds = 0.5f + float(i % 16) * 0.25f;
+		stepped[i].Init(0.0f, 1.0f, seconds, NXINTERPOLANT_BEHAVIOUR(i % 3));
+		timed[i].InitTimed(0.0f, 1.0f, seconds, NXINTERPOLANT_BEHAVIOUR(i % 3));
+		eased[i].Init(0.0f, 1.0f, seconds);
+	}
+
+	Measure("interpolant_update", count, count,
+		[&]()
+		{
+			float sum = 0.0f;
+			for (size_t i = 0; i < count; ++i)
+			{
+				stepped[i].Update(dt);
+				sum += stepped[i].GetValue();
+			}
+			sink = sum;
+		});
+	Measure("interpolant_timed", count, count,
+		[&]()
+		{
+			NXAdvanceInterpolantClock(dt);
+			float sum = 0.0f;
+			for (size_t i = 0; i < count; ++i)
+			{
+				sum += timed[i].GetValue();
+			}
+			sink = sum;
+		});
+	Measure("interpolant_eased", count, count,
+		[&]()
+		{
+			float sum = 0.0f;
+			for (size_t i = 0; i < count; ++i)
+			{
+				eased[i].Update(dt);
+				sum += eased[i].GetValue();
+			}
+			sink = sum;
+		});
+}
+
+/**************************************************************************************************
+ * \fn	static void BenchmarkSnapshot( void )
+ *
+ * \brief	Capturing and restoring every pool, with a full pool of objects, and turning the
+ * 			snapshot into a blob and back.
+**************************************************************************************************/
+
+static void BenchmarkSnapshot( void )
+{
+	const size_t count = 10000;
+	BenchmarkManager manager(count);
+	Fill(manager, count, 64);
+
+	NXObjSnapshot snapshot;
+	std::vector<char> blob;
+	Measure("snapshot_capture", count, count, [&]() { snapshot.Capture(0); });
+	Measure("snapshot_restore", count, count, [&]() { snapshot.Restore(0); });
+	Measure("snapshot_write", count, count, [&]() { snapshot.Write(blob); });
+	Measure("snapshot_read", count, count, [&]() { snapshot.Read(&blob[0], blob.size()); });
+}
+
+/**************************************************************************************************
+ * \fn	StateBenchmark::StateBenchmark()
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+StateBenchmark::StateBenchmark()
+{
+}
+
+/**************************************************************************************************
+ * \fn	StateBenchmark::~StateBenchmark()
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+StateBenchmark::~StateBenchmark()
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateBenchmark::Load( void )
+ *
+ * \brief	Loads this object.
+**************************************************************************************************/
+
+void StateBenchmark::Load( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateBenchmark::Init( void )
+ *
+ * \brief	Runs the benchmarks. The same seed every run, so every build is measured on the same
+ * 			objects and maps.
+**************************************************************************************************/
+
+void StateBenchmark::Init( void )
+{
+	if (!report.Open(NXBENCHMARK_FILE))
+	{
+		NX_MESG("StateBenchmark: Unable to create the report\n");
+		return;
+	}
+
+	srand(200);
+	BenchmarkCreate();
+	BenchmarkUpdate();
+	BenchmarkRender();
+	BenchmarkMaps();
+	BenchmarkInterpolants();
+	BenchmarkSnapshot();
+
+	report.Close();
+}
+
+/**************************************************************************************************
+ * \fn	void StateBenchmark::Update( void )
+ *
+ * \brief	Quits, the benchmarks are done by then.
+**************************************************************************************************/
+
+void StateBenchmark::Update( void )
+{
+	gStateManager.SetNextState(STATE_QUIT);
+}
+
+/**************************************************************************************************
+ * \fn	void StateBenchmark::Draw( void )
+ *
+ * \brief	Draws this object.
+**************************************************************************************************/
+
+void StateBenchmark::Draw( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateBenchmark::Unload( void )
+ *
+ * \brief	Unloads this object.
+**************************************************************************************************/
+
+void StateBenchmark::Unload( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateBenchmark::Free( void )
+ *
+ * \brief	Frees this object.
+**************************************************************************************************/
+
+void StateBenchmark::Free( void )
+{
+}
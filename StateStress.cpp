@@ -0,0 +1,583 @@
+/**************************************************************************************************
+* \file	    StateStress.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	State running a scripted scene under load and checking its frame times against a budget\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "StateStress.h"
+#include "StateManager.h"
+#include "GameObj.h"
+#include "GameObjManager.h"
+#include "NXTileMap.h"
+#include "NXRenderSnapshot.h"
+#include "NXRenderCommandList.h"
+#include "NXHeadless.h"
+#include "NXBenchmark.h"
+#include "NXProfiler.h"
+#include "NXPoolTelemetry.h"
+#include "NXAssert.h"
+#include "tinyxml.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <vector>
+
+StateStress gStateStress;
+
+static const char *NXSTRESS_CONFIG_FILE = "StressTest.xml";
+static const char *NXSTRESS_REPORT_FILE = "StressReport.csv";
+static const char *NXSTRESS_MAP_FILE = "StressMap.xml";
+static const char *NXSTRESS_POOLS_FILE = "StressPools.csv";
+#ifdef NX_PROFILE
+static const char *NXSTRESS_TRACE_FILE = "StressTrace.json";
+static const char *NXSTRESS_PROFILE_FILE = "StressProfile.csv";
+#endif
+
+static const wchar_t *NXSTRESS_MESH = L"SQUARETOP";
+static const wchar_t *NXSTRESS_ENEMY_SPRITE = L"PLAYER1_2";
+static const wchar_t *NXSTRESS_SPELL_SPRITE = L"SONIC";
+static const wchar_t *NXSTRESS_PROJECTILE_SPRITE = L"SONIC";
+
+enum STRESS_PHASE
+{
+	STRESS_SPAWN = 0,
+	STRESS_UPDATE,
+	STRESS_COLLISION,
+	STRESS_RENDER,
+
+	STRESS_PHASE_TOTAL
+};
+
+static const char *STRESS_PHASE_NAMES[STRESS_PHASE_TOTAL] = { "spawn", "update", "collision", "render" };
+
+enum STRESS_POOL
+{
+	STRESS_ENEMIES = 0,
+	STRESS_SPELLS,
+	STRESS_PROJECTILES,
+
+	STRESS_POOL_TOTAL
+};
+
+static const char *STRESS_POOL_NAMES[STRESS_POOL_TOTAL] = { "enemies", "spells", "projectiles" };
+
+//<StressTest Frames="" Seed="" MapSize="" .../> in NXSTRESS_CONFIG_FILE, missing attributes keep
+//these values. Budgets are in milliseconds, 0 to not check.
+struct StressConfig
+{
+	int frames;
+	int seed;
+	int mapSize;
+	int enemies;
+	int spellCapacity;
+	int spellsPerBurst;
+	int burstInterval;		//Frames between two bursts of spells
+	int projectileCapacity;
+	int projectilesPerFrame;
+	float spellLifetime;
+	float projectileLifetime;
+	float budgetP50;
+	float budgetP95;
+	float budgetP99;
+
+	StressConfig( void ) :
+		frames(1800),
+		seed(1),
+		mapSize(1024),
+		enemies(4000),
+		spellCapacity(2000),
+		spellsPerBurst(200),
+		burstInterval(30),
+		projectileCapacity(10000),
+		projectilesPerFrame(100),
+		spellLifetime(2.0f),
+		projectileLifetime(1.5f),
+		budgetP50(4.0f),
+		budgetP95(8.0f),
+		budgetP99(12.0f)
+	{
+	}
+};
+
+typedef ObjManager<GameObj> StressManager;
+
+static StressConfig config;
+static StressManager *pools[STRESS_POOL_TOTAL];
+static int frame = 0;
+
+//Collected over the scene
+static std::vector<double> frameTimes;
+static double phaseTimes[STRESS_PHASE_TOTAL];
+
+//Scratch kept between frames
+static std::vector<int> collisionFlags;
+static NXRenderSnapshot snapshot;
+static NXRenderCommandList commands;
+static NXNullRenderDevice device;
+
+/**************************************************************************************************
+ * \fn	static void LoadConfig( void )
+ *
+ * \brief	Reads the settings, keeping the defaults if the file or an attribute is missing.
+**************************************************************************************************/
+
+static void LoadConfig( void )
+{
+	config = StressConfig();
+
+	TiXmlDocument doc;
+	if (!doc.LoadFile(NXSTRESS_CONFIG_FILE))
+	{
+		return;
+	}
+	TiXmlElement *element = doc.FirstChildElement("StressTest");
+	if (element == 0)
+	{
+		return;
+	}
+
+	element->QueryIntAttribute("Frames", &config.frames);
+	element->QueryIntAttribute("Seed", &config.seed);
+	element->QueryIntAttribute("MapSize", &config.mapSize);
+	element->QueryIntAttribute("Enemies", &config.enemies);
+	element->QueryIntAttribute("SpellCapacity", &config.spellCapacity);
+	element->QueryIntAttribute("SpellsPerBurst", &config.spellsPerBurst);
+	element->QueryIntAttribute("BurstInterval", &config.burstInterval);
+	element->QueryIntAttribute("ProjectileCapacity", &config.projectileCapacity);
+	element->QueryIntAttribute("ProjectilesPerFrame", &config.projectilesPerFrame);
+	element->QueryFloatAttribute("SpellLifetime", &config.spellLifetime);
+	element->QueryFloatAttribute("ProjectileLifetime", &config.projectileLifetime);
+	element->QueryFloatAttribute("BudgetP50", &config.budgetP50);
+	element->QueryFloatAttribute("BudgetP95", &config.budgetP95);
+	element->QueryFloatAttribute("BudgetP99", &config.budgetP99);
+	doc.Clear();
+
+	// Counts and capacities become pool sizes, a negative one would wrap around
+	config.frames = std::max(config.frames, 0);
+	config.mapSize = std::max(config.mapSize, 4);
+	config.enemies = std::max(config.enemies, 0);
+	config.spellCapacity = std::max(config.spellCapacity, 0);
+	config.spellsPerBurst = std::max(config.spellsPerBurst, 0);
+	config.burstInterval = std::max(config.burstInterval, 1);
+	config.projectileCapacity = std::max(config.projectileCapacity, 0);
+	config.projectilesPerFrame = std::max(config.projectilesPerFrame, 0);
+}
+
+/**************************************************************************************************
+ * \fn	static float Random(float low, float high)
+ *
+ * \brief	A random number in [low, high], from the seeded rand.
+**************************************************************************************************/
+
+static float Random(float low, float high)
+{
+	return low + (high - low) * float(rand()) / RAND_MAX;
+}
+
+/**************************************************************************************************
+ * \fn	static GameObj* Spawn(STRESS_POOL pool, ObjType type, const wchar_t *sprite,
+ * 			const Vec3& pos, float lifetime)
+ *
+ * \brief	Creates an object moving in a random direction. A full pool counts the failure in its
+ * 			telemetry.
+ *
+ * \return	null if the pool is full, else the object.
+**************************************************************************************************/
+
+static GameObj* Spawn(STRESS_POOL pool, ObjType type, const wchar_t *sprite, const Vec3& pos, float lifetime)
+{
+	GameObj *obj = pools[pool]->CreateGameObj(NXSTRESS_MESH, sprite);
+	if (obj == 0)
+	{
+		return 0;
+	}
+
+	obj->mType = type;
+	obj->SetPosition(pos);
+	obj->SetScale(Vec3(1.0f, 1.0f, 1.0f));
+	obj->SetVelocity(Vec3(Random(-4.0f, 4.0f), Random(-4.0f, 4.0f), 0.0f));
+	if (lifetime > 0.0f)
+	{
+		obj->SetLifetime(lifetime);
+	}
+	return obj;
+}
+
+/**************************************************************************************************
+ * \fn	static Vec3 RandomFreePosition( void )
+ *
+ * \brief	A random position on the map that is not inside a wall.
+**************************************************************************************************/
+
+static Vec3 RandomFreePosition( void )
+{
+	const float extent = float(config.mapSize - 2);
+	int x = 0, y = 0;
+	if (!gCollisionTile.FindNearestFreeCell(Random(1.0f, extent), Random(1.0f, extent), 8.0f, &x, &y))
+	{
+		return Vec3(float(config.mapSize) * 0.5f, float(config.mapSize) * 0.5f, -1.0f);
+	}
+	return Vec3(x + 0.5f, y + 0.5f, -1.0f);
+}
+
+/**************************************************************************************************
+ * \fn	static const GameObj* RandomEnemy( void )
+ *
+ * \brief	An alive enemy picked at random, null if none are alive.
+**************************************************************************************************/
+
+static const GameObj* RandomEnemy( void )
+{
+	const std::vector<GameObj>& enemies = pools[STRESS_ENEMIES]->GetManagerList();
+	if (enemies.empty())
+	{
+		return 0;
+	}
+	for (int tries = 0; tries < 8; ++tries)
+	{
+		const GameObj& enemy = enemies[size_t(rand()) % enemies.size()];
+		if (enemy.IsAlive())
+		{
+			return &enemy;
+		}
+	}
+	return 0;
+}
+
+/**************************************************************************************************
+ * \fn	static void RunSpawn( void )
+ *
+ * \brief	The scripted part: enemies fire projectiles every frame and spells go off in bursts.
+**************************************************************************************************/
+
+static void RunSpawn( void )
+{
+	NX_PROFILE_ZONE("StateStress::Spawn");
+	for (int i = 0; i < config.projectilesPerFrame; ++i)
+	{
+		const GameObj *enemy = RandomEnemy();
+		if (enemy)
+		{
+			Spawn(STRESS_PROJECTILES, TYPE_PROJECTILE, NXSTRESS_PROJECTILE_SPRITE,
+				  enemy->GetPosition(), config.projectileLifetime);
+		}
+	}
+
+	if (frame % config.burstInterval == 0)
+	{
+		static const ObjType spells[] = { TYPE_FIRE, TYPE_ICE, TYPE_WIND };
+		const Vec3 center = RandomFreePosition();
+		for (int i = 0; i < config.spellsPerBurst; ++i)
+		{
+			const Vec3 pos(center.x + Random(-4.0f, 4.0f), center.y + Random(-4.0f, 4.0f), center.z);
+			Spawn(STRESS_SPELLS, spells[i % 3], NXSTRESS_SPELL_SPRITE, pos, config.spellLifetime);
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	static void RunCollision( void )
+ *
+ * \brief	Tile collision of every pool in one batch each, bouncing whatever hit a wall.
+**************************************************************************************************/
+
+static void RunCollision( void )
+{
+	NX_PROFILE_ZONE("StateStress::Collision");
+	for (int p = 0; p < STRESS_POOL_TOTAL; ++p)
+	{
+		pools[p]->CheckTileCollision(gCollisionTile, collisionFlags);
+		std::vector<GameObj>& objects = pools[p]->GetManagerList();
+		for (size_t i = 0; i < collisionFlags.size(); ++i)
+		{
+			if (collisionFlags[i])
+			{
+				objects[i].SetVelocity(objects[i].GetVelocity() * -1.0f);
+			}
+		}
+	}
+}
+
+/**************************************************************************************************
+ * \fn	static void RunRender( void )
+ *
+ * \brief	Everything the render thread would do for the frame, onto a device that draws
+ * 			nothing.
+**************************************************************************************************/
+
+static void RunRender( void )
+{
+	NX_PROFILE_ZONE("StateStress::Render");
+	snapshot.Clear();
+	for (int p = 0; p < STRESS_POOL_TOTAL; ++p)
+	{
+		pools[p]->Snapshot(snapshot);
+	}
+	commands.Clear();
+	snapshot.Record(commands);
+	commands.Sort(true);
+	device.Reset();
+	commands.Replay(device);
+}
+
+/**************************************************************************************************
+ * \fn	static bool WriteCheck(FILE *file, const char *name, double value, double budget)
+ *
+ * \brief	Writes a frame time against its budget.
+ *
+ * \return	false if the budget is exceeded.
+**************************************************************************************************/
+
+static bool WriteCheck(FILE *file, const char *name, double value, double budget)
+{
+	const bool isPassing = budget <= 0.0 || value <= budget;
+	if (file)
+	{
+		fprintf(file, "%s,%.3f,%.3f,%s\n", name, value, budget, isPassing ? "pass" : "fail");
+	}
+	return isPassing;
+}
+
+/**************************************************************************************************
+ * \fn	static bool WriteReport( void )
+ *
+ * \brief	Writes the frame time percentiles, the mean cost of each phase, the peak use of each
+ * 			pool and whether the budgets held.
+ *
+ * \return	false if a budget is exceeded.
+**************************************************************************************************/
+
+static bool WriteReport( void )
+{
+	FILE *file = fopen(NXSTRESS_REPORT_FILE, "w");
+	if (file == 0)
+	{
+		NX_MESG("StateStress: Unable to write the report\n");
+	}
+	else
+	{
+		fprintf(file, "metric,value,budget,result\n");
+	}
+
+	std::vector<double> times(frameTimes);
+	bool hasPassed = true;
+	hasPassed &= WriteCheck(file, "frame_p50_ms", NXPercentile(times, 50.0), config.budgetP50);
+	hasPassed &= WriteCheck(file, "frame_p95_ms", NXPercentile(times, 95.0), config.budgetP95);
+	hasPassed &= WriteCheck(file, "frame_p99_ms", NXPercentile(times, 99.0), config.budgetP99);
+
+	if (file)
+	{
+		fprintf(file, "frame_max_ms,%.3f,,\n", times.empty() ? 0.0 : times.back());
+		for (int p = 0; p < STRESS_PHASE_TOTAL; ++p)
+		{
+			fprintf(file, "%s_mean_ms,%.3f,,\n", STRESS_PHASE_NAMES[p],
+					frameTimes.empty() ? 0.0 : phaseTimes[p] / frameTimes.size());
+		}
+		for (int p = 0; p < STRESS_POOL_TOTAL; ++p)
+		{
+			fprintf(file, "%s_peak,%u,%u,\n", STRESS_POOL_NAMES[p], pools[p]->GetHighWater(),
+					unsigned(pools[p]->GetObjManagerSize()));
+			fprintf(file, "%s_failed_spawns,%u,,\n", STRESS_POOL_NAMES[p], pools[p]->GetTotalFailed());
+		}
+		fprintf(file, "result,%s,,\n", hasPassed ? "pass" : "fail");
+		fclose(file);
+	}
+
+	if (!hasPassed)
+	{
+		NX_MESG("StateStress: Frame time budget exceeded\n");
+	}
+	return hasPassed;
+}
+
+/**************************************************************************************************
+ * \fn	StateStress::StateStress()
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+StateStress::StateStress() :
+	isFinished(false),
+	hasPassed(false)
+{
+}
+
+/**************************************************************************************************
+ * \fn	StateStress::~StateStress()
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+StateStress::~StateStress()
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateStress::Load( void )
+ *
+ * \brief	Reads the settings and builds the map.
+**************************************************************************************************/
+
+void StateStress::Load( void )
+{
+	NX_PROFILE_ZONE("StateStress::Load");
+	LoadConfig();
+	srand(unsigned(config.seed));
+
+	std::string fileName(NXSTRESS_MAP_FILE);
+	if (NXWriteBenchmarkMap(NXSTRESS_MAP_FILE, config.mapSize, config.mapSize))
+	{
+		gCollisionTile.ImportMapDataFromFile(&fileName[0]);
+		remove(NXSTRESS_MAP_FILE);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void StateStress::Init( void )
+ *
+ * \brief	Creates the pools and the enemies.
+**************************************************************************************************/
+
+void StateStress::Init( void )
+{
+	NX_PROFILE_ZONE("StateStress::Init");
+	pools[STRESS_ENEMIES] = new StressManager(size_t(config.enemies), STRESS_POOL_NAMES[STRESS_ENEMIES]);
+	pools[STRESS_SPELLS] = new StressManager(size_t(config.spellCapacity), STRESS_POOL_NAMES[STRESS_SPELLS]);
+	pools[STRESS_PROJECTILES] = new StressManager(size_t(config.projectileCapacity), STRESS_POOL_NAMES[STRESS_PROJECTILES]);
+
+	frame = 0;
+	frameTimes.clear();
+	frameTimes.reserve(size_t(config.frames));
+	for (int p = 0; p < STRESS_PHASE_TOTAL; ++p)
+	{
+		phaseTimes[p] = 0.0;
+	}
+	isFinished = hasPassed = false;
+
+	static const ObjType enemies[] = { TYPE_MELEE_ENEMY_BASIC, TYPE_MELEE_ENEMY_ARMOR, TYPE_RANGE_ENEMY_BASIC };
+	for (int i = 0; i < config.enemies; ++i)
+	{
+		Spawn(STRESS_ENEMIES, enemies[i % 3], NXSTRESS_ENEMY_SPRITE, RandomFreePosition(), 0.0f);
+	}
+}
+
+/**************************************************************************************************
+ * \fn	void StateStress::Update( void )
+ *
+ * \brief	Runs and times one frame of the scene, or reports and quits after the last one.
+**************************************************************************************************/
+
+void StateStress::Update( void )
+{
+	if (isFinished)
+	{
+		return;
+	}
+	if (frame >= config.frames)
+	{
+		hasPassed = WriteReport();
+		if (FILE *file = fopen(NXSTRESS_POOLS_FILE, "w"))
+		{
+			NXDumpTelemetry(file);
+			fclose(file);
+		}
+#ifdef NX_PROFILE
+		NXProfileExportTrace(NXSTRESS_TRACE_FILE);
+		if (FILE *file = fopen(NXSTRESS_PROFILE_FILE, "w"))
+		{
+			NXProfileWriteSummary(file);
+			fclose(file);
+		}
+#endif
+		isFinished = true;
+		gStateManager.SetNextState(STATE_QUIT);
+		return;
+	}
+
+#ifdef NX_HEADLESS
+	gHeadlessClock.Tick();
+#endif
+	NX_PROFILE_MARK("Frame");
+
+	double phases[STRESS_PHASE_TOTAL];
+	NXStopwatch watch;
+	RunSpawn();
+	phases[STRESS_SPAWN] = watch.GetSeconds();
+
+	watch.Start();
+	for (int p = 0; p < STRESS_POOL_TOTAL; ++p)
+	{
+		pools[p]->Update();
+	}
+	phases[STRESS_UPDATE] = watch.GetSeconds();
+
+	watch.Start();
+	RunCollision();
+	phases[STRESS_COLLISION] = watch.GetSeconds();
+
+	watch.Start();
+	RunRender();
+	phases[STRESS_RENDER] = watch.GetSeconds();
+
+	double total = 0.0;
+	for (int p = 0; p < STRESS_PHASE_TOTAL; ++p)
+	{
+		phaseTimes[p] += phases[p] * 1000.0;
+		total += phases[p] * 1000.0;
+	}
+	frameTimes.push_back(total);
+
+	NXSampleTelemetry();
+	++frame;
+}
+
+/**************************************************************************************************
+ * \fn	void StateStress::Draw( void )
+ *
+ * \brief	Draws this object. The scene is drawn to a null device inside Update so it is timed
+ * 			with the rest of the frame.
+**************************************************************************************************/
+
+void StateStress::Draw( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateStress::Unload( void )
+ *
+ * \brief	Frees the map.
+**************************************************************************************************/
+
+void StateStress::Unload( void )
+{
+	gCollisionTile.FreeMapData();
+}
+
+/**************************************************************************************************
+ * \fn	void StateStress::Free( void )
+ *
+ * \brief	Frees the pools.
+**************************************************************************************************/
+
+void StateStress::Free( void )
+{
+	NX_PROFILE_ZONE("StateStress::Free");
+	for (int p = 0; p < STRESS_POOL_TOTAL; ++p)
+	{
+		delete pools[p];
+		pools[p] = 0;
+	}
+}
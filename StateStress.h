@@ -0,0 +1,51 @@
+/**************************************************************************************************
+* \file	    StateStress.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	State running a scripted scene under load and checking its frame times against a budget\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef STATESTRESS_H_
+#define STATESTRESS_H_
+
+#include "State.h"
+
+//Fills a large map with enemies, spells and projectiles and plays the same scripted scene every
+//run, one frame per Update. After the last frame it writes NXSTRESS_REPORT_FILE and quits.
+//Settings and budgets come from NXSTRESS_CONFIG_FILE, see StressConfig for the defaults.
+class StateStress : public State
+{
+	public:
+		StateStress( void );
+		~StateStress( void );
+
+		void Load( void );
+		void Init( void );
+		void Update( void );
+		void Draw( void );
+		void Unload( void );
+		void Free( void );
+
+		//Valid once the scene is over, for the caller to turn into an exit code
+		bool HasFinished( void ) const { return isFinished; }
+		bool HasPassed( void ) const { return hasPassed; }
+
+	private:
+		bool isFinished;
+		bool hasPassed;
+};
+
+extern StateStress gStateStress;
+
+#endif
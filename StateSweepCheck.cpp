@@ -0,0 +1,477 @@
+/**************************************************************************************************
+* \file	    StateSweepCheck.cpp
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	State checking the tile sweep against a brute force reference\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#include "StateSweepCheck.h"
+#include "StateManager.h"
+#include "NXTileMap.h"
+#include "NXBenchmark.h"
+#include "NXAssert.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+StateSweepCheck gStateSweepCheck;
+
+static const char *NXSWEEPCHECK_REPORT_FILE = "SweepReport.csv";
+static const char *NXSWEEPCHECK_MAP_FILE = "SweepMap.xml";
+
+static const int NXSWEEPCHECK_SEED = 1;
+static const int NXSWEEPCHECK_MAP_SIZE = 256;
+static const int NXSWEEPCHECK_FRAMES = 50;
+static const int NXSWEEPCHECK_CASES_PER_FRAME = 200;
+static const int NXSWEEPCHECK_MAX_MOVE = 20;			//Cells per axis in one step
+static const int NXSWEEPCHECK_SAMPLES_PER_CELL = 256;	//Reference steps per cell of movement
+static const int NXSWEEPCHECK_MAX_REPORTED = 20;		//Failures written out in full
+
+//The reference only counts a cell once the box is this far into it, and a contact reported by
+//the sweep may be this far from its cell. Both are well above the sweep's own epsilon.
+static const float NXSWEEPCHECK_DEPTH = 1.0f / 128.0f;
+static const float NXSWEEPCHECK_TIME_TOLERANCE = 1e-3f;
+
+enum SWEEP_LAYOUT
+{
+	SWEEP_ROW_MAJOR = 0,
+	SWEEP_BLOCK_8X8,
+
+	SWEEP_LAYOUT_TOTAL
+};
+
+static const char *SWEEP_LAYOUT_NAMES[SWEEP_LAYOUT_TOTAL] = { "row_major", "block_8x8" };
+static const NXBITGRID_LAYOUT SWEEP_LAYOUTS[SWEEP_LAYOUT_TOTAL] = { NXBITGRID_ROW_MAJOR, NXBITGRID_BLOCK_8X8 };
+
+struct SweepCase
+{
+	float posX;
+	float posY;
+	float scaleX;
+	float scaleY;
+	float moveX;
+	float moveY;
+};
+
+//Same map in each layout
+static NXTileMap maps[SWEEP_LAYOUT_TOTAL];
+static bool hasMaps = false;
+static int frame = 0;
+
+//Collected over the check
+static unsigned caseCount;
+static unsigned hitCounts[SWEEP_LAYOUT_TOTAL];
+static unsigned failureCounts[SWEEP_LAYOUT_TOTAL];
+static FILE *report = 0;
+
+/**************************************************************************************************
+ * \fn	static float Random(float low, float high)
+ *
+ * \brief	A random number in [low, high], from the seeded rand.
+**************************************************************************************************/
+
+static float Random(float low, float high)
+{
+	return low + (high - low) * float(rand()) / RAND_MAX;
+}
+
+/**************************************************************************************************
+ * \fn	static SweepCase RandomCase( void )
+ *
+ * \brief	A box and a movement. One case in four has whole cell boxes moving diagonally, so
+ * 			their corners pass exactly through grid corners, and one in eight moves along an axis.
+**************************************************************************************************/
+
+static SweepCase RandomCase( void )
+{
+	const float extent = float(NXSWEEPCHECK_MAP_SIZE - 4);
+	SweepCase c;
+
+	if (rand() % 4 == 0)
+	{
+		const int size = 1 + rand() % 3;
+		const float move = float(1 + rand() % (2 * NXSWEEPCHECK_MAX_MOVE)) * 0.5f;
+		c.scaleX = c.scaleY = float(size);
+		c.posX = float(4 + rand() % (NXSWEEPCHECK_MAP_SIZE - 8)) + size * 0.5f;
+		c.posY = float(4 + rand() % (NXSWEEPCHECK_MAP_SIZE - 8)) + size * 0.5f;
+		c.moveX = (rand() % 2) ? move : -move;
+		c.moveY = (rand() % 2) ? move : -move;
+		return c;
+	}
+
+	c.posX = Random(4.0f, extent);
+	c.posY = Random(4.0f, extent);
+	c.scaleX = Random(0.25f, 3.0f);
+	c.scaleY = Random(0.25f, 3.0f);
+	c.moveX = Random(-float(NXSWEEPCHECK_MAX_MOVE), float(NXSWEEPCHECK_MAX_MOVE));
+	c.moveY = Random(-float(NXSWEEPCHECK_MAX_MOVE), float(NXSWEEPCHECK_MAX_MOVE));
+	switch (rand() % 8)
+	{
+		case 0: c.moveX = 0.0f; break;
+		case 1: c.moveY = 0.0f; break;
+	}
+	return c;
+}
+
+/**************************************************************************************************
+ * \fn	static bool IsNewSolidCell(const NXTileMap& map, const SweepCase& c, int x, int y)
+ *
+ * \brief	Query if a cell is inside the map, solid and not under the box at the start. Cells
+ * 			the box starts on are left to the hotspot check, the sweep ignores them.
+**************************************************************************************************/
+
+static bool IsNewSolidCell(const NXTileMap& map, const SweepCase& c, int x, int y)
+{
+	if (x < 0 || y < 0 || x >= map.GetWidth() || y >= map.GetHeight() || map.GetCellValue(x, y) == 0)
+	{
+		return false;
+	}
+
+	const float halfX = c.scaleX / 2, halfY = c.scaleY / 2;
+	const bool isUnderX = x >= int(floorf(c.posX - halfX)) && x < int(ceilf(c.posX + halfX));
+	const bool isUnderY = y >= int(floorf(c.posY - halfY)) && y < int(ceilf(c.posY + halfY));
+	return !(isUnderX && isUnderY);
+}
+
+/**************************************************************************************************
+ * \fn	static bool BruteForceSweep(const NXTileMap& map, const SweepCase& c, float *Time)
+ *
+ * \brief	The reference: moves the box NXSWEEPCHECK_SAMPLES_PER_CELL times per cell of
+ * 			movement and tests every cell under it. A cell counts once the box is
+ * 			NXSWEEPCHECK_DEPTH into it, so the time found is at most one sample late.
+ *
+ * \return	true if the box enters a new solid cell.
+**************************************************************************************************/
+
+static bool BruteForceSweep(const NXTileMap& map, const SweepCase& c, float *Time)
+{
+	const float distance = fabsf(c.moveX) > fabsf(c.moveY) ? fabsf(c.moveX) : fabsf(c.moveY);
+	const int samples = int(ceilf(distance * NXSWEEPCHECK_SAMPLES_PER_CELL)) + 1;
+	const float halfX = c.scaleX / 2 - NXSWEEPCHECK_DEPTH, halfY = c.scaleY / 2 - NXSWEEPCHECK_DEPTH;
+
+	for (int i = 0; i <= samples; ++i)
+	{
+		const float t = float(i) / samples;
+		const float x = c.posX + c.moveX * t, y = c.posY + c.moveY * t;
+		const int x0 = int(floorf(x - halfX)), x1 = int(floorf(x + halfX));
+		const int y0 = int(floorf(y - halfY)), y1 = int(floorf(y + halfY));
+
+		for (int cy = y0; cy <= y1; ++cy)
+		{
+			for (int cx = x0; cx <= x1; ++cx)
+			{
+				if (IsNewSolidCell(map, c, cx, cy))
+				{
+					*Time = t;
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/**************************************************************************************************
+ * \fn	static bool IsContact(const SweepCase& c, const NXTileSweepHit& hit)
+ *
+ * \brief	Query if the box at the time of a hit touches the cell that was hit.
+**************************************************************************************************/
+
+static bool IsContact(const SweepCase& c, const NXTileSweepHit& hit)
+{
+	const float reach = NXSWEEPCHECK_DEPTH;
+	const float x = c.posX + c.moveX * hit.time, y = c.posY + c.moveY * hit.time;
+	const float halfX = c.scaleX / 2 + reach, halfY = c.scaleY / 2 + reach;
+
+	return hit.time >= 0.0f && hit.time <= 1.0f &&
+		   x - halfX < hit.cellX + 1 && x + halfX > hit.cellX &&
+		   y - halfY < hit.cellY + 1 && y + halfY > hit.cellY;
+}
+
+/**************************************************************************************************
+ * \fn	static void ReportFailure(int layout, const SweepCase& c, const char *reason,
+ * 			bool isSweepHit, const NXTileSweepHit& hit, bool isReferenceHit, float referenceTime)
+ *
+ * \brief	Counts a failure and writes the first few out in full, so they can be replayed.
+**************************************************************************************************/
+
+static void ReportFailure(int layout, const SweepCase& c, const char *reason,
+						  bool isSweepHit, const NXTileSweepHit& hit, bool isReferenceHit, float referenceTime)
+{
+	++failureCounts[layout];
+	if (report == 0 || failureCounts[layout] > unsigned(NXSWEEPCHECK_MAX_REPORTED))
+	{
+		return;
+	}
+
+	fprintf(report, "failure,%s,%s,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,", SWEEP_LAYOUT_NAMES[layout], reason,
+			c.posX, c.posY, c.scaleX, c.scaleY, c.moveX, c.moveY);
+	if (isSweepHit)
+	{
+		fprintf(report, "%.6f,%d,%d,", hit.time, hit.cellX, hit.cellY);
+	}
+	else
+	{
+		fprintf(report, "none,,,");
+	}
+	if (isReferenceHit)
+	{
+		fprintf(report, "%.6f\n", referenceTime);
+	}
+	else
+	{
+		fprintf(report, "none\n");
+	}
+}
+
+/**************************************************************************************************
+ * \fn	static void CheckCase(const SweepCase& c)
+ *
+ * \brief	Sweeps a box on every layout and fails it when it tunnels through a cell the
+ * 			reference enters, reports a contact later than the reference, reports a cell the box
+ * 			does not touch, or differs between layouts.
+**************************************************************************************************/
+
+static void CheckCase(const SweepCase& c)
+{
+	NXTileSweepHit hits[SWEEP_LAYOUT_TOTAL];
+	bool isHit[SWEEP_LAYOUT_TOTAL];
+
+	for (int l = 0; l < SWEEP_LAYOUT_TOTAL; ++l)
+	{
+		const NXTileMap& map = maps[l];
+		isHit[l] = map.SweepBinaryMapCollision(c.posX, c.posY, c.scaleX, c.scaleY, c.moveX, c.moveY, &hits[l]);
+
+		float referenceTime = 0.0f;
+		const bool isReferenceHit = BruteForceSweep(map, c, &referenceTime);
+
+		if (isHit[l])
+		{
+			++hitCounts[l];
+		}
+		if (isReferenceHit && !isHit[l])
+		{
+			ReportFailure(l, c, "tunneled", isHit[l], hits[l], isReferenceHit, referenceTime);
+		}
+		else if (isReferenceHit && hits[l].time > referenceTime + NXSWEEPCHECK_TIME_TOLERANCE)
+		{
+			ReportFailure(l, c, "late", isHit[l], hits[l], isReferenceHit, referenceTime);
+		}
+		else if (isHit[l] && (!IsNewSolidCell(map, c, hits[l].cellX, hits[l].cellY) || !IsContact(c, hits[l])))
+		{
+			ReportFailure(l, c, "no_contact", isHit[l], hits[l], isReferenceHit, referenceTime);
+		}
+	}
+
+	for (int l = 1; l < SWEEP_LAYOUT_TOTAL; ++l)
+	{
+		if (isHit[l] != isHit[0] || (isHit[l] && (hits[l].time != hits[0].time ||
+			hits[l].cellX != hits[0].cellX || hits[l].cellY != hits[0].cellY)))
+		{
+			ReportFailure(l, c, "layout_mismatch", isHit[l], hits[l], isHit[0], hits[0].time);
+		}
+	}
+	++caseCount;
+}
+
+/**************************************************************************************************
+ * \fn	static bool WriteSummary( void )
+ *
+ * \brief	Writes the counts of each layout and the result, then closes the report.
+ *
+ * \return	false if any case failed.
+**************************************************************************************************/
+
+static bool WriteSummary( void )
+{
+	bool hasPassed = caseCount > 0;
+	for (int l = 0; l < SWEEP_LAYOUT_TOTAL; ++l)
+	{
+		hasPassed &= failureCounts[l] == 0;
+		if (report)
+		{
+			fprintf(report, "layout,%s,%u,%u,%u\n", SWEEP_LAYOUT_NAMES[l], caseCount, hitCounts[l], failureCounts[l]);
+		}
+	}
+
+	if (report)
+	{
+		fprintf(report, "result,%s\n", hasPassed ? "pass" : "fail");
+		fclose(report);
+		report = 0;
+	}
+
+	if (!hasPassed)
+	{
+		NX_MESG("StateSweepCheck: The sweep disagrees with the brute force reference\n");
+	}
+	return hasPassed;
+}
+
+/**************************************************************************************************
+ * \fn	StateSweepCheck::StateSweepCheck()
+ *
+ * \brief	Default constructor.
+**************************************************************************************************/
+
+StateSweepCheck::StateSweepCheck() :
+	isFinished(false),
+	hasPassed(false)
+{
+}
+
+/**************************************************************************************************
+ * \fn	StateSweepCheck::~StateSweepCheck()
+ *
+ * \brief	Destructor.
+**************************************************************************************************/
+
+StateSweepCheck::~StateSweepCheck()
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateSweepCheck::Load( void )
+ *
+ * \brief	Builds the map in each layout. The right half is thinned out so that long movements
+ * 			also get through without a hit.
+**************************************************************************************************/
+
+void StateSweepCheck::Load( void )
+{
+	srand(unsigned(NXSWEEPCHECK_SEED));
+	hasMaps = NXWriteBenchmarkMap(NXSWEEPCHECK_MAP_FILE, NXSWEEPCHECK_MAP_SIZE, NXSWEEPCHECK_MAP_SIZE);
+	if (!hasMaps)
+	{
+		return;
+	}
+
+	std::string fileName(NXSWEEPCHECK_MAP_FILE);
+	for (int l = 0; l < SWEEP_LAYOUT_TOTAL; ++l)
+	{
+		maps[l].SetCollisionLayout(SWEEP_LAYOUTS[l]);
+		hasMaps &= maps[l].ImportMapDataFromFile(&fileName[0]) != 0;
+
+		srand(unsigned(NXSWEEPCHECK_SEED));
+		maps[l].BeginEdit();
+		for (int y = 1; y < NXSWEEPCHECK_MAP_SIZE - 1; ++y)
+		{
+			for (int x = NXSWEEPCHECK_MAP_SIZE / 2; x < NXSWEEPCHECK_MAP_SIZE - 1; ++x)
+			{
+				if (rand() % 8)
+				{
+					maps[l].SetCellValue(x, y, 0);
+				}
+			}
+		}
+		maps[l].EndEdit();
+	}
+	remove(NXSWEEPCHECK_MAP_FILE);
+}
+
+/**************************************************************************************************
+ * \fn	void StateSweepCheck::Init( void )
+ *
+ * \brief	Opens the report and resets the counts.
+**************************************************************************************************/
+
+void StateSweepCheck::Init( void )
+{
+	frame = 0;
+	caseCount = 0;
+	for (int l = 0; l < SWEEP_LAYOUT_TOTAL; ++l)
+	{
+		hitCounts[l] = failureCounts[l] = 0;
+	}
+	isFinished = hasPassed = false;
+
+	report = fopen(NXSWEEPCHECK_REPORT_FILE, "w");
+	if (report == 0)
+	{
+		NX_MESG("StateSweepCheck: Unable to write the report\n");
+	}
+	else
+	{
+		fprintf(report, "kind,layout,reason,pos_x,pos_y,scale_x,scale_y,move_x,move_y,hit_time,hit_x,hit_y,reference_time\n");
+	}
+	srand(unsigned(NXSWEEPCHECK_SEED));
+}
+
+/**************************************************************************************************
+ * \fn	void StateSweepCheck::Update( void )
+ *
+ * \brief	Checks one batch of cases, or reports and quits after the last one.
+**************************************************************************************************/
+
+void StateSweepCheck::Update( void )
+{
+	if (isFinished)
+	{
+		return;
+	}
+	if (!hasMaps || frame >= NXSWEEPCHECK_FRAMES)
+	{
+		hasPassed = WriteSummary();
+		isFinished = true;
+		gStateManager.SetNextState(STATE_QUIT);
+		return;
+	}
+
+	for (int i = 0; i < NXSWEEPCHECK_CASES_PER_FRAME; ++i)
+	{
+		CheckCase(RandomCase());
+	}
+	++frame;
+}
+
+/**************************************************************************************************
+ * \fn	void StateSweepCheck::Draw( void )
+ *
+ * \brief	Draws this object. Nothing is drawn.
+**************************************************************************************************/
+
+void StateSweepCheck::Draw( void )
+{
+}
+
+/**************************************************************************************************
+ * \fn	void StateSweepCheck::Unload( void )
+ *
+ * \brief	Frees the maps.
+**************************************************************************************************/
+
+void StateSweepCheck::Unload( void )
+{
+	for (int l = 0; l < SWEEP_LAYOUT_TOTAL; ++l)
+	{
+		maps[l].FreeMapData();
+	}
+	hasMaps = false;
+}
+
+/**************************************************************************************************
+ * \fn	void StateSweepCheck::Free( void )
+ *
+ * \brief	Closes the report if the check was left early.
+**************************************************************************************************/
+
+void StateSweepCheck::Free( void )
+{
+	if (report)
+	{
+		fclose(report);
+		report = 0;
+	}
+}
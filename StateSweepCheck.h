@@ -0,0 +1,52 @@
+/**************************************************************************************************
+* \file	    StateSweepCheck.h
+* \author	Lim Hao Jie Sherman, 250003311\n
+* 			Lim Yen Wei, 250002911\n
+* 			Scott Lim, 250005111\n
+* 			Peh Zhe Rong, 250004911\n
+*\par   	email:	haojie.lim\@digipen.edu\n
+* 		            yenwei.lim\@digipen.edu\n
+*        		    scott.lim\@digipen.edu\n
+* 		            peh.rong\@digipen.edu\n
+*\par       Course: GAM200
+*\par       Game Project BlastBasher
+*\date      10/08/2012
+* \brief	State checking the tile sweep against a brute force reference\n
+*			Copyright (C) 2012 DigiPen Institute of Technology. Reproduction
+* 			or disclosure of this file or its contents without the prior written consent of DigiPen
+* 			Institute of Technology is prohibited.
+**************************************************************************************************/
+#ifndef STATESWEEPCHECK_H_
+#define STATESWEEPCHECK_H_
+
+#include "State.h"
+
+//Compares NXTileMap::SweepBinaryMapCollision against a brute force reference that steps the box
+//a fraction of a cell at a time, on the same map in both collision layouts. Random boxes, boxes
+//passing exactly through grid corners and movements of up to NXSWEEPCHECK_MAX_MOVE cells per
+//step are checked, a batch per Update. It then writes NXSWEEPCHECK_REPORT_FILE and quits.
+class StateSweepCheck : public State
+{
+	public:
+		StateSweepCheck( void );
+		~StateSweepCheck( void );
+
+		void Load( void );
+		void Init( void );
+		void Update( void );
+		void Draw( void );
+		void Unload( void );
+		void Free( void );
+
+		//Valid once the check is over, for the caller to turn into an exit code
+		bool HasFinished( void ) const { return isFinished; }
+		bool HasPassed( void ) const { return hasPassed; }
+
+	private:
+		bool isFinished;
+		bool hasPassed;
+};
+
+extern StateSweepCheck gStateSweepCheck;
+
+#endif
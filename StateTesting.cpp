@@ -24,11 +24,24 @@
 #include "GameEditor.h"
 #include "NXAssert.h"
 #include "tinyxml.h"
+#include "NXRenderPipeline.h"
+#include "NXRenderStateCache.h"
+#include "NXHeadless.h"
+#include "NXProfiler.h"
+#include "NXPoolTelemetry.h"
+#include "NXPoolProfile.h"
+#include "NXObjSnapshot.h"
+#include <cstdio>
 #include <string>
 
 StateTest gStateTest;
 static EnemyObj* objEnemy = 0;
 static bool isCollided = false;
+static const char *POOL_PROFILE_LEVEL = "StateTest";
+static NXObjSnapshot quickSave;
+
+static void DrawFrame(const NXRenderSnapshot& snapshot);
+static bool IsDeviceMultithreaded( void );
 
 /**************************************************************************************************
  * \fn	StateTest::StateTest()
@@ -54,11 +67,14 @@ StateTest::~StateTest()
 /**************************************************************************************************
  * \fn	void StateTest::Load( void )
  *
- * \brief	Loads this object.
+ * \brief	Loads this object. The pools are sized from the high water marks of earlier sessions.
 **************************************************************************************************/
 
 void StateTest::Load( void )
 {	
+	NX_PROFILE_ZONE("StateTest::Load");
+	NXLoadPoolProfile(NXPOOL_PROFILE_FILE);
+	NXPresizePools(POOL_PROFILE_LEVEL);
 }
 
 /**************************************************************************************************
@@ -69,6 +85,7 @@ void StateTest::Load( void )
 
 void StateTest::Init( void )
 {
+	NX_PROFILE_ZONE("StateTest::Init");
 	Vec3 pos(0,0,-1);
 
 	Vec3 size2(4.0f,4.0f,1.0f);
@@ -91,6 +108,9 @@ void StateTest::Init( void )
 	NX_ASSERT(objEnemy);
 	
 	//gConsole.DebugInit();
+
+	// Without a multithreaded device the frames are drawn on this thread
+	gRenderPipeline.Start(DrawFrame, IsDeviceMultithreaded());
 }
 
 /**************************************************************************************************
@@ -101,11 +121,24 @@ void StateTest::Init( void )
 
 void StateTest::Update( void )
 {
+	// Hand the last tick to the render thread, it is drawn while this one is simulated
+	gRenderPipeline.EndFrame();
+
 	if (NXKeyIsReleased(NXVK_ESCAPE))
 		gStateManager.SetNextState(STATE_QUIT);
 
 	if (NXKeyIsTriggered(NXVK_F8))
 		gStateManager.SetNextState(STATE_SANDBOX);
+
+	// Quick save and quick restart, without running Init again
+	if (NXKeyIsTriggered(NXVK_F5))
+		quickSave.Capture(&gCollisionTile);
+	if (NXKeyIsTriggered(NXVK_F9) && quickSave.GetObjectCount() && quickSave.Restore(&gCollisionTile))
+	{
+		// The enemy's state machine and target are not in the records, set them up as Init does
+		objEnemy->FSMInit();
+		objEnemy->SetTarget(player);
+	}
 	/*
 	player->SetAABB(player->GetPosition(), player->GetScale());
 	objEnemy->SetAABB(objEnemy->GetPosition(), objEnemy->GetScale());
@@ -136,16 +169,72 @@ void StateTest::Update( void )
 	player->SetPosition(player->GetPosition() += player->GetVelocity() * g_dt);
 	*/
 	UpdateAllObjManagers();
+	NXSampleTelemetry();
+
+	// Snapshot this tick for the render thread
+	NXRenderSnapshot& frame = gRenderPipeline.BeginFrame();
+	SnapshotAllObjManagers(frame);
+
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "player pos: %.2f,%.2f,%.2f",player->GetPosition().x,player->GetPosition().y,player->GetPosition().z);	
+	frame.AddText(5,30,0xffffffff,buffer);
+
+	snprintf(buffer, sizeof(buffer), "enemy pos: %.2f,%.2f,%.2f",objEnemy->GetPosition().x,objEnemy->GetPosition().y,objEnemy->GetPosition().z);	
+	frame.AddText(5,32,0xffffffff,buffer);
+
+	snprintf(buffer, sizeof(buffer), "isCollided: %s",isCollided ? "true" : "false");
+	frame.AddText(5,40,0xffffffff,buffer);
 }
 
 /**************************************************************************************************
  * \fn	void StateTest::Draw( void )
  *
- * \brief	Draws this object.
+ * \brief	Draws this object. The frame is drawn by DrawFrame on the render thread, from the
+ * 			snapshot taken at the end of the previous Update. The engine presents after this
+ * 			returns, so the frame has to be finished first. The console reads simulation state
+ * 			and is drawn here, while the simulation and the render thread are both stopped.
 **************************************************************************************************/
 
 void StateTest::Draw( void )
 {
+	gRenderPipeline.WaitForFrame();
+
+#ifndef NX_HEADLESS
+	NXGraphicEngine* ge = gEngine.GetGraphicEngine();
+	if (ge == 0)
+	{
+		return;
+	}
+
+	// A scene of its own on the device, on top of the frame the render thread finished
+	ge->GetDevice()->BeginScene();
+	gConsole.DebugDraw();
+	ge->GetDevice()->EndScene();
+
+	// The console draws past the cache
+	NXGetGraphicStateCache().Invalidate();
+#endif
+}
+
+/**************************************************************************************************
+ * \fn	static void DrawFrame(const NXRenderSnapshot& snapshot)
+ *
+ * \brief	Draws a frame of this state from its snapshot, on the render thread.
+**************************************************************************************************/
+
+static void DrawFrame(const NXRenderSnapshot& snapshot)
+{
+	static NXRenderCommandList commands;
+	commands.Clear();
+	snapshot.Record(commands);
+
+	NXRenderStateCache& cache = NXGetGraphicStateCache();
+
+#ifdef NX_HEADLESS
+	cache.BeginFrame();
+	commands.Replay(cache);
+	snapshot.DrawText(NXGetHeadlessDevice());
+#else
 	NXGraphicEngine* ge = gEngine.GetGraphicEngine();
 	if (ge == 0)
 	{
@@ -154,31 +243,40 @@ void StateTest::Draw( void )
 
 	// Begin the scene
 	ge->BeginScene();
-	
-	char buffer[256];
-
 	ge->SetBackBufferColor(NXCOLOR_ARGB(255, 0, 0, 0 ));
+	cache.BeginFrame();
+	commands.Replay(cache);
+	NXGraphicDevice device(ge, g_Font);
+	snapshot.DrawText(device);
+	ge->EndScene();
+#endif
+}
 
-	sprintf_s(buffer,"player pos: %.2f,%.2f,%.2f",player->GetPosition().x,player->GetPosition().y,player->GetPosition().z);	
-	gEngine.GetGraphicEngine()->NXPrint(5,30,0xffffffff,buffer,g_Font);
-
-	sprintf_s(buffer,"enemy pos: %.2f,%.2f,%.2f",objEnemy->GetPosition().x,objEnemy->GetPosition().y,objEnemy->GetPosition().z);	
-	gEngine.GetGraphicEngine()->NXPrint(5,32,0xffffffff,buffer,g_Font);
+/**************************************************************************************************
+ * \fn	static bool IsDeviceMultithreaded( void )
+ *
+ * \brief	Tells whether the device was created with D3DCREATE_MULTITHREADED, which D3D9 needs
+ * 			before a second thread may draw while the main thread uses it.
+**************************************************************************************************/
 
-	if (isCollided)
+static bool IsDeviceMultithreaded( void )
+{
+#ifdef NX_HEADLESS
+	return true;
+#else
+	NXGraphicEngine* ge = gEngine.GetGraphicEngine();
+	D3DDEVICE_CREATION_PARAMETERS parameters;
+	if (ge == 0 || FAILED(ge->GetDevice()->GetCreationParameters(&parameters)))
 	{
-		sprintf_s(buffer,"isCollided: true");
-		gEngine.GetGraphicEngine()->NXPrint(5,40,0xffffffff,buffer,g_Font);
+		return false;
 	}
-	else
+	if ((parameters.BehaviorFlags & D3DCREATE_MULTITHREADED) == 0)
 	{
-		sprintf_s(buffer,"isCollided: false");
-		gEngine.GetGraphicEngine()->NXPrint(5,40,0xffffffff,buffer,g_Font);
+		NX_MESG("StateTest: Device is not multithreaded, drawing on the main thread\n");
+		return false;
 	}
-	gConsole.DebugDraw();
-	ge->EndScene();
-
-	RenderAllObjManagers();
+	return true;
+#endif
 }
 
 /**************************************************************************************************
@@ -199,6 +297,13 @@ void StateTest::Unload( void )
 
 void StateTest::Free( void )
 {
+	NX_PROFILE_ZONE("StateTest::Free");
+	gRenderPipeline.Stop();
 
+#ifdef NX_RECORD_POOLS
+	NXRecordPoolProfile(POOL_PROFILE_LEVEL);
+	NXSavePoolProfile(NXPOOL_PROFILE_FILE);
+#endif
 	FreeAllObjManagers();
+	quickSave.Clear();
 }
\ No newline at end of file